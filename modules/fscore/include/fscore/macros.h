@@ -14,7 +14,11 @@
 #define FS_NO_ALIAS    __declspec(noalias)
 
 // tells the compiler to never inline a particular function
+#ifdef WINDOWS
 #define FS_NO_INLINE    __declspec(noinline)
+#else
+#define FS_NO_INLINE    __attribute__((noinline))
+#endif
 
 // stringizes a string, even macros
 #define FS_PP_STRINGIZE_HELPER(token)    #token
@@ -8,5 +8,6 @@
 #include "fsgame/process/process_manager.h"
 #include "fsgame/process/process.h"
 #include "fsgame/process/delay_process.h"
+#include "fsgame/process/coroutine_process.h"
 
 #endif
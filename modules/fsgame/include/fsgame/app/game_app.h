@@ -4,6 +4,8 @@
 #include <SDL.h>
 
 #include "fscore.h"
+#include "fsmem.h"
+#include "fsutil/event_bus.h"
 #include "fsgame/app/system_interfaces.h"
 #include "fsgame/process/process_manager.h"
 
@@ -11,6 +13,8 @@ namespace fs
 {
     class IMemoryPolicy;
 
+    using GameEventBus = EventBus<DebugArena>;
+
 	class GameAppRunner : Uncopyable
 	{
 	public:
@@ -35,6 +39,9 @@ namespace fs
         virtual const Clock* getClock() const override;
 		virtual void exit() override;
 
+        // Events posted from any thread are delivered once per frame before the update.
+        GameEventBus* getEventBus();
+
 
 	protected:
 		virtual bool onInit() = 0;
@@ -61,6 +68,7 @@ namespace fs
 		SDL_Window* _pWindow;
         ProcessManager _processManager;
         Clock _clock;
+        GameEventBus* _pEventBus;
 	};
 }
 
@@ -0,0 +1,109 @@
+#ifndef FS_COROUTINE_PROCESS
+#define FS_COROUTINE_PROCESS
+
+#include "fscore.h"
+#include "fsutil/event.h"
+#include "fsutil/fiber.h"
+#include "fsgame/process/process.h"
+#include "fsgame/process/process_manager.h"
+
+namespace fs
+{
+    // A process written as straight line code instead of a state machine. run() executes
+    // on its own stack, borrowed from the manager, and can wait on time, events and other
+    // processes in the middle of the function:
+    //
+    //     void run() override
+    //     {
+    //         playAnimation("open");
+    //         waitFor(0.5f);
+    //         waitFor(pDoor->onOpened);
+    //         if(!waitFor(std::make_shared<MoveProcess>(pPlayer, target)))
+    //             fail();
+    //     }
+    //
+    // While waiting the process is suspended and not updated at all. Returning from run()
+    // succeeds the process unless it called fail(). When a waiting process is aborted, run()
+    // never resumes and the locals on its stack are not destroyed, so run() must not own
+    // resources across a wait. That includes strong pointers to processes: hand them to
+    // waitFor, which moves them to the manager, instead of keeping a copy.
+    class CoroutineProcess : public Process
+    {
+    public:
+        CoroutineProcess();
+        virtual ~CoroutineProcess();
+
+    protected:
+        virtual void run() = 0;
+
+        // Suspend until seconds of elapsed time have passed.
+        void waitFor(f32 seconds);
+
+        // Attach the process if needed and suspend until it and the children it hands off
+        // to are dead. Returns true if the whole chain succeeded. pProcess is moved to the
+        // manager before suspending, so pass a temporary or std::move the caller's pointer.
+        bool waitFor(StrongProcessPtr pProcess);
+
+        // Suspend until the event is signalled.
+        template<class Arena, typename... Params>
+        void waitFor(Event<Arena, void (Params...)>& event)
+        {
+            using EventType = Event<Arena, void (Params...)>;
+            using Wrapper = typename EventType::template NonConstWrapper<CoroutineProcess,
+                                                                        &CoroutineProcess::onEventSignal<Arena, Params...>>;
+
+            event.add(Wrapper(this));
+            _pWaitEvent = &event;
+            getManager()->waitForSignal(this, &CoroutineProcess::removeEventListener<Arena, Params...>);
+            yieldToManager();
+        }
+
+        // Suspend until the next update.
+        void waitForNextUpdate();
+
+        // Elapsed time passed to the update that last resumed run().
+        f32 getElapsedTime() const { return _elapsedTime; }
+
+        virtual void onInit() override;
+        virtual void onUpdate(f32 elapsedTime) override;
+
+    private:
+        static void coroutineMain(void* pUserData);
+        void yieldToManager();
+        void releaseStack();
+
+        template<class Arena, typename... Params>
+        void onEventSignal(Params...)
+        {
+            // Resuming and aborting both remove the listener, but never bring back a
+            // process that is no longer suspended.
+            if(getState() == SUSPENDED)
+            {
+                getManager()->resumeProcess(this);
+            }
+        }
+
+        template<class Arena, typename... Params>
+        static void removeEventListener(Process* pProcess)
+        {
+            using EventType = Event<Arena, void (Params...)>;
+            using Wrapper = typename EventType::template NonConstWrapper<CoroutineProcess,
+                                                                        &CoroutineProcess::onEventSignal<Arena, Params...>>;
+
+            CoroutineProcess* pCoroutine = static_cast<CoroutineProcess*>(pProcess);
+            static_cast<EventType*>(pCoroutine->_pWaitEvent)->remove(Wrapper(pCoroutine));
+            pCoroutine->_pWaitEvent = nullptr;
+        }
+
+        Fiber _fiber;
+        u32 _stackIndex;
+        bool _hasStack;
+        bool _isFinished;
+        f32 _elapsedTime;
+
+        // Event the process is listening to while it waits on one.
+        void* _pWaitEvent;
+    };
+}
+
+#endif
@@ -6,6 +6,8 @@
 
 namespace fs
 {
+    // Succeeds after timeToDelay seconds. The process sleeps in its manager's timer wheel
+    // instead of being updated every tick.
     class DelayProcess : public Process
     {
     public:
@@ -14,11 +16,11 @@ namespace fs
         ~DelayProcess();
 
     protected:
+        virtual void onInit() override;
         virtual void onUpdate(f32 elapsedTime) override;
 
     private:
         f32 _timeToDelay;
-        f32 _timeDelayed;
     };
 }
 
@@ -1,13 +1,19 @@
 #ifndef FS_PROCESS_H
 #define FS_PROCESS_H
 
+#include <memory>
+
 #include "fscore.h"
+#include "fsmem.h"
+#include "fsutil/timer_wheel.h"
 
 namespace fs
 {
     class Process;
+    class ProcessManager;
     typedef std::shared_ptr<Process> StrongProcessPtr;
     typedef std::weak_ptr<Process> WeakProcessPtr;
+    typedef List<StrongProcessPtr, DebugArena> ProcessList;
 
     class Process
     {
@@ -22,11 +28,15 @@ namespace fs
                      // to another process.
             RUNNING, // initialized and running
             PAUSED, // initialized but paused
+            SUSPENDED, // initialized but not updated until the manager resumes it
             SUCCEEDED, // completed sucessfully
             FAILED, // failed to complete
             ABORTED // may not have started
         };
 
+        // Stops whatever the process listens to from resuming it.
+        using RemoveListenerFunction = void (*)(Process* pProcess);
+
         Process();
         virtual ~Process();
 
@@ -49,7 +59,8 @@ namespace fs
         // doesn't release ownership of child
         StrongProcessPtr peekChild() { return _pChild; }
 
-
+        // The manager the process was attached to or nullptr.
+        ProcessManager* getManager() const { return _pManager; }
 
     protected:
         // interface, these functions should be overriden by the subclass as needed.
@@ -63,6 +74,22 @@ namespace fs
         State _state;
         StrongProcessPtr _pChild;
 
+        // Bookkeeping of the manager. _position is the node holding the process in
+        // either the running or the suspended list of the manager.
+        ProcessManager* _pManager;
+        ProcessList::iterator _position;
+        bool _isInSuspendedList;
+
+        // Process suspended until this one and its children are dead.
+        WeakProcessPtr _pWaiter;
+        // State of the end of the chain this process last waited on.
+        State _waitResult;
+
+        // Timer that resumes the process while it sleeps.
+        TimerHandle _wakeTimer;
+        // Removes the listener that resumes the process while it waits on a signal.
+        RemoveListenerFunction _pRemoveListener;
+
         void setState(State newState) { _state = newState; }
     };
 
@@ -83,7 +110,7 @@ namespace fs
 
     inline void Process::attachChild(StrongProcessPtr pChild)
     {
-        if(pChild)
+        if(_pChild)
             _pChild->attachChild(pChild);
         else
             _pChild = pChild;
@@ -2,29 +2,97 @@
 #define FS_PROCESS_MANAGER
 
 #include "fscore.h"
+#include "fsmem.h"
+#include "fsutil/fiber.h"
+#include "fsutil/timer_wheel.h"
 #include "fsgame/process/process.h"
 
+// Number of CoroutineProcesses a ProcessManager can run at the same time.
+#ifndef FS_PROCESS_MAX_COROUTINES
+#define FS_PROCESS_MAX_COROUTINES 64
+#endif
+
+#ifndef FS_PROCESS_COROUTINE_STACK_SIZE
+#define FS_PROCESS_COROUTINE_STACK_SIZE (32 * 1024)
+#endif
+
 namespace fs
 {
+   // Updates attached processes every tick. Suspended processes are moved out of the
+   // update list until they are resumed, so a process waiting on time, an event or
+   // another process costs nothing per tick. Sleeping processes and scheduled callbacks
+   // are kept in a TimerWheel advanced by the elapsed time of each update.
    class ProcessManager
    {
-       typedef List<StrongProcessPtr> ProcessList;
-
     public:
-       ProcessManager();
+       using TimerCallback = TimerWheel<DebugArena>::Callback;
+
+       ProcessManager(u32 maxCoroutines = FS_PROCESS_MAX_COROUTINES,
+                      size_t coroutineStackSize = FS_PROCESS_COROUTINE_STACK_SIZE);
        ~ProcessManager();
 
        u32 updateProcesses(f32 elapsedTime);
        WeakProcessPtr attachProcess(StrongProcessPtr pProcess);
        void abortAllProcesses(bool imediate);
 
-       u32 getProcessCount() const { return _processList.size(); }
+       // Stop updating an attached process until resumeProcess is called. A process may
+       // suspend itself from its update.
+       void suspendProcess(Process* pProcess);
+       // Resumed processes are updated by the next updateProcesses.
+       void resumeProcess(Process* pProcess);
+       // Suspend the process and resume it once seconds of elapsed time have passed.
+       void sleepProcess(Process* pProcess, f32 seconds);
+       // Suspend the process until a listener it registered calls resumeProcess.
+       // removeListener is called when the process is resumed or aborted, so an aborted
+       // process is never resumed by a late signal.
+       void waitForSignal(Process* pProcess, Process::RemoveListenerFunction removeListener);
+       // Attach pProcess if needed and suspend pWaiter until pProcess and the children it
+       // hands off to are dead. Returns false without suspending if pProcess is already dead.
+       bool waitForProcess(Process* pWaiter, StrongProcessPtr pProcess);
+       // State of the last process in the chain pWaiter waited on, once it was resumed.
+       Process::State getWaitResult(const Process* pWaiter) const { return pWaiter->_waitResult; }
+
+       // Call callback from the update in which delaySeconds of elapsed time have passed.
+       TimerHandle schedule(f32 delaySeconds, const TimerCallback& callback);
+
+       template<
+           typename F,
+           typename = typename std::enable_if<!std::is_same<TimerCallback, typename std::decay<F>::type>::value>::type
+       >
+       TimerHandle schedule(f32 delaySeconds, F&& func)
+       {
+           return _timers.schedule(delaySeconds, std::forward<F>(func));
+       }
+
+       // Returns false if the callback already ran or was cancelled.
+       bool cancelTimer(TimerHandle handle);
+
+       u32 getProcessCount() const { return _processList.size() + _suspendedList.size(); }
+       u32 getSuspendedProcessCount() const { return _suspendedList.size(); }
+       u32 getTimerCount() const { return _timers.getNumTimers(); }
 
     private:
+       friend class CoroutineProcess;
+
        ProcessList _processList;
+       ProcessList _suspendedList;
+       TimerWheel<DebugArena> _timers;
+
+       // Coroutine stacks and the context updateProcesses runs in while a coroutine runs.
+       // The stacks are reserved when the first coroutine starts.
+       FiberStackPool* _pCoroutineStacks;
+       Vector<u32, DebugArena> _freeCoroutineStacks;
+       Fiber _updateFiber;
+       u32 _maxCoroutines;
+       size_t _coroutineStackSize;
 
        void clearAllProcesses(); // should only be called by destructor
+       void resumeWaiter(Process* pProcess);
+       // Cancel the wake timer and remove the listener of a suspended process.
+       void cancelWait(Process* pProcess);
 
+       bool acquireCoroutineStack(FiberStack& stack, u32& index);
+       void releaseCoroutineStack(u32 index);
    };
 }
 
@@ -51,8 +51,9 @@ GameApp::GameApp() :
     _pBasePath(nullptr),
     _isRunning(false),
     _pWindow(nullptr),
-    _processManager(ProcessManager()),
-    _clock(0)
+    _processManager(),
+    _clock(0),
+    _pEventBus(nullptr)
 {
 	gpApp = this;
     GameContext::GameApp = this;
@@ -102,6 +103,8 @@ bool GameApp::initMemory()
 
     _pMemoryPolicy->init();
 
+    _pEventBus = FS_NEW(GameEventBus, memory::getDebugArena())(memory::getDebugArena());
+
     return true;
 }
 
@@ -186,6 +189,8 @@ void GameApp::run()
 			onEvent(&event);
 		}
 
+        _pEventBus->dispatch();
+
         while(accumulator >= dt)
         {
             f32 dtScaled = _clock.update(dt);
@@ -235,6 +240,11 @@ ProcessManager* GameApp::getProcessManager()
     return &_processManager;
 }
 
+GameEventBus* GameApp::getEventBus()
+{
+    return _pEventBus;
+}
+
 void GameApp::shutdown()
 {
     FS_INFO("GameApp::shutdown");
@@ -242,6 +252,9 @@ void GameApp::shutdown()
 
     _processManager.abortAllProcesses(true);
 
+    FS_DELETE(_pEventBus, memory::getDebugArena());
+    _pEventBus = nullptr;
+
     if(Memory::getTracker())
     {
         FS_INFO("Memory Report after onShutDown():");
@@ -0,0 +1,107 @@
+#include "fsgame/process/coroutine_process.h"
+
+using namespace fs;
+
+CoroutineProcess::CoroutineProcess() :
+    _stackIndex(0),
+    _hasStack(false),
+    _isFinished(false),
+    _elapsedTime(0),
+    _pWaitEvent(nullptr)
+{
+
+}
+
+CoroutineProcess::~CoroutineProcess()
+{
+    // Destroyed while waiting, e.g. by the manager's destructor.
+    if(getManager())
+    {
+        getManager()->cancelWait(this);
+    }
+
+    releaseStack();
+}
+
+void CoroutineProcess::onInit()
+{
+    Process::onInit();
+
+    FiberStack stack;
+    if(!getManager()->acquireCoroutineStack(stack, _stackIndex))
+    {
+        FS_ASSERT_MSG(false, "Out of coroutine stacks. Increase the ProcessManager's maxCoroutines.");
+        fail();
+        return;
+    }
+
+    _hasStack = true;
+    _fiber.init(stack, &CoroutineProcess::coroutineMain, this);
+}
+
+void CoroutineProcess::onUpdate(f32 elapsedTime)
+{
+    _elapsedTime = elapsedTime;
+    getManager()->_updateFiber.switchTo(_fiber);
+
+    if(_isFinished)
+    {
+        releaseStack();
+    }
+}
+
+void CoroutineProcess::waitFor(f32 seconds)
+{
+    getManager()->sleepProcess(this, seconds);
+    yieldToManager();
+}
+
+bool CoroutineProcess::waitFor(StrongProcessPtr pProcess)
+{
+    // A dead process is not updated again, so its children never run.
+    if(pProcess->isDead())
+    {
+        return pProcess->getState() == SUCCEEDED && !pProcess->peekChild();
+    }
+
+    // Only the manager owns the process while we wait. An aborted coroutine never returns
+    // here, so a strong pointer left on this stack would keep the process alive forever.
+    // The manager records the state of the end of the chain when it resumes us.
+    getManager()->waitForProcess(this, std::move(pProcess));
+    yieldToManager();
+    return getManager()->getWaitResult(this) == SUCCEEDED;
+}
+
+void CoroutineProcess::waitForNextUpdate()
+{
+    yieldToManager();
+}
+
+void CoroutineProcess::coroutineMain(void* pUserData)
+{
+    CoroutineProcess* pProcess = static_cast<CoroutineProcess*>(pUserData);
+    pProcess->run();
+
+    if(pProcess->getState() == RUNNING)
+    {
+        pProcess->succeed();
+    }
+    pProcess->_isFinished = true;
+    pProcess->yieldToManager();
+
+    FS_ASSERT_MSG(false, "A finished CoroutineProcess was resumed.");
+}
+
+void CoroutineProcess::yieldToManager()
+{
+    _fiber.switchTo(getManager()->_updateFiber);
+}
+
+void CoroutineProcess::releaseStack()
+{
+    if(_hasStack)
+    {
+        getManager()->releaseCoroutineStack(_stackIndex);
+        _hasStack = false;
+    }
+}
@@ -1,10 +1,10 @@
 #include "fsgame/process/delay_process.h"
+#include "fsgame/process/process_manager.h"
 
 using namespace fs;
 
 DelayProcess::DelayProcess(f32 timeToDelay) :
-    _timeToDelay(timeToDelay),
-    _timeDelayed(0)
+    _timeToDelay(timeToDelay)
 {
 
 }
@@ -14,12 +14,18 @@ DelayProcess::~DelayProcess()
 
 }
 
-void DelayProcess::onUpdate(f32 elapsedTime)
+void DelayProcess::onInit()
 {
-    _timeDelayed += elapsedTime;
-    if(_timeDelayed >= _timeToDelay)
+    Process::onInit();
+    if(_timeToDelay > 0)
     {
-        FS_INFO("DelayProcess succeed");
-        succeed();
+        getManager()->sleepProcess(this, _timeToDelay);
     }
 }
+
+void DelayProcess::onUpdate(f32)
+{
+    // Only updated once the delay is over.
+    FS_INFO("DelayProcess succeed");
+    succeed();
+}
@@ -4,7 +4,11 @@ using namespace fs;
 
 Process::Process() :
     _state(UNINITIALIZED),
-    _pChild(nullptr)
+    _pChild(nullptr),
+    _pManager(nullptr),
+    _isInSuspendedList(false),
+    _waitResult(UNINITIALIZED),
+    _pRemoveListener(nullptr)
 {
 
 }
@@ -32,7 +36,7 @@ StrongProcessPtr Process::removeChild()
 }
 
 bool Process::isAlive() const
-{ return _state == RUNNING || _state == PAUSED;}
+{ return _state == RUNNING || _state == PAUSED || _state == SUSPENDED; }
 
 bool Process::isDead() const
 { return _state == SUCCEEDED || _state == FAILED || _state == ABORTED; }
@@ -2,14 +2,27 @@
 
 using namespace fs;
 
-ProcessManager::ProcessManager()
+ProcessManager::ProcessManager(u32 maxCoroutines, size_t coroutineStackSize) :
+    _processList(StlAllocator<StrongProcessPtr, DebugArena>(memory::getDebugArena())),
+    _suspendedList(StlAllocator<StrongProcessPtr, DebugArena>(memory::getDebugArena())),
+    _timers(memory::getDebugArena()),
+    _pCoroutineStacks(nullptr),
+    _freeCoroutineStacks(StlAllocator<u32, DebugArena>(memory::getDebugArena())),
+    _maxCoroutines(maxCoroutines),
+    _coroutineStackSize(coroutineStackSize)
 {
 
 }
 
 ProcessManager::~ProcessManager()
 {
+    // Coroutines release their stacks when they are destroyed.
     clearAllProcesses();
+
+    if(_pCoroutineStacks)
+    {
+        FS_DELETE(_pCoroutineStacks, memory::getDebugArena());
+    }
 }
 
 u32 ProcessManager::updateProcesses(f32 elapsedTime)
@@ -17,6 +30,9 @@ u32 ProcessManager::updateProcesses(f32 elapsedTime)
     u16 successCount = 0;
     u16 failCount = 0;
 
+    // Woken processes are moved to the front of the list and updated below.
+    _timers.advance(elapsedTime);
+
     auto it = _processList.begin();
     while(it != _processList.end())
     {
@@ -30,7 +46,12 @@ u32 ProcessManager::updateProcesses(f32 elapsedTime)
         if(pCurrProcess->getState() == Process::RUNNING)
             pCurrProcess->onUpdate(elapsedTime);
 
-        if(pCurrProcess->isDead())
+        if(pCurrProcess->getState() == Process::SUSPENDED)
+        {
+            _suspendedList.splice(_suspendedList.end(), _processList, thisIt);
+            pCurrProcess->_isInSuspendedList = true;
+        }
+        else if(pCurrProcess->isDead())
         {
             switch(pCurrProcess->getState())
             {
@@ -39,7 +60,11 @@ u32 ProcessManager::updateProcesses(f32 elapsedTime)
                     pCurrProcess->onSuccess();
                     StrongProcessPtr pChild = pCurrProcess->removeChild();
                     if(pChild)
+                    {
+                        pChild->_pWaiter = pCurrProcess->_pWaiter;
+                        pCurrProcess->_pWaiter.reset();
                         attachProcess(pChild);
+                    }
                     else
                         // whole chain must complete for success
                         ++successCount;
@@ -63,6 +88,7 @@ u32 ProcessManager::updateProcesses(f32 elapsedTime)
                 default:break;
             }
 
+            resumeWaiter(pCurrProcess.get());
             _processList.erase(thisIt);
         }
     }
@@ -72,17 +98,154 @@ u32 ProcessManager::updateProcesses(f32 elapsedTime)
 
 WeakProcessPtr ProcessManager::attachProcess(StrongProcessPtr pProcess)
 {
+    FS_ASSERT_MSG(!pProcess->_pManager || pProcess->_pManager == this, "Process is attached to another ProcessManager.");
+
     _processList.push_front(pProcess);
+    pProcess->_pManager = this;
+    pProcess->_position = _processList.begin();
+    pProcess->_isInSuspendedList = false;
     return WeakProcessPtr(pProcess);
 }
 
+void ProcessManager::suspendProcess(Process* pProcess)
+{
+    FS_ASSERT(pProcess->_pManager == this);
+    FS_ASSERT(pProcess->getState() == Process::RUNNING || pProcess->getState() == Process::PAUSED);
+
+    // Moved to the suspended list by the next update so that the update loop never
+    // loses its place.
+    pProcess->setState(Process::SUSPENDED);
+}
+
+void ProcessManager::resumeProcess(Process* pProcess)
+{
+    FS_ASSERT(pProcess->_pManager == this);
+    FS_ASSERT(pProcess->getState() == Process::SUSPENDED);
+
+    pProcess->setState(Process::RUNNING);
+    cancelWait(pProcess);
+    if(pProcess->_isInSuspendedList)
+    {
+        _processList.splice(_processList.begin(), _suspendedList, pProcess->_position);
+        pProcess->_isInSuspendedList = false;
+    }
+}
+
+void ProcessManager::sleepProcess(Process* pProcess, f32 seconds)
+{
+    suspendProcess(pProcess);
+
+    // The timer is cancelled if the process is resumed or aborted before it fires, so the
+    // pointer is still valid when it does.
+    ProcessManager* pManager = this;
+    pProcess->_wakeTimer = _timers.schedule(seconds, [pManager, pProcess](){ pManager->resumeProcess(pProcess); });
+}
+
+void ProcessManager::waitForSignal(Process* pProcess, Process::RemoveListenerFunction removeListener)
+{
+    FS_ASSERT(removeListener && !pProcess->_pRemoveListener);
+
+    suspendProcess(pProcess);
+    pProcess->_pRemoveListener = removeListener;
+}
+
+bool ProcessManager::waitForProcess(Process* pWaiter, StrongProcessPtr pProcess)
+{
+    FS_ASSERT(pProcess && pProcess.get() != pWaiter);
+    FS_ASSERT_MSG(pProcess->_pWaiter.expired(), "A process can only be waited on by one process.");
+
+    if(pProcess->isDead())
+    {
+        return false;
+    }
+
+    if(!pProcess->_pManager)
+    {
+        attachProcess(pProcess);
+    }
+
+    suspendProcess(pWaiter);
+    pProcess->_pWaiter = *pWaiter->_position;
+    pWaiter->_waitResult = Process::UNINITIALIZED;
+    return true;
+}
+
+TimerHandle ProcessManager::schedule(f32 delaySeconds, const TimerCallback& callback)
+{
+    return _timers.schedule(delaySeconds, callback);
+}
+
+bool ProcessManager::cancelTimer(TimerHandle handle)
+{
+    return _timers.cancel(handle);
+}
+
+void ProcessManager::cancelWait(Process* pProcess)
+{
+    _timers.cancel(pProcess->_wakeTimer);
+    if(pProcess->_pRemoveListener)
+    {
+        Process::RemoveListenerFunction removeListener = pProcess->_pRemoveListener;
+        pProcess->_pRemoveListener = nullptr;
+        removeListener(pProcess);
+    }
+}
+
+void ProcessManager::resumeWaiter(Process* pProcess)
+{
+    StrongProcessPtr pWaiter = pProcess->_pWaiter.lock();
+    pProcess->_pWaiter.reset();
+    if(pWaiter && pWaiter->getState() == Process::SUSPENDED)
+    {
+        pWaiter->_waitResult = pProcess->getState();
+        resumeProcess(pWaiter.get());
+    }
+}
+
+bool ProcessManager::acquireCoroutineStack(FiberStack& stack, u32& index)
+{
+    // Most managers never run a coroutine, so don't reserve the stacks up front.
+    if(!_pCoroutineStacks && _maxCoroutines > 0)
+    {
+        _pCoroutineStacks = FS_NEW(FiberStackPool, memory::getDebugArena())(_maxCoroutines, _coroutineStackSize);
+        _freeCoroutineStacks.reserve(_maxCoroutines);
+        for(u32 i = _maxCoroutines; i > 0; --i)
+        {
+            _freeCoroutineStacks.push_back(i - 1);
+        }
+    }
+
+    if(_freeCoroutineStacks.empty())
+    {
+        return false;
+    }
+
+    index = _freeCoroutineStacks.back();
+    _freeCoroutineStacks.pop_back();
+    stack = _pCoroutineStacks->getStack(index);
+    return true;
+}
+
+void ProcessManager::releaseCoroutineStack(u32 index)
+{
+    _freeCoroutineStacks.push_back(index);
+}
+
 void ProcessManager::clearAllProcesses()
 {
     _processList.clear();
+    _suspendedList.clear();
 }
 
 void ProcessManager::abortAllProcesses(bool immediate)
 {
+    // Suspended processes are aborted like the others.
+    for(StrongProcessPtr& pProcess : _suspendedList)
+    {
+        pProcess->_isInSuspendedList = false;
+    }
+    _processList.splice(_processList.end(), _suspendedList);
+
     auto it = _processList.begin();
     while(it !=_processList.end())
     {
@@ -92,6 +255,7 @@ void ProcessManager::abortAllProcesses(bool immediate)
         StrongProcessPtr pProcess = *tempIt;
         if(pProcess->isAlive())
         {
+            cancelWait(pProcess.get());
             pProcess->setState(Process::ABORTED);
             if(immediate)
             {
@@ -0,0 +1,255 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+#include "fsgame/process/process_manager.h"
+#include "fsgame/process/coroutine_process.h"
+
+using namespace fs;
+
+using TestEvent = Event<DebugArena, void (int)>;
+
+struct CountingProcess : public Process
+{
+    CountingProcess(u32 numUpdates, bool succeeds) :
+        numUpdates(numUpdates),
+        succeeds(succeeds),
+        numUpdated(0),
+        numAborted(0)
+    {
+    }
+
+    virtual void onUpdate(f32) override
+    {
+        if(++numUpdated >= numUpdates)
+        {
+            succeeds ? succeed() : fail();
+        }
+    }
+
+    virtual void onAbort() override
+    {
+        ++numAborted;
+    }
+
+    u32 numUpdates;
+    bool succeeds;
+    u32 numUpdated;
+    u32 numAborted;
+};
+
+struct ScriptProcess : public CoroutineProcess
+{
+    ScriptProcess(TestEvent* pEvent) :
+        pEvent(pEvent),
+        stage(0),
+        succeeded(false),
+        failed(false)
+    {
+    }
+
+    virtual void run() override
+    {
+        stage = 1;
+        waitFor(0.5f);
+        stage = 2;
+        waitFor(*pEvent);
+        stage = 3;
+        succeeded = waitFor(std::make_shared<CountingProcess>(2, true));
+        stage = 4;
+        StrongProcessPtr pChain = std::make_shared<CountingProcess>(1, true);
+        pChain->attachChild(std::make_shared<CountingProcess>(1, false));
+        failed = !waitFor(std::move(pChain));
+        stage = 5;
+    }
+
+    TestEvent* pEvent;
+    u32 stage;
+    bool succeeded;
+    bool failed;
+};
+
+struct WaitingProcess : public CoroutineProcess
+{
+    WaitingProcess(WeakProcessPtr* ppWaited) :
+        ppWaited(ppWaited),
+        resumed(false)
+    {
+    }
+
+    virtual void run() override
+    {
+        StrongProcessPtr pWaited = std::make_shared<CountingProcess>(1000, true);
+        *ppWaited = pWaited;
+        waitFor(std::move(pWaited));
+        resumed = true;
+    }
+
+    WeakProcessPtr* ppWaited;
+    bool resumed;
+};
+
+BOOST_AUTO_TEST_SUITE(game)
+BOOST_AUTO_TEST_SUITE(process_manager)
+
+BOOST_AUTO_TEST_CASE(suspend_and_resume)
+{
+    ProcessManager manager;
+    auto pProcess = std::make_shared<CountingProcess>(100, true);
+    manager.attachProcess(pProcess);
+
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pProcess->numUpdated == 1);
+
+    manager.suspendProcess(pProcess.get());
+    manager.updateProcesses(0.1f);
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pProcess->numUpdated == 1);
+    BOOST_CHECK(manager.getSuspendedProcessCount() == 1);
+    BOOST_CHECK(manager.getProcessCount() == 1);
+
+    manager.resumeProcess(pProcess.get());
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pProcess->numUpdated == 2);
+    BOOST_CHECK(manager.getSuspendedProcessCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sleep_until_time_passed)
+{
+    ProcessManager manager;
+    auto pProcess = std::make_shared<CountingProcess>(100, true);
+    manager.attachProcess(pProcess);
+    manager.updateProcesses(0.1f);
+
+    manager.sleepProcess(pProcess.get(), 0.25f);
+    manager.updateProcesses(0.1f);
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pProcess->numUpdated == 1);
+    BOOST_CHECK(manager.getTimerCount() == 1);
+
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pProcess->numUpdated == 2);
+    BOOST_CHECK(manager.getTimerCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(abort_cancels_sleep)
+{
+    ProcessManager manager;
+    auto pProcess = std::make_shared<CountingProcess>(100, true);
+    manager.attachProcess(pProcess);
+    manager.updateProcesses(0.1f);
+    manager.sleepProcess(pProcess.get(), 1.0f);
+    manager.updateProcesses(0.1f);
+
+    manager.abortAllProcesses(false);
+    BOOST_CHECK(pProcess->getState() == Process::ABORTED);
+    BOOST_CHECK(manager.getTimerCount() == 0);
+
+    manager.updateProcesses(2.0f);
+    BOOST_CHECK(pProcess->numAborted == 1);
+    BOOST_CHECK(pProcess->numUpdated == 1);
+    BOOST_CHECK(manager.getProcessCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(wait_for_process)
+{
+    ProcessManager manager;
+    auto pWaiter = std::make_shared<CountingProcess>(100, true);
+    auto pFirst = std::make_shared<CountingProcess>(1, true);
+    pFirst->attachChild(std::make_shared<CountingProcess>(2, true));
+    manager.attachProcess(pWaiter);
+    manager.updateProcesses(0.1f);
+
+    BOOST_CHECK(manager.waitForProcess(pWaiter.get(), pFirst));
+    BOOST_CHECK(pFirst->getManager() == &manager);
+
+    // The first process hands off to its child, which runs for two updates.
+    manager.updateProcesses(0.1f);
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pWaiter->getState() == Process::SUSPENDED);
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pWaiter->getState() == Process::RUNNING);
+    BOOST_CHECK(manager.getWaitResult(pWaiter.get()) == Process::SUCCEEDED);
+    BOOST_CHECK(pWaiter->numUpdated == 1);
+
+    // Already dead.
+    BOOST_CHECK(!manager.waitForProcess(pWaiter.get(), pFirst));
+    BOOST_CHECK(pWaiter->getState() == Process::RUNNING);
+}
+
+BOOST_AUTO_TEST_CASE(coroutine_waits)
+{
+    TestEvent event(memory::getDebugArena());
+    ProcessManager manager(4, 16 * 1024);
+    auto pScript = std::make_shared<ScriptProcess>(&event);
+    manager.attachProcess(pScript);
+
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pScript->stage == 1);
+    BOOST_CHECK(manager.getSuspendedProcessCount() == 1);
+
+    for(u32 i = 0; i < 10; ++i)
+    {
+        manager.updateProcesses(0.1f);
+    }
+    BOOST_CHECK(pScript->stage == 2);
+
+    event.signal(1);
+    for(u32 i = 0; i < 10; ++i)
+    {
+        manager.updateProcesses(0.1f);
+    }
+    BOOST_CHECK(pScript->stage == 5);
+    BOOST_CHECK(pScript->succeeded);
+    BOOST_CHECK(pScript->failed);
+    BOOST_CHECK(pScript->getState() == Process::SUCCEEDED);
+    BOOST_CHECK(manager.getProcessCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(aborted_coroutine_ignores_event)
+{
+    TestEvent event(memory::getDebugArena());
+    ProcessManager manager(4, 16 * 1024);
+    auto pScript = std::make_shared<ScriptProcess>(&event);
+    manager.attachProcess(pScript);
+    for(u32 i = 0; i < 10; ++i)
+    {
+        manager.updateProcesses(0.1f);
+    }
+    BOOST_REQUIRE(pScript->stage == 2);
+
+    // Signalled after the abort but before the update that removes the process.
+    manager.abortAllProcesses(false);
+    event.signal(1);
+    BOOST_CHECK(pScript->getState() == Process::ABORTED);
+
+    manager.updateProcesses(0.1f);
+    BOOST_CHECK(pScript->stage == 2);
+    BOOST_CHECK(manager.getProcessCount() == 0);
+
+    pScript.reset();
+    event.signal(2);
+}
+
+BOOST_AUTO_TEST_CASE(aborted_coroutine_releases_waited_process)
+{
+    ProcessManager manager(4, 16 * 1024);
+    WeakProcessPtr pWaited;
+    auto pWaiter = std::make_shared<WaitingProcess>(&pWaited);
+    manager.attachProcess(pWaiter);
+    manager.updateProcesses(0.1f);
+    manager.updateProcesses(0.1f);
+    BOOST_REQUIRE(!pWaited.expired());
+    BOOST_CHECK(pWaiter->getState() == Process::SUSPENDED);
+
+    // run() never resumes, so nothing on its stack may keep the process alive.
+    manager.abortAllProcesses(true);
+    BOOST_CHECK(pWaited.expired());
+    BOOST_CHECK(!pWaiter->resumed);
+    BOOST_CHECK(manager.getProcessCount() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
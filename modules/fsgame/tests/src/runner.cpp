@@ -5,8 +5,6 @@
 #include "fscore.h"
 
 using namespace fs;
-Allocator* gpFsDebugHeap;
-Allocator* gpFsMainHeap;
 
 class GlobalFixture
 {
@@ -14,8 +12,6 @@ public:
     GlobalFixture()
     {
         fs::setIgnoreAsserts(true);
-        gpFsDebugHeap = nullptr;
-        gpFsMainHeap = nullptr;
     }
 
     ~GlobalFixture()
@@ -3,6 +3,7 @@
 
 #include "fsio/file/file_system.h"
 #include "fsio/file/osfile.h"
+#include "fsio/file/mapped_file.h"
 #include "fsio/file/disk_file.h"
 #include "fsio/file/disk_device.h"
 #include "fsio/file/gzip_file.h"
@@ -5,6 +5,7 @@
 #include "fsutil/flags.h"
 #include "fsmem/stl_types.h"
 #include "fsmem/adapter.h"
+#include "fsmem/intrusive_ptr.h"
 
 
 #define FS_FILESYS_INFOF(format, ...) FS_INFOF((DebugString("[File System] ") + DebugString(format)), __VA_ARGS__)
@@ -26,7 +27,9 @@ namespace fs
     class IArenaAdapter;
     class IFileSystem;
 
-    class IFile
+    // Files are shared through IntrusivePtr and are created by devices with makeIntrusive
+    // from the file system's arena.
+    class IFile : public RefCounted
     {
     public:
         virtual ~IFile() {}
@@ -53,7 +56,7 @@ namespace fs
         using Mode = Flags<internal::FileSystemModeFlags>;
 
         virtual const char* getType() const FS_ABSTRACT;
-        virtual SharedPtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) FS_ABSTRACT;
+        virtual IntrusivePtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) FS_ABSTRACT;
     };
 
     class IAsyncFile
@@ -72,8 +75,8 @@ namespace fs
 
         virtual void mount(IFileDevice* pDevice) FS_ABSTRACT;
         virtual void unmount(IFileDevice* pDevice) FS_ABSTRACT;
-        virtual SharedPtr<IFile> open(const char* deviceList, const char* path, Mode mode) FS_ABSTRACT;
-        virtual void close(SharedPtr<IFile> pFile) FS_ABSTRACT;
+        virtual IntrusivePtr<IFile> open(const char* deviceList, const char* path, Mode mode) FS_ABSTRACT;
+        virtual void close(IntrusivePtr<IFile> pFile) FS_ABSTRACT;
 
         virtual bool isMounted(IFileDevice* pDevice) const FS_ABSTRACT;
         virtual IArenaAdapter* getArenaAdapter() FS_ABSTRACT;
@@ -90,8 +93,8 @@ namespace fs
 
         virtual void mount(IFileDevice* pDevice);
         virtual void unmount(IFileDevice* pDevice);
-        virtual SharedPtr<IFile> open(const char* deviceList, const char* path, Mode mode);
-        virtual void close(SharedPtr<IFile> pFile);
+        virtual IntrusivePtr<IFile> open(const char* deviceList, const char* path, Mode mode);
+        virtual void close(IntrusivePtr<IFile> pFile);
 
         virtual bool isMounted(IFileDevice* pDevice) const override;
 
@@ -101,10 +104,14 @@ namespace fs
         Arena* _pArena;
         ArenaAdapter<Arena> _adapter;
 
-        using DeviceMap = Map<const char*, IFileDevice*, Arena, CompareCString>;
-        using DeviceMapPair = std::pair<const char*, IFileDevice*>;
+        // Keyed by the StringTable id of the device type.
+        using DeviceMap = Map<u32, IFileDevice*, Arena>;
+        using DeviceMapPair = std::pair<u32, IFileDevice*>;
         using DeviceMapAllocator = StlAllocator<DeviceMapPair, Arena>;
         DeviceMap _mountedDevices;
+
+        // Returns the end of the map unless a device of exactly this type is mounted.
+        typename DeviceMap::const_iterator findDevice(const char* type) const;
     };
 }
 
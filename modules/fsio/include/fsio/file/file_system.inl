@@ -3,7 +3,8 @@
 
 #include "fslog/logger.h"
 #include "fscore/assert.h"
-#include "fsmem/allocators/stack_allocator.h"
+#include "fsmem/scratch_arena.h"
+#include "fsmem/string_table.h"
 #include "fsmem/policies/extended_memory_tracking_policy.h"
 #include "fsio/file/file_system.h"
 
@@ -13,7 +14,7 @@ namespace fs
     FileSystem<Arena>::FileSystem(Arena* pArena) :
         _pArena(pArena),
         _adapter(pArena),
-        _mountedDevices(CompareCString(), DeviceMapAllocator(pArena))
+        _mountedDevices(std::less<u32>(), DeviceMapAllocator(pArena))
     {
         FS_ASSERT(pArena);
     }
@@ -33,7 +34,7 @@ namespace fs
             return;
         }
 
-        _mountedDevices.insert(std::make_pair(pDevice->getType(), pDevice));
+        _mountedDevices.insert(std::make_pair(memory::internString(pDevice->getType()), pDevice));
         FS_FILESYS_INFOF("Mounted device of type '%1%'.", pDevice->getType());
     }
 
@@ -41,32 +42,30 @@ namespace fs
     void FileSystem<Arena>::unmount(IFileDevice* pDevice)
     {
         FS_ASSERT(pDevice);
-        if(!isMounted(pDevice))
+        auto iter = findDevice(pDevice->getType());
+        if(iter == _mountedDevices.end())
         {
             FS_ERRORF("Cannot unmount a device of type '%1%' that was not previously mounted.", pDevice->getType());
             return;
         }
 
-        _mountedDevices.erase(pDevice->getType());
+        _mountedDevices.erase(iter);
         FS_FILESYS_INFOF("Unmounted device of type '%1%'.", pDevice->getType());
     }
 
     template <class Arena>
-    SharedPtr<IFile> FileSystem<Arena>::open(const char* deviceList, const char* path, Mode mode)
+    IntrusivePtr<IFile> FileSystem<Arena>::open(const char* deviceList, const char* path, Mode mode)
     {
-        using TempStringArena = MemoryArena<Allocator<StackAllocatorBottom, AllocationHeaderU32>,
-                                   SingleThread, SimpleBoundsChecking, FullMemoryTracking, MemoryTagging>;
-        StackArea<256> area;
-        TempStringArena arena(area, __FUNCTION__);
-        // small buffer optimization may result in no memory being allocated from the arena.
-
-        fs::string<TempStringArena> str(deviceList, &arena);
-        fs::string<TempStringArena> deviceType(&arena);
+        ScratchScope scratch;
+        fs::string<ScratchArena> str(deviceList, &scratch.getArena());
+        fs::string<ScratchArena> deviceType(&scratch.getArena());
         auto index = str.find(':');
         if(index != std::string::npos)
         {
-            deviceType = str.substr(0, index);
-            str = str.substr(index + 1);
+            // substr would need a default constructed allocator, which scratch strings
+            // do not have.
+            deviceType.assign(str, 0, index);
+            str.erase(0, index + 1);
         }
         else
         {
@@ -74,11 +73,11 @@ namespace fs
             str.clear();
         }
 
-        auto iter = _mountedDevices.find(deviceType.c_str());
+        auto iter = findDevice(deviceType.c_str());
         if(iter == _mountedDevices.end())
         {
             FS_ERRORF("Device of type '%1%' is not mounted", deviceType.c_str());
-            return SharedPtr<IFile>();
+            return IntrusivePtr<IFile>();
         }
 
         IFileDevice* pDevice = iter->second;
@@ -93,7 +92,7 @@ namespace fs
     }
 
     template <class Arena>
-    void FileSystem<Arena>::close(SharedPtr<IFile> pFile)
+    void FileSystem<Arena>::close(IntrusivePtr<IFile> pFile)
     {
         pFile->close();
     }
@@ -101,7 +100,19 @@ namespace fs
     template <class Arena>
     bool FileSystem<Arena>::isMounted(IFileDevice* pDevice) const
     {
-        return _mountedDevices.count(pDevice->getType()) > 0;
+        return findDevice(pDevice->getType()) != _mountedDevices.end();
+    }
+
+    template <class Arena>
+    typename FileSystem<Arena>::DeviceMap::const_iterator FileSystem<Arena>::findDevice(const char* type) const
+    {
+        // Devices are keyed by the hash of their type, which another type can share.
+        auto iter = _mountedDevices.find(HashedString::hashName(type));
+        if(iter != _mountedDevices.end() && std::strcmp(iter->second->getType(), type) != 0)
+        {
+            return _mountedDevices.end();
+        }
+        return iter;
     }
 }
 #endif
@@ -8,12 +8,16 @@ namespace fs
     class GzipDevice : public IFileDevice
     {
     public:
-        GzipDevice();
+        // Files opened by the device allocate their zlib state from pZlibArena, or from the
+        // arena of the file system when nullptr. A dedicated arena lets the state of files
+        // that are opened and closed repeatedly reuse the same memory.
+        explicit GzipDevice(IArenaAdapter* pZlibArena = nullptr);
         virtual ~GzipDevice();
 
         virtual const char* getType() const override { return "gzip"; }
-        virtual SharedPtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
+        virtual IntrusivePtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
     private:
+        IArenaAdapter* _pZlibArena;
     };
 }
 
@@ -9,10 +9,15 @@
 
 namespace fs
 {
+    class IArenaAdapter;
+
     class GzipFile : public IFile
     {
     public:
-        GzipFile(SharedPtr<IFile> pInputFile, IFileSystem* pFileSystem, IFileSystem::Mode mode);
+        // The zlib stream state is allocated from pZlibArena, or from the arena of the file
+        // system when nullptr.
+        GzipFile(IntrusivePtr<IFile> pInputFile, IFileSystem* pFileSystem, IFileSystem::Mode mode,
+                 IArenaAdapter* pZlibArena = nullptr);
         virtual ~GzipFile();
 
         virtual bool opened() const override;
@@ -31,8 +36,9 @@ namespace fs
 
     private:
         IFileSystem::Mode _mode;
-        SharedPtr<IFile> _pFile;
-        SharedPtr<IFile> _pTempBuffer;
+        IntrusivePtr<IFile> _pFile;
+        IArenaAdapter* _pZlibArena;
+        IntrusivePtr<IFile> _pTempBuffer;
         size_t _deflatedSize;
 
         bool _readInitialized;
@@ -0,0 +1,38 @@
+#ifndef FS_IO_MAPPED_FILE_H
+#define FS_IO_MAPPED_FILE_H
+
+#include "fscore/types.h"
+#include "fscore/platforms.h"
+
+namespace fs
+{
+    namespace internal
+    {
+        // Read only shared mapping of a whole file. Pages are loaded on first access and
+        // shared with every other process mapping the same file. Used to load arena
+        // images without copying them, see fs::ArenaImage.
+        template <u32 PlatformID>
+        class MappedFile : Uncopyable
+        {
+        public:
+            explicit MappedFile(const char* path);
+            ~MappedFile();
+
+            bool opened() const;
+            void close();
+            const char* getName() const;
+
+            const void* getData() const;
+            size_t getSize() const;
+
+        private:
+            const char* _path;
+            void* _data;
+            size_t _size;
+        };
+    }
+
+    using MappedFile = internal::MappedFile<PLATFORM_ID>;
+}
+
+#endif
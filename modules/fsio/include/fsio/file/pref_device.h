@@ -12,7 +12,7 @@ namespace fs
         virtual ~PrefDevice();
 
         virtual const char* getType() const override { return "pref"; }
-        virtual SharedPtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
+        virtual IntrusivePtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
     private:
         const char* _prefPath;
     };
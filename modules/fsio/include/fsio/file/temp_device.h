@@ -12,7 +12,7 @@ namespace fs
         virtual ~TempDevice();
 
         virtual const char* getType() const override { return "temp"; }
-        virtual SharedPtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
+        virtual IntrusivePtr<IFile> open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode) override;
     private:
     };
 }
@@ -14,10 +14,10 @@ DiskDevice::~DiskDevice()
 {
 }
 
-SharedPtr<IFile> DiskDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
+IntrusivePtr<IFile> DiskDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
 {
     FS_ASSERT_MSG_FORMATTED(!deviceList || std::strlen(deviceList) == 0,
             "DiskDevice is not a piggy back device. Invalid device list: '%1%'", deviceList);
 
-    return std::allocate_shared<DiskFile>(StlAllocator<DiskFile, IArenaAdapter>(pFileSystem->getArenaAdapter()), path, mode);
+    return makeIntrusive<DiskFile>(pFileSystem->getArenaAdapter(), path, mode);
 }
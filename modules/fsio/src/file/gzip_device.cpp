@@ -7,7 +7,8 @@
 
 using namespace fs;
 
-GzipDevice::GzipDevice()
+GzipDevice::GzipDevice(IArenaAdapter* pZlibArena) :
+    _pZlibArena(pZlibArena)
 {
 
 }
@@ -16,12 +17,12 @@ GzipDevice::~GzipDevice()
 {
 }
 
-SharedPtr<IFile> GzipDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
+IntrusivePtr<IFile> GzipDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
 {
     FS_ASSERT_MSG_FORMATTED(deviceList || std::strlen(deviceList) > 0,
             "GzipDevice is a piggy back device. Invalid device list: '%1%'", deviceList ? deviceList : "nullptr");
 
     auto inputFile = pFileSystem->open(deviceList, path, mode);
 
-    return std::allocate_shared<GzipFile>(StlAllocator<GzipFile, IArenaAdapter>(pFileSystem->getArenaAdapter()), inputFile, pFileSystem, mode);
+    return makeIntrusive<GzipFile>(pFileSystem->getArenaAdapter(), inputFile, pFileSystem, mode, _pZlibArena);
 }
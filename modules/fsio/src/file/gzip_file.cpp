@@ -15,13 +15,28 @@
 #endif
 
 #include "fsmem/new.h"
+#include "fsmem/adapter.h"
 #include "fscore/types.h"
 
+namespace
+{
+    voidpf zlibAllocate(voidpf opaque, uInt items, uInt size)
+    {
+        return static_cast<fs::IArenaAdapter*>(opaque)->allocate((size_t)items * size, 16, FS_SOURCE_INFO);
+    }
+
+    void zlibFree(voidpf opaque, voidpf address)
+    {
+        static_cast<fs::IArenaAdapter*>(opaque)->free(address);
+    }
+}
+
 namespace fs
 {
-    GzipFile::GzipFile(SharedPtr<IFile> pFile, IFileSystem* pFileSystem, IFileSystem::Mode mode) :
+    GzipFile::GzipFile(IntrusivePtr<IFile> pFile, IFileSystem* pFileSystem, IFileSystem::Mode mode, IArenaAdapter* pZlibArena) :
         _mode(mode),
         _pFile(pFile),
+        _pZlibArena(pZlibArena ? pZlibArena : pFileSystem->getArenaAdapter()),
         _readInitialized(false),
         _writeInitialized(false),
         _offset(0)
@@ -34,16 +49,17 @@ namespace fs
         _deflatedSize = pFile->tell();
         pFile->seek(0);
 
-        // TODO: replace with Arena
-        _readStream.zalloc = Z_NULL;
-        _readStream.zfree = Z_NULL;
-        _readStream.opaque = Z_NULL;
+        // The inflate and deflate state (up to ~256KB for deflate) is tracked by the arena
+        // instead of being allocated with malloc every time a file is opened.
+        _readStream.zalloc = &zlibAllocate;
+        _readStream.zfree = &zlibFree;
+        _readStream.opaque = _pZlibArena;
         _readStream.avail_in = 0;
         _readStream.next_in = Z_NULL;
 
-        _writeStream.zalloc = Z_NULL;
-        _writeStream.zfree = Z_NULL;
-        _writeStream.opaque = Z_NULL;
+        _writeStream.zalloc = &zlibAllocate;
+        _writeStream.zfree = &zlibFree;
+        _writeStream.opaque = _pZlibArena;
 
         auto ret = inflateInit2(&_readStream, 15 + 16); // + 16 for gzip, + 32 for automatic detection
         if(ret != Z_OK)
@@ -0,0 +1,103 @@
+#include "fsio/file/mapped_file.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "fscore/assert.h"
+#include "fslog/logger.h"
+#include "fscore/platforms.h"
+#include "fsio/file/file_system.h"
+
+using namespace fs;
+
+namespace fs
+{
+namespace internal
+{
+    template<>
+    void MappedFile<PLATFORM_ID>::close();
+
+    template<>
+    MappedFile<PLATFORM_ID>::MappedFile(const char* path) :
+        _path(path),
+        _data(nullptr),
+        _size(0)
+    {
+        FS_ASSERT(path);
+
+        int fd = open(path, O_RDONLY);
+        if(fd == -1)
+        {
+            FS_FILESYS_ERRORF("Failed to open file '%1%' for mapping. Error: %2%", path, strerror(errno));
+            return;
+        }
+
+        struct stat info;
+        if(fstat(fd, &info) != 0)
+        {
+            FS_FILESYS_ERRORF("Failed to get size of file '%1%'. Error: %2%", path, strerror(errno));
+        }
+        else if(info.st_size > 0)
+        {
+            void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if(data == MAP_FAILED)
+            {
+                FS_FILESYS_ERRORF("Failed to map file '%1%'. Error: %2%", path, strerror(errno));
+            }
+            else
+            {
+                _data = data;
+                _size = info.st_size;
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        ::close(fd);
+    }
+
+    template<>
+    MappedFile<PLATFORM_ID>::~MappedFile()
+    {
+        close();
+    }
+
+    template<>
+    bool MappedFile<PLATFORM_ID>::opened() const
+    {
+        return _data;
+    }
+
+    template<>
+    void MappedFile<PLATFORM_ID>::close()
+    {
+        if(_data && munmap(_data, _size) != 0)
+        {
+            FS_FILESYS_ERRORF("Failed to unmap file '%1%'. Error: %2%", _path, strerror(errno));
+        }
+        _data = nullptr;
+        _size = 0;
+    }
+
+    template<>
+    const char* MappedFile<PLATFORM_ID>::getName() const
+    {
+        return _path;
+    }
+
+    template<>
+    const void* MappedFile<PLATFORM_ID>::getData() const
+    {
+        return _data;
+    }
+
+    template<>
+    size_t MappedFile<PLATFORM_ID>::getSize() const
+    {
+        return _size;
+    }
+}
+}
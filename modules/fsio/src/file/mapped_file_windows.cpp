@@ -0,0 +1,3 @@
+#include "fsio/file/mapped_file.h"
+
+static_assert(false, "Windows implementation of mapped_file is not yet provided.");
@@ -14,7 +14,7 @@ PrefDevice::~PrefDevice()
 {
 }
 
-SharedPtr<IFile> PrefDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
+IntrusivePtr<IFile> PrefDevice::open(IFileSystem* pFileSystem, const char* deviceList, const char* path, Mode mode)
 {
     FS_ASSERT_MSG_FORMATTED(deviceList || std::strlen(deviceList) > 0,
             "PrefDevice is a piggy back device. Invalid device list: '%1%'", deviceList ? deviceList : "nullptr");
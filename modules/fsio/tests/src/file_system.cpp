@@ -77,7 +77,7 @@ BOOST_AUTO_TEST_CASE(pref_device_piggyback)
     filesys.mount(&pref);
 
     {
-        SharedPtr<IFile> file = filesys.open("pref:disk", "prefFile.bin", IFileSystem::Mode::READ | IFileSystem::Mode::WRITE | IFileSystem::Mode::CREATE);
+        IntrusivePtr<IFile> file = filesys.open("pref:disk", "prefFile.bin", IFileSystem::Mode::READ | IFileSystem::Mode::WRITE | IFileSystem::Mode::CREATE);
         BOOST_REQUIRE(file);
         BOOST_REQUIRE(file->opened());
     }
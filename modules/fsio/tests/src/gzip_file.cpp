@@ -151,6 +151,28 @@ BOOST_AUTO_TEST_CASE(open_and_read_to_null_buffer)
     BOOST_CHECK(size == 0);
 }
 
+BOOST_AUTO_TEST_CASE(zlib_state_allocated_from_arena)
+{
+    FileSystem<FileArena> filesys(&arena);
+    DiskDevice disk;
+
+    HeapArea zlibArea(FS_SIZE_OF_MB);
+    FileArena zlibArena(zlibArea, "ZlibArena");
+    ArenaAdapter<FileArena> zlibAdapter(&zlibArena);
+
+    {
+        GzipFile file(disk.open(&filesys, nullptr, gf->path("content/text.txt.gz"), IFileSystem::Mode::READ),
+                &filesys, IFileSystem::Mode::READ, &zlibAdapter);
+        BOOST_REQUIRE(file.opened());
+        BOOST_CHECK(zlibArena.getNumAllocations() > 0);
+
+        char buffer[64];
+        BOOST_CHECK(file.read(buffer, sizeof(buffer)) > 0);
+    }
+
+    BOOST_CHECK(zlibArena.getNumAllocations() == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <boost/test/unit_test.hpp>
+
+#include "global_fixture.h"
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsio.h"
+
+using namespace fs;
+
+struct MappedFileFixture
+{
+    MappedFileFixture() :
+        gf(GlobalFixture::instance())
+    {
+    }
+
+    ~MappedFileFixture()
+    {
+    }
+
+    GlobalFixture* gf;
+
+};
+
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_FIXTURE_TEST_SUITE(mapped_file, MappedFileFixture)
+
+BOOST_AUTO_TEST_CASE(map_file)
+{
+    MappedFile file(gf->path("content/small.bin"));
+
+    BOOST_REQUIRE(file.opened());
+    BOOST_CHECK(strcmp(file.getName(), gf->path("content/small.bin")) == 0);
+    BOOST_CHECK(file.getSize() == 1951);
+    BOOST_CHECK(static_cast<const char*>(file.getData())[0] == 'A');
+
+    file.close();
+    BOOST_CHECK(!file.opened());
+    BOOST_CHECK(file.getSize() == 0);
+
+    MappedFile empty(gf->path("content/empty.bin"));
+    BOOST_CHECK(!empty.opened());
+}
+
+BOOST_AUTO_TEST_CASE(map_arena_image)
+{
+    using ImageArena = MemoryArena<Allocator<LinearAllocator, NoAllocationHeader>,
+                                   SingleThread, NoBoundsChecking, NoMemoryTracking, NoMemoryTagging>;
+
+    struct Root
+    {
+        u32 value;
+        RelativePtr<u32> pValue;
+    };
+
+    {
+        HeapArea area(1024);
+        ImageArena arena(area);
+        Root* root = new(arena.allocate(sizeof(Root), 16, FS_SOURCE_INFO)) Root();
+        u32* pValue = new(arena.allocate(sizeof(u32), 4, FS_SOURCE_INFO)) u32(42);
+        root->value = 7;
+        root->pValue = pValue;
+        BOOST_REQUIRE(fs::memory::saveArenaImage(gf->path("image.bin"), arena, root));
+    }
+
+    MappedFile file(gf->path("image.bin"));
+    BOOST_REQUIRE(file.opened());
+
+    ArenaImage image;
+    BOOST_REQUIRE(image.open(file.getData(), file.getSize()));
+    const Root* root = image.getRoot<Root>();
+    BOOST_CHECK(root->value == 7);
+    BOOST_CHECK(*root->pValue == 42);
+
+    file.close();
+    std::remove(gf->path("image.bin"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,14 +13,23 @@
 
 #include "fsmem/allocators/stl_allocator.h"
 #include "fsmem/stl_types.h"
+#include "fsmem/adapter.h"
+#include "fsmem/debug/memory.h"
 
 namespace fs
 {
     class Logger : public ILogger
     {
     public:
-        using Tags = DebugMap<DebugString, u8>;
-        using TagAllocator = DebugMapAllocator<DebugString, u8>;
+        // Keyed by the StringTable id of the tag. The interned name is kept so that a tag
+        // sharing the id of a registered one is told apart without a table lookup.
+        struct Tag
+        {
+            const char* pName;
+            u8 flags;
+        };
+        using Tags = DebugMap<u32, Tag>;
+        using TagAllocator = DebugMapAllocator<u32, Tag>;
 
         enum DisplayFlags
         {
@@ -69,6 +78,10 @@ namespace fs
         clock::time_point _startTime;
         DebugString _outputBuffer;
         clock::time_point _lastFlushTime;
+
+        // Operator new is routed here while the config is parsed. It outlives the parse
+        // so that blocks freed by TinyXML are never cached against a dead adapter.
+        ArenaAdapter<DebugArena> _xmlArena;
     };
 
     namespace log
@@ -17,6 +17,9 @@
 #include "fsmem/new.h"
 #include "fsmem/debug/memory.h"
 #include "fsmem/allocators/stl_allocator.h"
+#include "fsmem/adapter.h"
+#include "fsmem/global_new.h"
+#include "fsmem/string_table.h"
 
 using namespace fs;
 
@@ -46,7 +49,8 @@ Logger::Logger(const char* configFilename, const char* name) :
     _consoleSurpressed(false),
     _tags(TagAllocator()),
     _startTime(clock::now()),
-    _lastFlushTime(clock::now())
+    _lastFlushTime(clock::now()),
+    _xmlArena(memory::getDebugArena())
 {
     // set up the default log tags
     setDisplayFlags("FATAL", DEFAULT_FLAG_FATAL);
@@ -59,6 +63,11 @@ Logger::Logger(const char* configFilename, const char* name) :
     if(configFilename)
     {
         FS_LOG_INTERNAL_INFO("Logger::init from config: %1%", configFilename);
+
+        // TinyXML allocates every node with new. Route it to the debug arena when the
+        // global operator new is replaced (see FS_IMPLEMENT_GLOBAL_NEW).
+        GlobalNewScope xmlScope(&_xmlArena);
+
         TiXmlDocument configFile(_configFileName);
         if(configFile.LoadFile())
         {
@@ -135,12 +144,13 @@ void Logger::log(const DebugString& tag, const DebugString& message, const char*
 void Logger::logWithoutLock(const DebugString& tag, const DebugString& message, const char* funcName,
                 const char* sourceFile, u32 lineNum)
 {
-    auto findIt = _tags.find(tag);
-    if(findIt != _tags.end())
+    // An unregistered tag can share the hash of a registered one.
+    auto findIt = _tags.find(HashedString::hashName(tag.c_str()));
+    if(findIt != _tags.end() && std::strcmp(findIt->second.pName, tag.c_str()) == 0)
     {
         DebugString buffer;
-        getOutputBuffer(buffer, tag, findIt->second, message, funcName, sourceFile, lineNum);
-        outputFinalBufferToLogs(buffer, findIt->second);
+        getOutputBuffer(buffer, tag, findIt->second.flags, message, funcName, sourceFile, lineNum);
+        outputFinalBufferToLogs(buffer, findIt->second.flags);
     }
 
     if(_pParent)
@@ -149,22 +159,24 @@ void Logger::logWithoutLock(const DebugString& tag, const DebugString& message,
 
 void Logger::setDisplayFlags(const DebugString& tag, u32 flags)
 {
+    const u32 id = memory::internString(tag.c_str());
+    const char* pName = memory::getInternedString(id);
     std::lock_guard<std::mutex> lock(_mutex);
     if(flags != 0)
     {
-        auto findIt = _tags.find(tag);
+        auto findIt = _tags.find(id);
         if(findIt == _tags.end())
         {
-            _tags.insert(std::make_pair(tag, flags));
+            _tags.insert(std::make_pair(id, Tag{pName, (u8)flags}));
         }
         else
         {
-            findIt->second = flags;
+            findIt->second.flags = (u8)flags;
         }
     }
     else
     {
-        _tags.erase(tag);
+        _tags.erase(id);
     }
 }
 
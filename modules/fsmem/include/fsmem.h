@@ -4,8 +4,16 @@
 // Memory
 #include "fsmem/utils.h"
 #include "fsmem/new.h"
+#include "fsmem/global_new.h"
 #include "fsmem/memory_arena.h"
 #include "fsmem/memory_area.h"
+#include "fsmem/memory_budget.h"
+#include "fsmem/sub_arena.h"
+#include "fsmem/scratch_arena.h"
+#include "fsmem/relative_ptr.h"
+#include "fsmem/arena_unique_ptr.h"
+#include "fsmem/intrusive_ptr.h"
+#include "fsmem/arena_image.h"
 #include "fsmem/source_info.h"
 #include "fsmem/allocation_info.h"
 #include "fsmem/adapter.h"
@@ -17,15 +25,25 @@
 #include "fsmem/allocators/pool_allocator.h"
 #include "fsmem/allocators/heap_allocator.h"
 #include "fsmem/allocators/malloc_allocator.h"
+#include "fsmem/allocators/guard_page_allocator.h"
 #include "fsmem/allocators/stl_allocator.h"
 
+// Containers
+#include "fsmem/containers/small_vector.h"
+#include "fsmem/containers/flat_map.h"
+#include "fsmem/containers/hash_map.h"
+#include "fsmem/containers/handle_pool.h"
+
 // Memory Policies
 #include "fsmem/policies/allocation_policy.h"
 #include "fsmem/policies/bounds_checking_policy.h"
 #include "fsmem/policies/memory_tagging_policy.h"
 #include "fsmem/policies/memory_tracking_policy.h"
 #include "fsmem/policies/extended_memory_tracking_policy.h"
+#include "fsmem/policies/trace_memory_tracking_policy.h"
 #include "fsmem/policies/thread_policy.h"
+#include "fsmem/policies/quarantine_policy.h"
+#include "fsmem/policies/memory_budget_policy.h"
 
 // SDL
 #include "fsmem/sdl/malloc_hook.h"
@@ -36,9 +54,11 @@
 #include "fsmem/debug/memory_logging.h"
 #include "fsmem/debug/memory_reporting.h"
 #include "fsmem/debug/utils.h"
+#include "fsmem/debug/allocation_trace.h"
 
 // STL
 #include "fsmem/stl_types.h"
+#include "fsmem/string_table.h"
 
 #endif
 
@@ -0,0 +1,60 @@
+#ifndef FS_GUARD_PAGE_ALLOCATOR_H
+#define FS_GUARD_PAGE_ALLOCATOR_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    // Debug allocator that gives every allocation its own reservation of virtual address
+    // space and places the end of the allocation against a PROT_NONE guard page. Writing
+    // past the end of a block faults immediately, so an arena using it can run with
+    // NoBoundsChecking instead of checking canaries on every free. The whole reservation
+    // is released on free so using a dangling pointer also faults until the address
+    // range is reused.
+    //
+    // Each allocation costs at least two pages of address space and one page of physical
+    // memory. The end of the block is aligned down to the requested alignment so an
+    // overrun smaller than the alignment may not reach the guard page.
+    class GuardPageAllocator : Uncopyable
+    {
+    public:
+        GuardPageAllocator();
+
+        // The area is not used. Every allocation reserves its own pages.
+        GuardPageAllocator(void* start, void* end);
+
+        ~GuardPageAllocator();
+
+        void* allocate(size_t size, size_t alignment, size_t offset);
+        void free(void* ptr);
+
+        // Release every allocation.
+        void reset();
+
+        inline void purge() {}
+        inline size_t getTotalUsedSize() const { return _physicalSize; }
+        inline size_t getVirtualSize() const { return _virtualSize; }
+        inline size_t getPhysicalSize() const { return _physicalSize; }
+
+    private:
+        // Stored immediately before each allocation.
+        struct Block
+        {
+            Block* prev;
+            Block* next;
+            void* reservation;
+            size_t reservedSize;
+        };
+
+        static Block* getBlock(uptr userPtr);
+        void release(Block* block);
+
+        Block* _blocks;
+        size_t _pageSize;
+        size_t _virtualSize;
+        size_t _physicalSize;
+    };
+}
+
+#endif
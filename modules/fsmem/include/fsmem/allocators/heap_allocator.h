@@ -6,13 +6,21 @@
 #include "fscore/types.h"
 #include "fscore/assert.h"
 #include "fsmem/malloc.h"
+#include "fsmem/source_info.h"
 #include "fsmem/allocators/page_allocator.h"
+#include "fsmem/containers/handle_pool.h"
 
 namespace fs
 {
     class HeapAllocator
     {
+        struct MovableBlock;
+
     public:
+        // Refers to a movable allocation. Resolve it to a pointer with getMovable each
+        // time the memory is used; the pointer is only valid until the next compact.
+        using MovableHandle = Handle<MovableBlock>;
+
         template<typename BackingAllocator = PageAllocator>
         explicit HeapAllocator(size_t size);
 
@@ -28,18 +36,69 @@ namespace fs
         inline size_t getVirtualSize() const { return (uptr)_end - (uptr)_start; }
         inline size_t getPhysicalSize() const { return (uptr)_end - (uptr)_start; }
 
+        // Movable allocations are opt-in. Enabling them allocates a relocation table for
+        // maxMovable allocations from the heap. compact then moves unpinned movable
+        // allocations into free space lower in the heap so the holes left by long lived
+        // allocations coalesce into blocks large enough for big requests. Movable
+        // allocations have no header and do not go through the arena's policies.
+        void enableMovableAllocations(u32 maxMovable);
+        inline bool hasMovableAllocations() const { return _pMovable != nullptr; }
+
+        // Returns a null handle when the heap or the relocation table is full. Compact
+        // and try again to recover from fragmentation.
+        MovableHandle allocateMovable(size_t size, size_t alignment);
+        void freeMovable(MovableHandle handle);
+
+        // Returns nullptr for a stale handle.
+        void* getMovable(MovableHandle handle) const;
+
+        // Pinned allocations are not moved by compact. Pins nest.
+        void pinMovable(MovableHandle handle);
+        void unpinMovable(MovableHandle handle);
+
+        // Moves movable allocations until at least maxBytes have been moved or every
+        // allocation was considered once. Successive calls continue where the last one
+        // stopped so the cost can be spread across frames. Returns the bytes moved.
+        size_t compact(size_t maxBytes);
+
+        u32 getNumMovableAllocations() const;
+
     private:
+        struct MovableBlock
+        {
+            void* ptr;
+            size_t size;
+            size_t alignment;
+            u32 pinCount;
+        };
+
+        // Lets the relocation table allocate its arrays from the heap.
+        struct MspaceArena
+        {
+            void* allocate(size_t size, size_t alignment, const SourceInfo&);
+            void free(void* ptr);
+
+            mspace space;
+        };
+
+        using MovablePool = HandlePool<MovableBlock, MspaceArena>;
+
         void* _start;
         void* _end;
         std::function<void()> _deleter;
         mspace _mspace;
+        MspaceArena _tableArena;
+        MovablePool* _pMovable;
+        u32 _compactCursor;
 
         void createHeap();
     };
 
     // Templated constructor implementation
     template<typename BackingAllocator>
-    HeapAllocator::HeapAllocator(size_t size)
+    HeapAllocator::HeapAllocator(size_t size) :
+        _pMovable(nullptr),
+        _compactCursor(0)
     {
         FS_ASSERT(size > 0);
 
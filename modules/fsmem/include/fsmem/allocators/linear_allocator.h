@@ -29,6 +29,9 @@ namespace fs
         }
 
         inline void reset() { _current = _start; }
+
+        // Start of the used memory which is getTotalUsedSize() bytes long.
+        inline const void* getStart() const { return (const void*)_start; }
         inline size_t getTotalUsedSize() const { return _current - _start; }
         inline size_t getVirtualSize() const {  return _end - _start; }
         inline size_t getPhysicalSize() const { return _end - _start; }
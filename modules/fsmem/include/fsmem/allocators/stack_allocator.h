@@ -22,6 +22,14 @@ namespace fs
         friend AllocateFromStackBottom;
         friend AllocateFromStackTop;
 
+        // Position of the stack that can be returned to with freeToMarker.
+        class Marker
+        {
+        public:
+            uptr current;
+            uptr lastUserPtr;
+        };
+
         // Constructor for Growable stacks only.
         StackAllocator(size_t initialSize, size_t maxSize);
 
@@ -37,12 +45,19 @@ namespace fs
         void free(void* ptr);
         inline void reset(size_t initialSize = 0);
 
+        // Free every allocation made after the marker was taken at once.
+        inline Marker getMarker() const;
+        inline void freeToMarker(const Marker& marker);
+
         // Free physical memory that is no longer in use.
         // The address space will still be reserved.
         // Does nothing for NonGrowbable Policy.
         void purge();
 
         inline size_t getTotalUsedSize() const { return _layoutPolicy.getTotalUsedSize(this); };
+
+        // Lowest address of the used memory which is getTotalUsedSize() bytes long.
+        inline const void* getStart() const { return (const void*)(_virtualStart < _physicalCurrent ? _virtualStart : _physicalCurrent); }
         inline size_t getVirtualSize() const { return _layoutPolicy.getVirtualSize(this); }
         inline size_t getPhysicalSize() const { return _layoutPolicy.getPhysicalSize(this); }
 
@@ -126,6 +126,22 @@ namespace fs
         _layoutPolicy.reset(this, initialSize);
     }
 
+    template<typename LayoutPolicy, typename GrowthPolicy>
+    typename StackAllocator<LayoutPolicy, GrowthPolicy>::Marker StackAllocator<LayoutPolicy, GrowthPolicy>::getMarker() const
+    {
+        Marker marker;
+        marker.current = _physicalCurrent;
+        marker.lastUserPtr = _lastUserPtr;
+        return marker;
+    }
+
+    template<typename LayoutPolicy, typename GrowthPolicy>
+    void StackAllocator<LayoutPolicy, GrowthPolicy>::freeToMarker(const Marker& marker)
+    {
+        _physicalCurrent = marker.current;
+        _lastUserPtr = marker.lastUserPtr;
+    }
+
     template<typename LayoutPolicy, typename GrowthPolicy>
     void StackAllocator<LayoutPolicy, GrowthPolicy>::purge()
     {
@@ -0,0 +1,81 @@
+#ifndef FS_ARENA_IMAGE_H
+#define FS_ARENA_IMAGE_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    // File layout of an arena image: the header followed by the used memory of the arena.
+    // The data starts at dataOffset which is chosen so that alignments of up to
+    // ArenaImageHeader::MAX_ALIGNMENT within the arena are preserved when the file is
+    // mapped at a page boundary.
+    class ArenaImageHeader
+    {
+    public:
+        static const u32 MAGIC = 0x49415346; // "FSAI"
+        static const u32 VERSION = 1;
+        static const size_t MAX_ALIGNMENT = 64;
+
+        u32 magic;
+        u32 version;
+        u64 dataOffset;
+        u64 dataSize;
+        u64 rootOffset;
+        u8 reserved[32];
+    };
+
+    static_assert(sizeof(ArenaImageHeader) == ArenaImageHeader::MAX_ALIGNMENT, "ArenaImageHeader must be 64 bytes.");
+
+    // Read only view of an arena image, usually a shared read-only mapping of the image
+    // file such as fs::MappedFile. The image must stay mapped while the view is used.
+    //
+    //     MappedFile file("lookup.fsimage");
+    //     ArenaImage image;
+    //     if(image.open(file.getData(), file.getSize()))
+    //     {
+    //         const LookupTable* table = image.getRoot<LookupTable>();
+    //     }
+    class ArenaImage
+    {
+    public:
+        ArenaImage();
+
+        // Validate the header and bounds of the image. Returns false if data is not a
+        // compatible arena image.
+        bool open(const void* data, size_t size);
+
+        template<class T>
+        inline const T* getRoot() const
+        {
+            FS_ASSERT(_data);
+            return reinterpret_cast<const T*>(_data + _rootOffset);
+        }
+
+        inline const void* getData() const { return _data; }
+        inline size_t getDataSize() const { return _dataSize; }
+
+    private:
+        const u8* _data;
+        size_t _dataSize;
+        size_t _rootOffset;
+    };
+
+    namespace memory
+    {
+        // Write size bytes from start to path as an arena image. Every pointer stored in
+        // the memory must point within the same range and be a RelativePtr so that the
+        // image is valid wherever it is mapped. root must be within the range.
+        bool saveArenaImage(const char* path, const void* start, size_t size, const void* root);
+
+        // Write the used memory of an arena backed by a LinearAllocator or StackAllocator.
+        template<class Arena>
+        inline bool saveArenaImage(const char* path, const Arena& arena, const void* root)
+        {
+            const auto& allocator = arena.getAllocator().getBackingAllocator();
+            return saveArenaImage(path, allocator.getStart(), allocator.getTotalUsedSize(), root);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef FS_ARENA_UNIQUE_PTR_H
+#define FS_ARENA_UNIQUE_PTR_H
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/new.h"
+
+namespace fs
+{
+    // Deletes an object created with FS_NEW from the arena it remembers. Unlike the
+    // std::function deleter of UniquePtr it is a single pointer and never allocates.
+    template<typename T, class Arena>
+    class ArenaDeleter
+    {
+    public:
+        ArenaDeleter() :
+            _pArena(nullptr)
+        {
+        }
+
+        explicit ArenaDeleter(Arena* pArena) :
+            _pArena(pArena)
+        {
+        }
+
+        // Allows ArenaUniquePtr<Derived> to convert to ArenaUniquePtr<Base>. The base must
+        // be the first base of Derived so that the arena is given back the pointer it
+        // returned.
+        template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        ArenaDeleter(const ArenaDeleter<U, Arena>& other) :
+            _pArena(other.getArena())
+        {
+        }
+
+        inline void operator()(T* ptr) const
+        {
+            FS_ASSERT_MSG(_pArena, "ArenaUniquePtr does not know which arena to delete from.");
+            FS_DELETE(ptr, _pArena);
+        }
+
+        inline Arena* getArena() const { return _pArena; }
+
+    private:
+        Arena* _pArena;
+    };
+
+    template<typename T, class Arena>
+    using ArenaUniquePtr = std::unique_ptr<T, ArenaDeleter<T, Arena>>;
+
+    template<typename T, class Arena, typename... Args>
+    ArenaUniquePtr<T, Arena> makeArenaUnique(Arena* pArena, Args&&... args)
+    {
+        FS_ASSERT(pArena);
+        return ArenaUniquePtr<T, Arena>(FS_NEW(T, pArena)(std::forward<Args>(args)...),
+                                        ArenaDeleter<T, Arena>(pArena));
+    }
+}
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef FS_FLAT_MAP_H
+#define FS_FLAT_MAP_H
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/containers/small_vector.h"
+
+namespace fs
+{
+    namespace internal
+    {
+        template<typename K, typename V, class Compare>
+        class CompareFlatMapKey
+        {
+        public:
+            explicit CompareFlatMapKey(const Compare& compare) : _compare(compare) {}
+
+            inline bool operator()(const std::pair<K, V>& a, const K& b) const { return _compare(a.first, b); }
+            inline bool operator()(const K& a, const std::pair<K, V>& b) const { return _compare(a, b.first); }
+
+        private:
+            Compare _compare;
+        };
+    }
+
+    // Map stored as a vector of pairs sorted by key. Lookups are a binary search over
+    // contiguous memory and small maps live entirely in the inline storage of the vector.
+    // Inserting or erasing moves the elements after the position, so prefer Map for large
+    // maps that change often. Iterators are invalidated by insert and erase. Keys must not
+    // be modified through an iterator.
+    template<typename K, typename V, class Arena, class Compare = std::less<K>, size_t N = 8>
+    class FlatMap
+    {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using Storage = SmallVector<value_type, N, Arena>;
+        using iterator = typename Storage::iterator;
+        using const_iterator = typename Storage::const_iterator;
+
+        explicit FlatMap(Arena* pArena, const Compare& compare = Compare()) :
+            _values(pArena),
+            _compare(compare)
+        {
+        }
+
+        inline iterator begin() { return _values.begin(); }
+        inline iterator end() { return _values.end(); }
+        inline const_iterator begin() const { return _values.begin(); }
+        inline const_iterator end() const { return _values.end(); }
+
+        inline size_t size() const { return _values.size(); }
+        inline bool empty() const { return _values.empty(); }
+        inline void clear() { _values.clear(); }
+        inline void reserve(size_t capacity) { _values.reserve(capacity); }
+
+        iterator lower_bound(const K& key)
+        {
+            return std::lower_bound(_values.begin(), _values.end(), key, getKeyCompare());
+        }
+
+        const_iterator lower_bound(const K& key) const
+        {
+            return std::lower_bound(_values.begin(), _values.end(), key, getKeyCompare());
+        }
+
+        iterator find(const K& key)
+        {
+            iterator iter = lower_bound(key);
+            return iter != end() && !_compare(key, iter->first) ? iter : end();
+        }
+
+        const_iterator find(const K& key) const
+        {
+            const_iterator iter = lower_bound(key);
+            return iter != end() && !_compare(key, iter->first) ? iter : end();
+        }
+
+        inline size_t count(const K& key) const
+        {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        V& at(const K& key)
+        {
+            iterator iter = find(key);
+            FS_ASSERT_MSG(iter != end(), "Key is not in the FlatMap.");
+            return iter->second;
+        }
+
+        const V& at(const K& key) const
+        {
+            const_iterator iter = find(key);
+            FS_ASSERT_MSG(iter != end(), "Key is not in the FlatMap.");
+            return iter->second;
+        }
+
+        V& operator[](const K& key)
+        {
+            return emplace(key).first->second;
+        }
+
+        // Does nothing and returns the existing element if the key is already in the map.
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return emplace(std::move(value.first), std::move(value.second));
+        }
+
+        // V is only constructed from args when the key is not in the map yet.
+        template<typename Key, typename... Args>
+        std::pair<iterator, bool> emplace(Key&& key, Args&&... args)
+        {
+            iterator iter = lower_bound(key);
+            if(iter != end() && !_compare(key, iter->first))
+            {
+                return std::make_pair(iter, false);
+            }
+
+            iter = _values.emplace(iter, std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<Key>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+            return std::make_pair(iter, true);
+        }
+
+        inline iterator erase(const_iterator position)
+        {
+            return _values.erase(position);
+        }
+
+        size_t erase(const K& key)
+        {
+            iterator iter = find(key);
+            if(iter == end())
+            {
+                return 0;
+            }
+            _values.erase(iter);
+            return 1;
+        }
+
+    private:
+        inline internal::CompareFlatMapKey<K, V, Compare> getKeyCompare() const
+        {
+            return internal::CompareFlatMapKey<K, V, Compare>(_compare);
+        }
+
+        Storage _values;
+        Compare _compare;
+    };
+
+    // Set stored as a sorted vector. See FlatMap.
+    template<typename T, class Arena, class Compare = std::less<T>, size_t N = 8>
+    class FlatSet
+    {
+    public:
+        using key_type = T;
+        using value_type = T;
+        using Storage = SmallVector<T, N, Arena>;
+        using iterator = typename Storage::const_iterator;
+        using const_iterator = typename Storage::const_iterator;
+
+        explicit FlatSet(Arena* pArena, const Compare& compare = Compare()) :
+            _values(pArena),
+            _compare(compare)
+        {
+        }
+
+        inline const_iterator begin() const { return _values.begin(); }
+        inline const_iterator end() const { return _values.end(); }
+
+        inline size_t size() const { return _values.size(); }
+        inline bool empty() const { return _values.empty(); }
+        inline void clear() { _values.clear(); }
+        inline void reserve(size_t capacity) { _values.reserve(capacity); }
+
+        const_iterator lower_bound(const T& value) const
+        {
+            return std::lower_bound(_values.begin(), _values.end(), value, _compare);
+        }
+
+        const_iterator find(const T& value) const
+        {
+            const_iterator iter = lower_bound(value);
+            return iter != end() && !_compare(value, *iter) ? iter : end();
+        }
+
+        inline size_t count(const T& value) const
+        {
+            return find(value) != end() ? 1 : 0;
+        }
+
+        std::pair<const_iterator, bool> insert(const T& value)
+        {
+            const_iterator iter = lower_bound(value);
+            if(iter != end() && !_compare(value, *iter))
+            {
+                return std::make_pair(iter, false);
+            }
+            return std::make_pair(const_iterator(_values.insert(iter, value)), true);
+        }
+
+        std::pair<const_iterator, bool> insert(T&& value)
+        {
+            const_iterator iter = lower_bound(value);
+            if(iter != end() && !_compare(value, *iter))
+            {
+                return std::make_pair(iter, false);
+            }
+            return std::make_pair(const_iterator(_values.insert(iter, std::move(value))), true);
+        }
+
+        inline const_iterator erase(const_iterator position)
+        {
+            return _values.erase(position);
+        }
+
+        size_t erase(const T& value)
+        {
+            const_iterator iter = find(value);
+            if(iter == end())
+            {
+                return 0;
+            }
+            _values.erase(iter);
+            return 1;
+        }
+
+    private:
+        Storage _values;
+        Compare _compare;
+    };
+}
+
+#endif
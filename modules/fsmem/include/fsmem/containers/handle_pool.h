@@ -0,0 +1,231 @@
+#ifndef FS_HANDLE_POOL_H
+#define FS_HANDLE_POOL_H
+
+#include <new>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/source_info.h"
+#include "fsmem/freelist.h"
+
+namespace fs
+{
+    // 32 bit reference to an object of a HandlePool<T>. The low bits are the index of the
+    // object's slot and the high bits are the generation of the slot when the object was
+    // created. Destroying the object bumps the generation of its slot so any handle still
+    // held to it no longer resolves, even after the slot is reused. A default constructed
+    // handle is null and never resolves.
+    template<typename T>
+    class Handle
+    {
+    public:
+        static const u32 INDEX_BITS = 20;
+        static const u32 GENERATION_BITS = 32 - INDEX_BITS;
+        static const u32 MAX_INDEX = (1u << INDEX_BITS) - 1;
+        static const u32 MAX_GENERATION = (1u << GENERATION_BITS) - 1;
+
+        constexpr Handle() :
+            _value(0)
+        {
+        }
+
+        constexpr Handle(u32 index, u32 generation) :
+            _value((generation << INDEX_BITS) | index)
+        {
+        }
+
+        static constexpr Handle fromValue(u32 value)
+        {
+            return Handle(value & MAX_INDEX, value >> INDEX_BITS);
+        }
+
+        constexpr u32 getIndex() const { return _value & MAX_INDEX; }
+        constexpr u32 getGeneration() const { return _value >> INDEX_BITS; }
+        constexpr u32 getValue() const { return _value; }
+        constexpr bool isNull() const { return _value == 0; }
+
+        constexpr bool operator==(const Handle& other) const { return _value == other._value; }
+        constexpr bool operator!=(const Handle& other) const { return _value != other._value; }
+
+    private:
+        u32 _value;
+    };
+
+    // Fixed capacity pool of T addressed through generational handles. Live objects are
+    // kept packed at the front of a single array so update loops walk contiguous memory;
+    // destroying an object moves the last object into its place. Slots, which map a handle
+    // to the object's position, are recycled through a Freelist. Resolving a handle is one
+    // slot lookup and a generation compare, so stale handles are detected in O(1).
+    //
+    // Because objects are only reached through handles they may be moved freely, but
+    // pointers returned by get() and iteration are invalidated by destroy(). Iterate in
+    // reverse to destroy objects while iterating.
+    template<typename T, class Arena>
+    class HandlePool : Uncopyable
+    {
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        HandlePool(Arena* pArena, u32 capacity) :
+            _pArena(pArena),
+            _size(0),
+            _capacity(capacity)
+        {
+            FS_ASSERT(pArena);
+            FS_ASSERT_MSG(capacity > 0 && capacity - 1 <= Handle<T>::MAX_INDEX,
+                          "HandlePool capacity does not fit in the index bits of a handle.");
+
+            _pSlots = static_cast<Slot*>(_pArena->allocate(sizeof(Slot) * capacity, alignof(Slot), FS_SOURCE_INFO));
+            _pObjects = static_cast<T*>(_pArena->allocate(sizeof(T) * capacity, alignof(T), FS_SOURCE_INFO));
+            _pDenseToSlot = static_cast<u32*>(_pArena->allocate(sizeof(u32) * capacity, alignof(u32), FS_SOURCE_INFO));
+            FS_ASSERT_MSG(_pSlots && _pObjects && _pDenseToSlot, "HandlePool failed to allocate memory.");
+
+            for(u32 i = 0; i < capacity; ++i)
+            {
+                _pSlots[i].generation = 1 | FREE_BIT;
+            }
+            _freelist = SlotFreelist(_pSlots, _pSlots + capacity, sizeof(Slot), alignof(Slot), 0);
+        }
+
+        ~HandlePool()
+        {
+            clear();
+            _pArena->free(_pDenseToSlot);
+            _pArena->free(_pObjects);
+            _pArena->free(_pSlots);
+        }
+
+        // Returns a null handle when the pool is full.
+        template<typename... Args>
+        Handle<T> create(Args&&... args)
+        {
+            Slot* pSlot = static_cast<Slot*>(_freelist.obtain());
+            if(!pSlot)
+            {
+                return Handle<T>();
+            }
+
+            const u32 index = (u32)(pSlot - _pSlots);
+            new (_pObjects + _size) T(std::forward<Args>(args)...);
+            _pDenseToSlot[_size] = index;
+            pSlot->denseIndex = _size++;
+            pSlot->generation &= ~FREE_BIT;
+            return Handle<T>(index, pSlot->generation);
+        }
+
+        // Returns false if the handle is stale or null.
+        bool destroy(Handle<T> handle)
+        {
+            Slot* pSlot = resolve(handle);
+            if(!pSlot)
+            {
+                return false;
+            }
+
+            const u32 denseIndex = pSlot->denseIndex;
+            const u32 last = --_size;
+            _pObjects[denseIndex].~T();
+            if(denseIndex != last)
+            {
+                new (_pObjects + denseIndex) T(std::move(_pObjects[last]));
+                _pObjects[last].~T();
+                _pDenseToSlot[denseIndex] = _pDenseToSlot[last];
+                _pSlots[_pDenseToSlot[denseIndex]].denseIndex = denseIndex;
+            }
+
+            pSlot->generation = nextGeneration(pSlot->generation) | FREE_BIT;
+            _freelist.release(pSlot);
+            return true;
+        }
+
+        void clear()
+        {
+            while(_size > 0)
+            {
+                destroy(getHandle(_size - 1));
+            }
+        }
+
+        // Returns nullptr if the handle is stale or null.
+        inline T* get(Handle<T> handle)
+        {
+            Slot* pSlot = resolve(handle);
+            return pSlot ? _pObjects + pSlot->denseIndex : nullptr;
+        }
+
+        inline const T* get(Handle<T> handle) const
+        {
+            return const_cast<HandlePool*>(this)->get(handle);
+        }
+
+        inline bool isAlive(Handle<T> handle) const
+        {
+            return const_cast<HandlePool*>(this)->resolve(handle) != nullptr;
+        }
+
+        // Handle of the object at the given position of the packed array, for use while
+        // iterating.
+        inline Handle<T> getHandle(u32 denseIndex) const
+        {
+            FS_ASSERT(denseIndex < _size);
+            const u32 index = _pDenseToSlot[denseIndex];
+            return Handle<T>(index, _pSlots[index].generation);
+        }
+
+        inline iterator begin() { return _pObjects; }
+        inline iterator end() { return _pObjects + _size; }
+        inline const_iterator begin() const { return _pObjects; }
+        inline const_iterator end() const { return _pObjects + _size; }
+
+        inline T& operator[](u32 denseIndex) { FS_ASSERT(denseIndex < _size); return _pObjects[denseIndex]; }
+        inline const T& operator[](u32 denseIndex) const { FS_ASSERT(denseIndex < _size); return _pObjects[denseIndex]; }
+
+        inline u32 size() const { return _size; }
+        inline u32 capacity() const { return _capacity; }
+        inline bool empty() const { return _size == 0; }
+        inline bool full() const { return _size == _capacity; }
+
+    private:
+        // Set in the generation of free slots so no handle matches them.
+        static const u32 FREE_BIT = 1u << 31;
+
+        // The freelist stores its link in denseIndex while the slot is free; generation
+        // is preserved so the next object in the slot gets a new one.
+        struct Slot
+        {
+            u32 denseIndex;
+            u32 generation;
+        };
+
+        using SlotFreelist = Freelist<IndexSize::fourBytes>;
+
+        static inline u32 nextGeneration(u32 generation)
+        {
+            generation = (generation & ~FREE_BIT) + 1;
+            return generation > Handle<T>::MAX_GENERATION ? 1 : generation;
+        }
+
+        inline Slot* resolve(Handle<T> handle)
+        {
+            const u32 index = handle.getIndex();
+            if(index >= _capacity || _pSlots[index].generation != handle.getGeneration())
+            {
+                return nullptr;
+            }
+            return _pSlots + index;
+        }
+
+        Arena* _pArena;
+        Slot* _pSlots;
+        T* _pObjects;
+        u32* _pDenseToSlot;
+        SlotFreelist _freelist;
+        u32 _size;
+        u32 _capacity;
+    };
+}
+
+#endif
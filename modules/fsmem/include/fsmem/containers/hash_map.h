@@ -0,0 +1,392 @@
+#ifndef FS_HASH_MAP_H
+#define FS_HASH_MAP_H
+
+#include <new>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/source_info.h"
+
+namespace fs
+{
+    // Hash map using open addressing with linear probing. Elements are stored in a
+    // single array allocated from the arena, next to the hash of their key, so a lookup
+    // touches one or two cache lines instead of following the nodes of a Map. Erasing
+    // shifts the following elements back instead of leaving tombstones.
+    //
+    // The table grows to the next power of two when it becomes 3/4 full. Iterators and
+    // references are invalidated by any insert that grows the table and by erase.
+    template<typename K, typename V, class Arena, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+    class HashMap
+    {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+
+        template<bool isConst>
+        class Iterator
+        {
+        public:
+            using Map = typename std::conditional<isConst, const HashMap, HashMap>::type;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename HashMap::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = typename std::conditional<isConst, const value_type*, value_type*>::type;
+            using reference = typename std::conditional<isConst, const value_type&, value_type&>::type;
+
+            Iterator(Map* pMap, size_t index) :
+                _pMap(pMap),
+                _index(index)
+            {
+            }
+
+            // Allow conversion from iterator to const_iterator.
+            template<bool otherConst, typename = typename std::enable_if<isConst && !otherConst>::type>
+            Iterator(const Iterator<otherConst>& other) :
+                _pMap(other._pMap),
+                _index(other._index)
+            {
+            }
+
+            inline reference operator*() const { return _pMap->_pSlots[_index]; }
+            inline pointer operator->() const { return &_pMap->_pSlots[_index]; }
+
+            inline Iterator& operator++()
+            {
+                _index = _pMap->nextUsedIndex(_index + 1);
+                return *this;
+            }
+
+            inline Iterator operator++(int)
+            {
+                Iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            inline bool operator==(const Iterator& other) const { return _index == other._index; }
+            inline bool operator!=(const Iterator& other) const { return _index != other._index; }
+
+        private:
+            friend class HashMap;
+            template<bool> friend class Iterator;
+
+            Map* _pMap;
+            size_t _index;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        explicit HashMap(Arena* pArena, size_t capacity = 0) :
+            _pArena(pArena),
+            _pHashes(nullptr),
+            _pSlots(nullptr),
+            _size(0),
+            _capacity(0),
+            _shift(0)
+        {
+            FS_ASSERT(pArena);
+            reserve(capacity);
+        }
+
+        HashMap(const HashMap&) = delete;
+        HashMap& operator=(const HashMap&) = delete;
+
+        HashMap(HashMap&& other) :
+            _pArena(other._pArena),
+            _pHashes(other._pHashes),
+            _pSlots(other._pSlots),
+            _size(other._size),
+            _capacity(other._capacity),
+            _shift(other._shift),
+            _hash(std::move(other._hash)),
+            _equal(std::move(other._equal))
+        {
+            other._pHashes = nullptr;
+            other._pSlots = nullptr;
+            other._size = 0;
+            other._capacity = 0;
+        }
+
+        ~HashMap()
+        {
+            clear();
+            if(_pHashes)
+            {
+                _pArena->free(_pHashes);
+            }
+        }
+
+        inline iterator begin() { return iterator(this, nextUsedIndex(0)); }
+        inline iterator end() { return iterator(this, _capacity); }
+        inline const_iterator begin() const { return const_iterator(this, nextUsedIndex(0)); }
+        inline const_iterator end() const { return const_iterator(this, _capacity); }
+
+        inline size_t size() const { return _size; }
+        inline bool empty() const { return _size == 0; }
+        inline size_t capacity() const { return _capacity; }
+
+        // Make room for count elements without growing.
+        void reserve(size_t count)
+        {
+            size_t capacity = _capacity > 0 ? _capacity : MIN_CAPACITY;
+            while(count * MAX_LOAD_DENOMINATOR > capacity * MAX_LOAD_NUMERATOR)
+            {
+                capacity *= 2;
+            }
+
+            if(count > 0 && capacity > _capacity)
+            {
+                rehash(capacity);
+            }
+        }
+
+        void clear()
+        {
+            for(size_t i = 0; i < _capacity; ++i)
+            {
+                if(_pHashes[i] != EMPTY)
+                {
+                    _pSlots[i].~value_type();
+                    _pHashes[i] = EMPTY;
+                }
+            }
+            _size = 0;
+        }
+
+        iterator find(const K& key)
+        {
+            return iterator(this, findIndex(key, hashKey(key)));
+        }
+
+        const_iterator find(const K& key) const
+        {
+            return const_iterator(this, findIndex(key, hashKey(key)));
+        }
+
+        inline size_t count(const K& key) const
+        {
+            return findIndex(key, hashKey(key)) != _capacity ? 1 : 0;
+        }
+
+        V& at(const K& key)
+        {
+            const size_t index = findIndex(key, hashKey(key));
+            FS_ASSERT_MSG(index != _capacity, "Key is not in the HashMap.");
+            return _pSlots[index].second;
+        }
+
+        const V& at(const K& key) const
+        {
+            const size_t index = findIndex(key, hashKey(key));
+            FS_ASSERT_MSG(index != _capacity, "Key is not in the HashMap.");
+            return _pSlots[index].second;
+        }
+
+        V& operator[](const K& key)
+        {
+            return emplace(key).first->second;
+        }
+
+        // Does nothing and returns the existing element if the key is already in the map.
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return emplace(std::move(value.first), std::move(value.second));
+        }
+
+        // V is only constructed from args when the key is not in the map yet.
+        template<typename Key, typename... Args>
+        std::pair<iterator, bool> emplace(Key&& key, Args&&... args)
+        {
+            const size_t hash = hashKey(key);
+            const size_t existing = findIndex(key, hash);
+            if(existing != _capacity)
+            {
+                return std::make_pair(iterator(this, existing), false);
+            }
+
+            if((_size + 1) * MAX_LOAD_DENOMINATOR > _capacity * MAX_LOAD_NUMERATOR)
+            {
+                rehash(_capacity > 0 ? _capacity * 2 : MIN_CAPACITY);
+            }
+
+            const size_t index = findEmptyIndex(hash);
+            new (_pSlots + index) value_type(std::piecewise_construct,
+                                             std::forward_as_tuple(std::forward<Key>(key)),
+                                             std::forward_as_tuple(std::forward<Args>(args)...));
+            _pHashes[index] = hash;
+            ++_size;
+            return std::make_pair(iterator(this, index), true);
+        }
+
+        size_t erase(const K& key)
+        {
+            const size_t index = findIndex(key, hashKey(key));
+            if(index == _capacity)
+            {
+                return 0;
+            }
+            eraseIndex(index);
+            return 1;
+        }
+
+        // Elements after position may move into its slot so erasing while iterating is
+        // not supported.
+        void erase(const_iterator position)
+        {
+            FS_ASSERT(position._pMap == this && position._index < _capacity);
+            eraseIndex(position._index);
+        }
+
+    private:
+        static const size_t EMPTY = 0;
+        static const size_t MIN_CAPACITY = 8;
+        static const size_t MAX_LOAD_NUMERATOR = 3;
+        static const size_t MAX_LOAD_DENOMINATOR = 4;
+
+        // Fibonacci hashing spreads keys with poor low bits, such as pointers, across the
+        // table. The low bit is set so that a stored hash is never EMPTY; the index is
+        // taken from the high bits.
+        inline size_t hashKey(const K& key) const
+        {
+            const size_t hash = (size_t)_hash(key) * (size_t)0x9E3779B97F4A7C15ull;
+            return hash | 1;
+        }
+
+        inline size_t getIdealIndex(size_t hash) const
+        {
+            return hash >> _shift;
+        }
+
+        size_t findIndex(const K& key, size_t hash) const
+        {
+            if(_size == 0)
+            {
+                return _capacity;
+            }
+
+            const size_t mask = _capacity - 1;
+            for(size_t i = getIdealIndex(hash); ; i = (i + 1) & mask)
+            {
+                if(_pHashes[i] == EMPTY)
+                {
+                    return _capacity;
+                }
+                if(_pHashes[i] == hash && _equal(_pSlots[i].first, key))
+                {
+                    return i;
+                }
+            }
+        }
+
+        size_t findEmptyIndex(size_t hash) const
+        {
+            const size_t mask = _capacity - 1;
+            size_t i = getIdealIndex(hash);
+            while(_pHashes[i] != EMPTY)
+            {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        size_t nextUsedIndex(size_t index) const
+        {
+            while(index < _capacity && _pHashes[index] == EMPTY)
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        void eraseIndex(size_t index)
+        {
+            const size_t mask = _capacity - 1;
+            _pSlots[index].~value_type();
+            _pHashes[index] = EMPTY;
+            --_size;
+
+            // Shift back every following element of the cluster that would no longer be
+            // reachable from its ideal index.
+            for(size_t next = (index + 1) & mask; _pHashes[next] != EMPTY; next = (next + 1) & mask)
+            {
+                const size_t ideal = getIdealIndex(_pHashes[next]);
+                if(((next - ideal) & mask) >= ((next - index) & mask))
+                {
+                    new (_pSlots + index) value_type(std::move(_pSlots[next]));
+                    _pHashes[index] = _pHashes[next];
+                    _pSlots[next].~value_type();
+                    _pHashes[next] = EMPTY;
+                    index = next;
+                }
+            }
+        }
+
+        void rehash(size_t capacity)
+        {
+            FS_ASSERT((capacity & (capacity - 1)) == 0);
+
+            const size_t slotsOffset = (capacity * sizeof(size_t) + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+            const size_t alignment = alignof(value_type) > alignof(size_t) ? alignof(value_type) : alignof(size_t);
+            void* pMemory = _pArena->allocate(slotsOffset + capacity * sizeof(value_type), alignment, FS_SOURCE_INFO);
+            FS_ASSERT_MSG(pMemory, "HashMap failed to allocate memory.");
+
+            size_t* pOldHashes = _pHashes;
+            value_type* pOldSlots = _pSlots;
+            const size_t oldCapacity = _capacity;
+
+            _pHashes = static_cast<size_t*>(pMemory);
+            _pSlots = reinterpret_cast<value_type*>(static_cast<u8*>(pMemory) + slotsOffset);
+            _capacity = capacity;
+            _shift = sizeof(size_t) * 8;
+            for(size_t c = capacity; c > 1; c >>= 1)
+            {
+                --_shift;
+            }
+
+            for(size_t i = 0; i < capacity; ++i)
+            {
+                _pHashes[i] = EMPTY;
+            }
+
+            for(size_t i = 0; i < oldCapacity; ++i)
+            {
+                if(pOldHashes[i] != EMPTY)
+                {
+                    const size_t index = findEmptyIndex(pOldHashes[i]);
+                    new (_pSlots + index) value_type(std::move(pOldSlots[i]));
+                    _pHashes[index] = pOldHashes[i];
+                    pOldSlots[i].~value_type();
+                }
+            }
+
+            if(pOldHashes)
+            {
+                _pArena->free(pOldHashes);
+            }
+        }
+
+        Arena* _pArena;
+        size_t* _pHashes;
+        value_type* _pSlots;
+        size_t _size;
+        size_t _capacity;
+        u32 _shift;
+        Hash _hash;
+        Equal _equal;
+    };
+}
+
+#endif
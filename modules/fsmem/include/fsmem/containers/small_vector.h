@@ -0,0 +1,314 @@
+#ifndef FS_SMALL_VECTOR_H
+#define FS_SMALL_VECTOR_H
+
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/source_info.h"
+
+namespace fs
+{
+    // Vector that stores up to N elements inline and moves to memory allocated from an
+    // arena once it grows beyond that. Containers that are usually tiny, such as the
+    // listeners of a channel, then cost no allocation and no pointer chasing.
+    // Iterators are invalidated by any operation that grows the vector.
+    template<typename T, size_t N, class Arena>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector must have an inline capacity of at least 1.");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+
+        static const size_t INLINE_CAPACITY = N;
+
+        explicit SmallVector(Arena* pArena) :
+            _pArena(pArena),
+            _pData(getInlineData()),
+            _size(0),
+            _capacity(N)
+        {
+            FS_ASSERT(pArena);
+        }
+
+        SmallVector(std::initializer_list<T> values, Arena* pArena) :
+            SmallVector(pArena)
+        {
+            reserve(values.size());
+            for(const T& value : values)
+            {
+                new (_pData + _size++) T(value);
+            }
+        }
+
+        SmallVector(const SmallVector& other) :
+            SmallVector(other._pArena)
+        {
+            *this = other;
+        }
+
+        SmallVector(SmallVector&& other) :
+            SmallVector(other._pArena)
+        {
+            *this = std::move(other);
+        }
+
+        ~SmallVector()
+        {
+            clear();
+            releaseHeap();
+        }
+
+        SmallVector& operator=(const SmallVector& other)
+        {
+            if(this != &other)
+            {
+                clear();
+                reserve(other._size);
+                for(const T& value : other)
+                {
+                    new (_pData + _size++) T(value);
+                }
+            }
+            return *this;
+        }
+
+        // Steals the memory of other when both use the same arena and other is not inline.
+        SmallVector& operator=(SmallVector&& other)
+        {
+            if(this == &other)
+            {
+                return *this;
+            }
+
+            clear();
+            if(!other.isInline() && other._pArena == _pArena)
+            {
+                releaseHeap();
+                _pData = other._pData;
+                _size = other._size;
+                _capacity = other._capacity;
+                other._pData = other.getInlineData();
+                other._size = 0;
+                other._capacity = N;
+            }
+            else
+            {
+                reserve(other._size);
+                for(T& value : other)
+                {
+                    new (_pData + _size++) T(std::move(value));
+                }
+                other.clear();
+            }
+            return *this;
+        }
+
+        inline iterator begin() { return _pData; }
+        inline iterator end() { return _pData + _size; }
+        inline const_iterator begin() const { return _pData; }
+        inline const_iterator end() const { return _pData + _size; }
+
+        inline T* data() { return _pData; }
+        inline const T* data() const { return _pData; }
+
+        inline size_t size() const { return _size; }
+        inline size_t capacity() const { return _capacity; }
+        inline bool empty() const { return _size == 0; }
+
+        // True while the elements are stored within the vector itself.
+        inline bool isInline() const { return _pData == getInlineData(); }
+
+        inline Arena* getArena() const { return _pArena; }
+
+        inline T& operator[](size_t index)
+        {
+            FS_ASSERT(index < _size);
+            return _pData[index];
+        }
+
+        inline const T& operator[](size_t index) const
+        {
+            FS_ASSERT(index < _size);
+            return _pData[index];
+        }
+
+        inline T& front() { FS_ASSERT(_size > 0); return _pData[0]; }
+        inline const T& front() const { FS_ASSERT(_size > 0); return _pData[0]; }
+        inline T& back() { FS_ASSERT(_size > 0); return _pData[_size - 1]; }
+        inline const T& back() const { FS_ASSERT(_size > 0); return _pData[_size - 1]; }
+
+        void reserve(size_t capacity)
+        {
+            if(capacity > _capacity)
+            {
+                grow(capacity);
+            }
+        }
+
+        inline void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        inline void push_back(T&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if(_size == _capacity)
+            {
+                // Construct first in case args refers to an element of this vector.
+                T value(std::forward<Args>(args)...);
+                grow(_capacity * 2);
+                return *new (_pData + _size++) T(std::move(value));
+            }
+            return *new (_pData + _size++) T(std::forward<Args>(args)...);
+        }
+
+        inline void pop_back()
+        {
+            FS_ASSERT(_size > 0);
+            _pData[--_size].~T();
+        }
+
+        iterator insert(const_iterator position, const T& value)
+        {
+            return emplace(position, value);
+        }
+
+        iterator insert(const_iterator position, T&& value)
+        {
+            return emplace(position, std::move(value));
+        }
+
+        template<typename... Args>
+        iterator emplace(const_iterator position, Args&&... args)
+        {
+            const size_t index = position - _pData;
+            FS_ASSERT(index <= _size);
+
+            T value(std::forward<Args>(args)...);
+            if(index == _size)
+            {
+                emplace_back(std::move(value));
+                return _pData + index;
+            }
+
+            if(_size == _capacity)
+            {
+                grow(_capacity * 2);
+            }
+
+            new (_pData + _size) T(std::move(_pData[_size - 1]));
+            for(size_t i = _size - 1; i > index; --i)
+            {
+                _pData[i] = std::move(_pData[i - 1]);
+            }
+            _pData[index] = std::move(value);
+            ++_size;
+            return _pData + index;
+        }
+
+        iterator erase(const_iterator position)
+        {
+            return erase(position, position + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            T* pFirst = const_cast<T*>(first);
+            T* pLast = const_cast<T*>(last);
+            FS_ASSERT(pFirst >= _pData && pLast <= _pData + _size && pFirst <= pLast);
+
+            T* pEnd = _pData + _size;
+            T* pDest = pFirst;
+            for(T* pSource = pLast; pSource != pEnd; ++pSource, ++pDest)
+            {
+                *pDest = std::move(*pSource);
+            }
+
+            for(T* p = pDest; p != pEnd; ++p)
+            {
+                p->~T();
+            }
+
+            _size = pDest - _pData;
+            return pFirst;
+        }
+
+        void resize(size_t size)
+        {
+            reserve(size);
+            while(_size < size)
+            {
+                new (_pData + _size++) T();
+            }
+            while(_size > size)
+            {
+                pop_back();
+            }
+        }
+
+        void clear()
+        {
+            for(size_t i = 0; i < _size; ++i)
+            {
+                _pData[i].~T();
+            }
+            _size = 0;
+        }
+
+    private:
+        using InlineStorage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+        inline T* getInlineData() { return reinterpret_cast<T*>(_inline); }
+        inline const T* getInlineData() const { return reinterpret_cast<const T*>(_inline); }
+
+        void grow(size_t capacity)
+        {
+            T* pData = static_cast<T*>(_pArena->allocate(sizeof(T) * capacity, alignof(T), FS_SOURCE_INFO));
+            FS_ASSERT_MSG(pData, "SmallVector failed to allocate memory.");
+
+            for(size_t i = 0; i < _size; ++i)
+            {
+                new (pData + i) T(std::move(_pData[i]));
+                _pData[i].~T();
+            }
+
+            releaseHeap();
+            _pData = pData;
+            _capacity = capacity;
+        }
+
+        void releaseHeap()
+        {
+            if(!isInline())
+            {
+                _pArena->free(_pData);
+                _pData = getInlineData();
+                _capacity = N;
+            }
+        }
+
+        Arena* _pArena;
+        T* _pData;
+        size_t _size;
+        size_t _capacity;
+        InlineStorage _inline[N];
+    };
+}
+
+#endif
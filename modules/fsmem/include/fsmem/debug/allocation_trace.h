@@ -0,0 +1,117 @@
+#ifndef FS_ALLOCATION_TRACE_H
+#define FS_ALLOCATION_TRACE_H
+
+#include "fsmem/debug/memory.h"
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/stl_types.h"
+#include "fsmem/allocators/stl_allocator.h"
+
+namespace fs
+{
+    // A single recorded event. Kept at 32 bytes so that long traces stay compact on
+    // disk and can be written without any transformation.
+    struct AllocationTraceEvent
+    {
+        enum Type : u8
+        {
+            ALLOCATE = 0,
+            FREE = 1,
+            // An allocation made by MemoryArena::reallocate. relatedId is the allocation
+            // whose contents were copied; a FREE for relatedId follows.
+            REALLOCATE = 2,
+            // The arena was reset. All live allocations are released.
+            RESET = 3
+        };
+
+        u8 type;
+        u8 alignmentLog2;
+        u16 thread;
+        u32 id;
+        u32 relatedId;
+        u32 size;
+        // Nanoseconds since the trace started.
+        u64 timestamp;
+        // Nanoseconds between allocation and free. Filled in on both the allocation
+        // and the free event. Zero for allocations that were never freed.
+        u64 lifetime;
+    };
+
+    static_assert(sizeof(AllocationTraceEvent) == 32, "AllocationTraceEvent is expected to be 32 bytes.");
+
+    class AllocationTrace
+    {
+    public:
+        AllocationTrace();
+
+        inline void push(const AllocationTraceEvent& event) { _events.push_back(event); }
+        inline void clear() { _events.clear(); }
+
+        inline AllocationTraceEvent& operator[](size_t index) { return _events[index]; }
+        inline const AllocationTraceEvent& operator[](size_t index) const { return _events[index]; }
+        inline size_t getNumEvents() const { return _events.size(); }
+
+        // One greater than the largest allocation id in the trace. Ids are handed out
+        // sequentially so this is also the number of allocations ever made.
+        u32 getIdRange() const;
+        u32 getNumThreads() const;
+        size_t getMaxAllocationSize() const;
+        size_t getMaxAlignment() const;
+
+        // True if every free releases the most recent live allocation. Only LIFO traces
+        // can be replayed on a StackAllocator.
+        bool isLifo() const;
+
+        // Binary file containing a small header followed by the raw events.
+        bool save(const char* path) const;
+        bool load(const char* path);
+
+    private:
+        DebugVector<AllocationTraceEvent> _events;
+    };
+
+    class TraceReplayReport
+    {
+    public:
+        size_t numAllocations = 0;
+        size_t numFrees = 0;
+        size_t numReallocations = 0;
+        size_t numResets = 0;
+        size_t numFailedAllocations = 0;
+
+        f64 totalNanoseconds = 0;
+        f64 operationsPerSecond = 0;
+
+        // Per operation latency in nanoseconds. Includes the copy for reallocations.
+        u64 latencyP50 = 0;
+        u64 latencyP90 = 0;
+        u64 latencyP99 = 0;
+        u64 latencyP999 = 0;
+        u64 latencyMax = 0;
+
+        // Largest sum of live user sizes and largest getTotalUsedSize of the allocator.
+        size_t peakLiveSize = 0;
+        size_t peakUsedSize = 0;
+
+        // Share of the allocator's used memory that was overhead or holes when used
+        // memory peaked: 1 - live / used. Zero for allocators that do not report
+        // their used size.
+        f32 fragmentation = 0;
+
+        // Sorts latencies and fills in the percentiles and throughput.
+        void computeLatencies(DebugVector<u32>& latencies);
+    };
+
+    namespace memory
+    {
+        // Drive allocator with every event in trace. Allocator only needs
+        // allocate(size, alignment, offset), free(ptr), reset() and getTotalUsedSize().
+        // Allocations that fail are counted and their frees are skipped.
+        template<class Allocator>
+        void replayTrace(const AllocationTrace& trace, Allocator& allocator, TraceReplayReport& report);
+    }
+}
+
+#include "fsmem/debug/allocation_trace.inl"
+
+#endif
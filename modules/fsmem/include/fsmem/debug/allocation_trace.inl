@@ -0,0 +1,130 @@
+#ifndef FS_ALLOCATION_TRACE_INL
+#define FS_ALLOCATION_TRACE_INL
+
+#include <chrono>
+#include <cstring>
+
+#include "fsmem/debug/allocation_trace.h"
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    namespace memory
+    {
+        template<class Allocator>
+        void replayTrace(const AllocationTrace& trace, Allocator& allocator, TraceReplayReport& report)
+        {
+            using namespace std::chrono;
+
+            const size_t numEvents = trace.getNumEvents();
+            const u32 idRange = trace.getIdRange();
+
+            // All bookkeeping is allocated up front from the debug arena so it does not
+            // interfere with the allocator being measured.
+            DebugVector<void*> pointers(idRange, nullptr, DebugStlAllocator<void*>());
+            DebugVector<u32> sizes(idRange, 0, DebugStlAllocator<u32>());
+            DebugVector<u32> latencies{DebugStlAllocator<u32>()};
+            latencies.reserve(numEvents);
+
+            size_t liveSize = 0;
+
+            for(size_t i = 0; i < numEvents; ++i)
+            {
+                const AllocationTraceEvent& event = trace[i];
+                const size_t alignment = (size_t)1 << event.alignmentLog2;
+
+                auto start = steady_clock::now();
+                switch(event.type)
+                {
+                    case AllocationTraceEvent::ALLOCATE:
+                    {
+                        pointers[event.id] = allocator.allocate(event.size, alignment, 0);
+                        break;
+                    }
+                    case AllocationTraceEvent::REALLOCATE:
+                    {
+                        void* ptr = allocator.allocate(event.size, alignment, 0);
+                        void* oldPtr = pointers[event.relatedId];
+                        if(ptr && oldPtr)
+                        {
+                            memcpy(ptr, oldPtr, sizes[event.relatedId] < event.size ? sizes[event.relatedId] : event.size);
+                        }
+                        pointers[event.id] = ptr;
+                        break;
+                    }
+                    case AllocationTraceEvent::FREE:
+                    {
+                        if(pointers[event.id])
+                        {
+                            allocator.free(pointers[event.id]);
+                        }
+                        break;
+                    }
+                    case AllocationTraceEvent::RESET:
+                    {
+                        allocator.reset();
+                        break;
+                    }
+                    default:
+                        FS_ASSERT(!"Unknown allocation trace event type.");
+                }
+                auto end = steady_clock::now();
+                latencies.push_back((u32)duration_cast<nanoseconds>(end - start).count());
+
+                // Bookkeeping is done outside of the timed region.
+                switch(event.type)
+                {
+                    case AllocationTraceEvent::ALLOCATE:
+                    case AllocationTraceEvent::REALLOCATE:
+                        if(event.type == AllocationTraceEvent::ALLOCATE)
+                            report.numAllocations++;
+                        else
+                            report.numReallocations++;
+
+                        if(pointers[event.id])
+                        {
+                            sizes[event.id] = event.size;
+                            liveSize += event.size;
+                        }
+                        else
+                        {
+                            report.numFailedAllocations++;
+                        }
+                        break;
+                    case AllocationTraceEvent::FREE:
+                        report.numFrees++;
+                        if(pointers[event.id])
+                        {
+                            liveSize -= sizes[event.id];
+                            pointers[event.id] = nullptr;
+                        }
+                        break;
+                    case AllocationTraceEvent::RESET:
+                        report.numResets++;
+                        for(u32 id = 0; id < idRange; ++id)
+                        {
+                            pointers[id] = nullptr;
+                        }
+                        liveSize = 0;
+                        break;
+                }
+
+                const size_t usedSize = allocator.getTotalUsedSize();
+                if(liveSize > report.peakLiveSize)
+                {
+                    report.peakLiveSize = liveSize;
+                }
+                if(usedSize > report.peakUsedSize)
+                {
+                    report.peakUsedSize = usedSize;
+                    report.fragmentation = usedSize >= liveSize ? 1.0f - (f32)liveSize / (f32)usedSize : 0.0f;
+                }
+            }
+
+            report.computeLatencies(latencies);
+        }
+    }
+}
+
+#endif
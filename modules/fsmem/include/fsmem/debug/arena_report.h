@@ -19,6 +19,14 @@ namespace fs
             SharedPtr<AllocationMap> pAllocationMap;
             bool hasStackTrace;
             bool noTracking;
+
+            // Totals of all sub-arenas carved from this arena, recursively.
+            size_t numOfSubArenaAllocations;
+            size_t subArenaAllocated;
+
+            // Reports of sub-arenas carved from this arena form a singly linked list.
+            SharedPtr<ArenaReport> firstSubArena;
+            SharedPtr<ArenaReport> nextSibling;
     };
 }
 
@@ -10,6 +10,9 @@ namespace fs
     namespace memory
     {
         void logArenaReport(const SharedPtr<ArenaReport> report);
+
+        // Log the usage and limits of the global budget and every arena budget.
+        void logMemoryBudgets();
     }
 }
 
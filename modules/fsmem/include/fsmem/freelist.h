@@ -84,10 +84,12 @@ namespace fs
             as_uptr += _slotSize;
 
             // initialize the free list. Each element points to the next free element.
+            // Offsets are stored plus one so that 0 can mark the end of the list even
+            // when a slot begins exactly at start.
             FreelistNode<indexSize>* runner = _next;
             for(size_t i = 1; i < numElements; ++i)
             {
-                runner->offset = as_uptr - (uptr)start;
+                runner->offset = as_uptr - (uptr)start + 1;
                 runner = as_self;
                 as_uptr += _slotSize;
             }
@@ -111,7 +113,7 @@ namespace fs
             }
             else
             {
-                _next = reinterpret_cast<FreelistNode<indexSize>*>(_start + head->offset);
+                _next = reinterpret_cast<FreelistNode<indexSize>*>(_start + head->offset - 1);
             }
 
             return head;
@@ -130,7 +132,7 @@ namespace fs
             FreelistNode<indexSize>* head = static_cast<FreelistNode<indexSize>*>(ptr);
             if(_next)
             {
-                head->offset = (uptr)_next - _start;
+                head->offset = (uptr)_next - _start + 1;
             }
             else
             {
@@ -0,0 +1,114 @@
+#ifndef FS_GLOBAL_NEW_H
+#define FS_GLOBAL_NEW_H
+
+#include <new>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    class IArenaAdapter;
+
+    namespace memory
+    {
+        // Alignment of operator new without an explicit alignment, as for malloc.
+        static const size_t GLOBAL_NEW_ALIGNMENT = 16;
+
+        // Route global operator new and delete into pArena, or back to malloc when
+        // nullptr. Has no effect unless FS_IMPLEMENT_GLOBAL_NEW is expanded in the
+        // executable. Allocations remember the arena they came from and are always freed
+        // to it, so the arena must outlive every allocation made from it.
+        void setGlobalNewArena(IArenaAdapter* pArena);
+        IArenaAdapter* getGlobalNewArena();
+
+        // Return the small blocks cached by the calling thread to their arena. Each thread
+        // flushes its cache when it exits and when it changes the global arena. Other
+        // threads must flush before the arena is checked for leaks or destroyed.
+        void flushGlobalNewCache();
+
+        // Implementation of the replaced operators. Returns nullptr when out of memory.
+        void* globalNew(size_t size, size_t alignment);
+        void globalDelete(void* ptr);
+    }
+
+    // Route global operator new on the calling thread into pArena until the scope exits.
+    // Scopes nest. Small blocks the thread cached for pArena are returned to it when the
+    // scope exits, so pArena only has to outlive the allocations made from it.
+    //
+    //     {
+    //         GlobalNewScope scope(&levelAdapter);
+    //         auto* pParser = new ThirdPartyParser();
+    //     }
+    class GlobalNewScope : Uncopyable
+    {
+    public:
+        explicit GlobalNewScope(IArenaAdapter* pArena);
+        ~GlobalNewScope();
+
+    private:
+        IArenaAdapter* _pArena;
+        IArenaAdapter* _pPrevious;
+    };
+}
+
+#if defined(__cpp_aligned_new)
+#define FS_IMPLEMENT_GLOBAL_NEW_ALIGNED \
+    void* operator new(size_t size, std::align_val_t alignment) \
+    { \
+        void* ptr = fs::memory::globalNew(size, (size_t)alignment); \
+        if(!ptr) throw std::bad_alloc(); \
+        return ptr; \
+    } \
+    void* operator new[](size_t size, std::align_val_t alignment) \
+    { \
+        void* ptr = fs::memory::globalNew(size, (size_t)alignment); \
+        if(!ptr) throw std::bad_alloc(); \
+        return ptr; \
+    } \
+    void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return fs::memory::globalNew(size, (size_t)alignment); } \
+    void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return fs::memory::globalNew(size, (size_t)alignment); } \
+    void operator delete(void* ptr, std::align_val_t) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr, std::align_val_t) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete(void* ptr, size_t, std::align_val_t) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { fs::memory::globalDelete(ptr); }
+#else
+#define FS_IMPLEMENT_GLOBAL_NEW_ALIGNED
+#endif
+
+#if defined(__cpp_sized_deallocation)
+#define FS_IMPLEMENT_GLOBAL_NEW_SIZED \
+    void operator delete(void* ptr, size_t) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr, size_t) noexcept { fs::memory::globalDelete(ptr); }
+#else
+#define FS_IMPLEMENT_GLOBAL_NEW_SIZED
+#endif
+
+// Expand once, at global scope, in a source file of the executable to replace the global
+// operator new and delete. Sized and aligned variants are replaced when the compiler
+// supports them.
+#define FS_IMPLEMENT_GLOBAL_NEW \
+    void* operator new(size_t size) \
+    { \
+        void* ptr = fs::memory::globalNew(size, fs::memory::GLOBAL_NEW_ALIGNMENT); \
+        if(!ptr) throw std::bad_alloc(); \
+        return ptr; \
+    } \
+    void* operator new[](size_t size) \
+    { \
+        void* ptr = fs::memory::globalNew(size, fs::memory::GLOBAL_NEW_ALIGNMENT); \
+        if(!ptr) throw std::bad_alloc(); \
+        return ptr; \
+    } \
+    void* operator new(size_t size, const std::nothrow_t&) noexcept { return fs::memory::globalNew(size, fs::memory::GLOBAL_NEW_ALIGNMENT); } \
+    void* operator new[](size_t size, const std::nothrow_t&) noexcept { return fs::memory::globalNew(size, fs::memory::GLOBAL_NEW_ALIGNMENT); } \
+    void operator delete(void* ptr) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete(void* ptr, const std::nothrow_t&) noexcept { fs::memory::globalDelete(ptr); } \
+    void operator delete[](void* ptr, const std::nothrow_t&) noexcept { fs::memory::globalDelete(ptr); } \
+    FS_IMPLEMENT_GLOBAL_NEW_SIZED \
+    FS_IMPLEMENT_GLOBAL_NEW_ALIGNED
+
+#endif
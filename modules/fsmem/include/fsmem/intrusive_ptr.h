@@ -0,0 +1,192 @@
+#ifndef FS_INTRUSIVE_PTR_H
+#define FS_INTRUSIVE_PTR_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/new.h"
+
+namespace fs
+{
+    template<typename T> class IntrusivePtr;
+
+    // Base for objects shared through IntrusivePtr. The reference count and the arena the
+    // object came from live in the object, so sharing it needs no control block. Objects
+    // created with makeIntrusive are deleted from their arena when the last IntrusivePtr
+    // to them goes away; objects created any other way are never deleted by IntrusivePtr.
+    class RefCounted
+    {
+    public:
+        inline u32 getRefCount() const
+        {
+            return _refCount.load(std::memory_order_relaxed);
+        }
+
+    protected:
+        RefCounted() :
+            _refCount(0),
+            _pDestroy(nullptr),
+            _pArena(nullptr)
+        {
+        }
+
+        // A copy is a new object with no references.
+        RefCounted(const RefCounted&) :
+            RefCounted()
+        {
+        }
+
+        RefCounted& operator=(const RefCounted&)
+        {
+            return *this;
+        }
+
+        ~RefCounted()
+        {
+            FS_ASSERT_MSG(getRefCount() == 0, "Destroying an object that is still referenced.");
+        }
+
+    private:
+        template<typename T> friend class IntrusivePtr;
+        template<typename T, class Arena, typename... Args>
+        friend IntrusivePtr<T> makeIntrusive(Arena* pArena, Args&&... args);
+
+        using DestroyFunction = void(*)(RefCounted*, void*);
+
+        template<typename T, class Arena>
+        static void destroy(RefCounted* pObject, void* pArena)
+        {
+            FS_DELETE(static_cast<T*>(pObject), static_cast<Arena*>(pArena));
+        }
+
+        inline void addRef()
+        {
+            _refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void releaseRef()
+        {
+            if(_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && _pDestroy)
+            {
+                _pDestroy(this, _pArena);
+            }
+        }
+
+        std::atomic<u32> _refCount;
+        DestroyFunction _pDestroy;
+        void* _pArena;
+    };
+
+    // Shared pointer to a RefCounted object. It is the size of a raw pointer and copying
+    // it touches only the object's own count.
+    template<typename T>
+    class IntrusivePtr
+    {
+    public:
+        IntrusivePtr() :
+            _ptr(nullptr)
+        {
+        }
+
+        IntrusivePtr(std::nullptr_t) :
+            _ptr(nullptr)
+        {
+        }
+
+        explicit IntrusivePtr(T* ptr) :
+            _ptr(ptr)
+        {
+            if(_ptr)
+            {
+                _ptr->addRef();
+            }
+        }
+
+        IntrusivePtr(const IntrusivePtr& other) :
+            IntrusivePtr(other._ptr)
+        {
+        }
+
+        IntrusivePtr(IntrusivePtr&& other) :
+            _ptr(other._ptr)
+        {
+            other._ptr = nullptr;
+        }
+
+        template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        IntrusivePtr(const IntrusivePtr<U>& other) :
+            IntrusivePtr(other.get())
+        {
+        }
+
+        template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        IntrusivePtr(IntrusivePtr<U>&& other) :
+            _ptr(other.release())
+        {
+        }
+
+        ~IntrusivePtr()
+        {
+            if(_ptr)
+            {
+                _ptr->releaseRef();
+            }
+        }
+
+        IntrusivePtr& operator=(IntrusivePtr other)
+        {
+            std::swap(_ptr, other._ptr);
+            return *this;
+        }
+
+        inline void reset()
+        {
+            IntrusivePtr().swap(*this);
+        }
+
+        inline void swap(IntrusivePtr& other)
+        {
+            std::swap(_ptr, other._ptr);
+        }
+
+        inline T* get() const { return _ptr; }
+        inline T& operator*() const { FS_ASSERT(_ptr); return *_ptr; }
+        inline T* operator->() const { FS_ASSERT(_ptr); return _ptr; }
+        inline explicit operator bool() const { return _ptr != nullptr; }
+
+        inline bool operator==(const IntrusivePtr& other) const { return _ptr == other._ptr; }
+        inline bool operator!=(const IntrusivePtr& other) const { return _ptr != other._ptr; }
+
+    private:
+        template<typename U> friend class IntrusivePtr;
+
+        // Gives up the reference without releasing it.
+        inline T* release()
+        {
+            T* ptr = _ptr;
+            _ptr = nullptr;
+            return ptr;
+        }
+
+        T* _ptr;
+    };
+
+    template<typename T, class Arena, typename... Args>
+    IntrusivePtr<T> makeIntrusive(Arena* pArena, Args&&... args)
+    {
+        FS_ASSERT(pArena);
+        T* pObject = FS_NEW(T, pArena)(std::forward<Args>(args)...);
+
+        // Through the base so members of T with the same names do not hide them.
+        RefCounted* pRefCounted = pObject;
+        pRefCounted->_pDestroy = &RefCounted::destroy<T, Arena>;
+        pRefCounted->_pArena = pArena;
+        return IntrusivePtr<T>(pObject);
+    }
+}
+
+#endif
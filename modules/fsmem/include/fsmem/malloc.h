@@ -1393,6 +1393,14 @@ DLMALLOC_EXPORT size_t mspace_footprint(mspace msp);
 */
 DLMALLOC_EXPORT size_t mspace_max_footprint(mspace msp);
 
+/*
+  mspace_footprint_limit() returns the number of bytes this space may
+  obtain from the system and mspace_set_footprint_limit() sets it,
+  rounded up to the page granularity. MAX_SIZE_T removes the limit.
+*/
+DLMALLOC_EXPORT size_t mspace_footprint_limit(mspace msp);
+DLMALLOC_EXPORT size_t mspace_set_footprint_limit(mspace msp, size_t bytes);
+
 
 #if !NO_MALLINFO
 /*
@@ -6,15 +6,30 @@
 #include "fscore/types.h"
 #include "fsmem/debug/memory_logging.h"
 #include "fsmem/memory_area.h"
+#include "fsmem/policies/memory_budget_policy.h"
 #include "fsmem/source_info.h"
+#include "fsmem/debug/arena_report.h"
 
 #define FS_SIZE_OF_MB 33554432
 
 namespace fs
 {
-    class ArenaReport;
+    // Node linking a sub-arena into the arena it was carved from so the parent can
+    // include the sub-arena in its ArenaReport. See SubArena.
+    class SubArenaLink
+    {
+    public:
+        virtual SharedPtr<ArenaReport> generateArenaReport() = 0;
 
-    template<class AllocationPolicy, class ThreadPolicy, class BoundsCheckingPolicy, class MemoryTrackingPolicy, class MemoryTaggingPolicy>
+        SubArenaLink* prevSubArena = nullptr;
+        SubArenaLink* nextSubArena = nullptr;
+
+    protected:
+        ~SubArenaLink() {}
+    };
+
+    template<class AllocationPolicy, class ThreadPolicy, class BoundsCheckingPolicy, class MemoryTrackingPolicy, class MemoryTaggingPolicy,
+             class MemoryBudgetPolicy = NoMemoryBudget>
     class MemoryArena
     {
         // Allocation size is used to perfrom BoundsCheckingPolicy::checkBack.
@@ -25,7 +40,8 @@ namespace fs
         MemoryArena(size_t size, const char* name = "UnkownArena") :
             _allocator(size),
             _name(name),
-            _arenaSize(size)
+            _arenaSize(size),
+            _budget(name)
         {
         }
 
@@ -33,43 +49,71 @@ namespace fs
         MemoryArena(const AreaPolicy& area, const char* name = "UnkownArena") :
             _allocator(area.getStart(), area.getEnd()),
             _name(name),
-            _arenaSize((uptr)area.getEnd() - (uptr)area.getStart())
+            _arenaSize((uptr)area.getEnd() - (uptr)area.getStart()),
+            _budget(name)
         {
         }
 
         MemoryArena(const GrowableHeapArea& area, const char* name = "UnkownArena") :
             _allocator(area.getInitialSize(), area.getMaxSize()),
             _name(name),
-            _arenaSize(area.getMaxSize())
+            _arenaSize(area.getMaxSize()),
+            _budget(name)
         {
         }
 
         ~MemoryArena()
         {
+            FS_ASSERT_MSG(_subArenas == nullptr, "Sub-arenas must be destroyed before the arena they were carved from.");
             checkForLeaksAndAssert();
         }
 
         void* allocate(size_t size, size_t alignment, const SourceInfo& sourceInfo)
         {
             // FS_PRINT("allocate " << size << " from " << getName());
-            _threadGuard.enter();
-
             const size_t headerSize = AllocationPolicy::HEADER_SIZE + BoundsCheckingPolicy::SIZE_FRONT;
             const size_t originalSize = size;
             const size_t newSize = size + headerSize + BoundsCheckingPolicy::SIZE_BACK;
 
+            // The budget is charged outside of the lock so that pressure listeners may free
+            // memory back to this arena before an allocation over the hard limit is retried.
+            MemoryBudget::ChargeResult charge = _budget.charge(newSize);
+            if(charge == MemoryBudget::ChargeResult::Exceeded)
+            {
+                _budget.signalPressure();
+                charge = _budget.charge(newSize);
+                if(charge == MemoryBudget::ChargeResult::Exceeded)
+                {
+                    FS_ASSERT_MSG_FORMATTED(false, "Arena '%s' exceeded its memory budget allocating %zu bytes.", getName(), newSize);
+                    return nullptr;
+                }
+            }
+
+            _threadGuard.enter();
+
             char* plainMemory = reinterpret_cast<char*>(_allocator.allocate(newSize, alignment, headerSize));
+            if(!plainMemory)
+            {
+                _threadGuard.leave();
+                _budget.release(newSize);
+                return nullptr;
+            }
 
             _allocator.storeAllocationSize(plainMemory, newSize);
 
             _boundsChecker.guardFront(plainMemory + AllocationPolicy::HEADER_SIZE);
             _memoryTagger.tagAllocation(plainMemory + headerSize, originalSize);
             _boundsChecker.guardBack(plainMemory + headerSize + originalSize);
-            _boundsChecker.checkAll(_memoryTracker);
+            _boundsChecker.checkAll(_memoryTracker, AllocationPolicy::HEADER_SIZE);
 
             _memoryTracker.onAllocation(plainMemory, newSize, alignment, sourceInfo);
 
             _threadGuard.leave();
+
+            if(charge == MemoryBudget::ChargeResult::Pressure)
+            {
+                _budget.signalPressure();
+            }
             // FS_PRINT("allocated " << (void*)(plainMemory + headerSize));
             return (plainMemory + headerSize);
         }
@@ -91,7 +135,17 @@ namespace fs
 
                 // Allocate new memory, copy old memory to new memory, free old memory
                 newPtr = allocate(size, alignment, sourceInfo);
+                if(!newPtr)
+                {
+                    // Like realloc, the original allocation is left untouched.
+                    return nullptr;
+                }
                 memcpy(newPtr, ptr, sizeToCopy);
+
+                _threadGuard.enter();
+                _memoryTracker.onReallocation(originalMemory, reinterpret_cast<char*>(newPtr) - headerSize);
+                _threadGuard.leave();
+
                 free(ptr);
 
                 //_threadGuard.leave();
@@ -110,21 +164,29 @@ namespace fs
 
             _boundsChecker.checkFront(originalMemory + AllocationPolicy::HEADER_SIZE);
             _boundsChecker.checkBack(originalMemory + allocationSize - BoundsCheckingPolicy::SIZE_BACK);
-            _boundsChecker.checkAll(_memoryTracker);
+            _boundsChecker.checkAll(_memoryTracker, AllocationPolicy::HEADER_SIZE);
 
             _memoryTracker.onDeallocation(originalMemory, allocationSize);
             _memoryTagger.tagDeallocation(originalMemory, allocationSize);
 
-            _allocator.free(reinterpret_cast<void*>(originalMemory));
+            _allocator.free(reinterpret_cast<void*>(originalMemory), allocationSize);
 
             _threadGuard.leave();
+
+            // Without a header the size is unknown and the budget is released on reset.
+            if(AllocationPolicy::HEADER_SIZE > 0)
+            {
+                _budget.release(allocationSize);
+            }
         }
 
         inline void reset()
         {
             _threadGuard.enter();
+            FS_ASSERT_MSG(_subArenas == nullptr, "Cannot reset an arena while sub-arenas are carved from it.");
             _allocator.reset();
             _memoryTracker.reset();
+            _budget.release(_budget.getUsedSize());
             _threadGuard.leave();
         }
 
@@ -135,9 +197,58 @@ namespace fs
             _threadGuard.leave();
         }
 
-        inline SharedPtr<ArenaReport> generateArenaReport()
+        // Reports of sub-arenas are nested in the report and their allocations are
+        // rolled up into the sub-arena totals.
+        SharedPtr<ArenaReport> generateArenaReport()
         {
-            return _memoryTracker.generateArenaReport(*this);
+            SharedPtr<ArenaReport> report = _memoryTracker.generateArenaReport(*this);
+
+            _threadGuard.enter();
+            SharedPtr<ArenaReport>* pNext = &report->firstSubArena;
+            for(SubArenaLink* link = _subArenas; link; link = link->nextSubArena)
+            {
+                *pNext = link->generateArenaReport();
+                report->numOfSubArenaAllocations += (*pNext)->numOfAllocations + (*pNext)->numOfSubArenaAllocations;
+                report->subArenaAllocated += (*pNext)->allocated + (*pNext)->subArenaAllocated;
+                pNext = &(*pNext)->nextSibling;
+            }
+            _threadGuard.leave();
+
+            return report;
+        }
+
+        void attachSubArena(SubArenaLink& link)
+        {
+            _threadGuard.enter();
+            link.prevSubArena = nullptr;
+            link.nextSubArena = _subArenas;
+            if(_subArenas)
+            {
+                _subArenas->prevSubArena = &link;
+            }
+            _subArenas = &link;
+            _threadGuard.leave();
+        }
+
+        void detachSubArena(SubArenaLink& link)
+        {
+            _threadGuard.enter();
+            if(link.prevSubArena)
+            {
+                link.prevSubArena->nextSubArena = link.nextSubArena;
+            }
+            else
+            {
+                _subArenas = link.nextSubArena;
+            }
+
+            if(link.nextSubArena)
+            {
+                link.nextSubArena->prevSubArena = link.prevSubArena;
+            }
+            link.prevSubArena = nullptr;
+            link.nextSubArena = nullptr;
+            _threadGuard.leave();
         }
 
         void checkForLeaksAndAssert()
@@ -173,6 +284,19 @@ namespace fs
         // Will return 0 for Arena using the NoMemoryTracking Policy
         inline size_t getAllocatedSize() const { return _memoryTracker.getAllocatedSize(); }
 
+        // Access to policy specific data such as the trace recorded by TraceMemoryTracking.
+        inline const MemoryTrackingPolicy& getMemoryTracker() const { return _memoryTracker; }
+        inline const AllocationPolicy& getAllocator() const { return _allocator; }
+
+        // Direct access to the allocator, such as a HeapAllocator's movable allocations.
+        // Calls made through it bypass the thread, tracking and budget policies.
+        inline AllocationPolicy& getAllocator() { return _allocator; }
+
+        // Limits and usage of the memory this arena takes from its allocator. Only arenas
+        // with the SimpleMemoryBudget policy are budgeted. See MemoryBudget.
+        inline MemoryBudgetPolicy& getBudget() { return _budget; }
+        inline const MemoryBudgetPolicy& getBudget() const { return _budget; }
+
 
     private:
         AllocationPolicy _allocator;
@@ -183,6 +307,8 @@ namespace fs
 
         const char* _name;
         const size_t _arenaSize;
+        SubArenaLink* _subArenas = nullptr;
+        MemoryBudgetPolicy _budget;
     };
 }
 
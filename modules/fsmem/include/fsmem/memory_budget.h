@@ -0,0 +1,107 @@
+#ifndef FS_MEMORY_BUDGET_H
+#define FS_MEMORY_BUDGET_H
+
+#include <atomic>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    class MemoryBudget;
+
+    namespace memory
+    {
+        // The budget all arena budgets are charged to by default. It has no limits until
+        // they are set.
+        MemoryBudget& getGlobalBudget();
+
+        // Visit every live budget except the global budget. Budgets must not be created or
+        // destroyed by the visitor.
+        void visitMemoryBudgets(void (*visitor)(const MemoryBudget& budget, void* pUserData), void* pUserData);
+    }
+
+    // Soft and hard byte limits on the memory an arena takes from its allocator. An arena
+    // with the SimpleMemoryBudget policy owns a budget whose usage is also charged to the
+    // global budget so that many arenas can share a single memory limit instead of each
+    // being provisioned for its worst case.
+    //
+    // Crossing the soft limit signals the pressure callback once so that caches can
+    // evict; it is signalled again after usage drops back to the soft limit and crosses
+    // it again. An allocation that would exceed a hard limit is refused. A limit of 0 is
+    // unlimited.
+    //
+    // Usage is the size requested from the allocator including headers and bounds
+    // checking. Like memory tracking, an arena whose AllocationPolicy has no header can
+    // only return its usage to the budget on reset.
+    class MemoryBudget : Uncopyable
+    {
+    public:
+        using PressureCallback = void (*)(void* pUserData, const MemoryBudget& budget);
+
+        enum class ChargeResult
+        {
+            Charged,
+            Pressure,
+            Exceeded
+        };
+
+        explicit MemoryBudget(const char* name, MemoryBudget* pParent = nullptr);
+        ~MemoryBudget();
+
+        void setLimits(size_t softLimit, size_t hardLimit);
+
+        // Usage is charged to the parent as well. Can only be changed while nothing is
+        // charged to the budget.
+        void setParent(MemoryBudget* pParent);
+
+        void setPressureCallback(PressureCallback callback, void* pUserData);
+
+        // Charge size bytes to this budget and its parents. Nothing is charged if a hard
+        // limit would be exceeded. Pressure is returned when this or a parent budget
+        // crossed its soft limit; call signalPressure once no locks are held. A budget that
+        // refuses a charge is signalled as well so that listeners can free memory before
+        // the charge is retried.
+        ChargeResult charge(size_t size);
+        void release(size_t size);
+
+        // Invoke the pressure callbacks of this budget and its parents that crossed their
+        // soft limit since they were last signalled.
+        void signalPressure();
+
+        inline const char* getName() const { return _name; }
+        inline size_t getUsedSize() const { return _used.load(std::memory_order_relaxed); }
+        inline size_t getPeakSize() const { return _peak.load(std::memory_order_relaxed); }
+        inline size_t getSoftLimit() const { return _softLimit; }
+        inline size_t getHardLimit() const { return _hardLimit; }
+        inline bool isUnderPressure() const { return _underPressure.load(std::memory_order_relaxed); }
+        inline MemoryBudget* getParent() const { return _pParent; }
+
+    private:
+        friend MemoryBudget& memory::getGlobalBudget();
+        friend void memory::visitMemoryBudgets(void (*)(const MemoryBudget&, void*), void*);
+
+        MemoryBudget(const char* name, MemoryBudget* pParent, bool registered);
+
+        bool chargeSelf(size_t size, bool* pPressure);
+        void releaseSelf(size_t size);
+
+        const char* _name;
+        MemoryBudget* _pParent;
+        size_t _softLimit;
+        size_t _hardLimit;
+        std::atomic<size_t> _used;
+        std::atomic<size_t> _peak;
+        std::atomic<bool> _underPressure;
+        std::atomic<bool> _pressurePending;
+        PressureCallback _callback;
+        void* _pUserData;
+
+        // Budgets other than the global budget are registered so that they can be visited.
+        bool _registered;
+        MemoryBudget* _pPrevBudget;
+        MemoryBudget* _pNextBudget;
+    };
+}
+
+#endif
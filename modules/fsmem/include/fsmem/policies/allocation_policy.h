@@ -89,12 +89,18 @@ namespace fs
         }
 
         inline void free(void* ptr) { _allocator.free(ptr); }
+
+        // The arena passes the size read from the header before tagging may overwrite it.
+        inline void free(void* ptr, size_t) { _allocator.free(ptr); }
         inline void reset() { _allocator.reset(); }
         inline void purge() { _allocator.purge(); }
         inline size_t getTotalUsedSize() { return _allocator.getTotalUsedSize(); }
         inline size_t getVirtualSize() const { return _allocator.getVirtualSize(); }
         inline size_t getPhysicalSize() const { return _allocator.getPhysicalSize(); }
 
+        inline Alloc& getBackingAllocator() { return _allocator; }
+        inline const Alloc& getBackingAllocator() const { return _allocator; }
+
     private:
         Alloc _allocator;
         HeaderPolicy _header;
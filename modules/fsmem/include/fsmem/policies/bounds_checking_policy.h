@@ -22,7 +22,7 @@ namespace fs
         inline void checkBack(const void*) const {}
 
         template<class MemoryTrackingPolicy>
-        inline void checkAll(MemoryTrackingPolicy&) {}
+        inline void checkAll(MemoryTrackingPolicy&, size_t) {}
     };
 
     class SimpleBoundsChecking
@@ -51,22 +51,72 @@ namespace fs
             FS_ASSERT(*static_cast<const u32*>(ptr) == BOUNDS_BACK_PATTERN);
         }
 
+        // headerSize is the size of the AllocationPolicy header that precedes the front
+        // guard of each tracked allocation.
         template<class MemoryTrackingPolicy>
-        inline void checkAll(MemoryTrackingPolicy&) {}
+        inline void checkAll(MemoryTrackingPolicy&, size_t) {}
     };
 
-    class ExtendedBoundsChecking : public SimpleBoundsChecking
+    // In addition to the allocation being made or freed, verifies the guards of up to
+    // checksPerCall other live allocations on every call. Each call resumes where the
+    // previous one stopped so every allocation is eventually scrubbed while the cost per
+    // operation stays fixed regardless of how many allocations are live.
+    // Live allocations are found through the allocation map of ExtendedMemoryTracking
+    // or FullMemoryTracking. With other tracking policies checkAll does nothing.
+    template<u32 checksPerCall>
+    class IncrementalBoundsChecking : public SimpleBoundsChecking
     {
     public:
+        IncrementalBoundsChecking() : _cursor(0) {}
+
         template<class MemoryTrackingPolicy>
-        inline void checkAll(MemoryTrackingPolicy& memoryTracker)
+        inline void checkAll(MemoryTrackingPolicy& memoryTracker, size_t headerSize)
         {
-            // TODO: implement checking all allocations instead of just the allocation
-            // being made or freed.
-            (void)memoryTracker;
+            scrub(memoryTracker, headerSize, 0);
         }
+
+    private:
+        template<class MemoryTrackingPolicy>
+        inline auto scrub(MemoryTrackingPolicy& memoryTracker, size_t headerSize, int)
+            -> decltype(memoryTracker.getAllocationMap(), void())
+        {
+            const auto& allocations = *memoryTracker.getAllocationMap();
+            if(allocations.empty())
+            {
+                return;
+            }
+
+            auto iter = allocations.lower_bound(_cursor);
+            const size_t numChecks = allocations.size() < checksPerCall ? allocations.size() : checksPerCall;
+            for(size_t i = 0; i < numChecks; ++i, ++iter)
+            {
+                if(iter == allocations.end())
+                {
+                    iter = allocations.begin();
+                }
+
+                const char* pFront = reinterpret_cast<const char*>(iter->first) + headerSize;
+                const char* pBack = reinterpret_cast<const char*>(iter->first) + iter->second.size - SIZE_BACK;
+
+                FS_ASSERT_MSG_FORMATTED(*reinterpret_cast<const u32*>(pFront) == BOUNDS_FRONT_PATTERN,
+                        "Front guard of allocation %u made at %s:%u was overwritten.",
+                        iter->second.id, iter->second.fileName, iter->second.lineNumber);
+                FS_ASSERT_MSG_FORMATTED(*reinterpret_cast<const u32*>(pBack) == BOUNDS_BACK_PATTERN,
+                        "Back guard of allocation %u made at %s:%u was overwritten.",
+                        iter->second.id, iter->second.fileName, iter->second.lineNumber);
+            }
+
+            _cursor = iter == allocations.end() ? 0 : iter->first;
+        }
+
+        template<class MemoryTrackingPolicy>
+        inline void scrub(MemoryTrackingPolicy&, size_t, long) {}
+
+        uptr _cursor;
     };
 
+    using ExtendedBoundsChecking = IncrementalBoundsChecking<16>;
+
     using DebugBoundsCheckingPolicy = SimpleBoundsChecking;
 }
 
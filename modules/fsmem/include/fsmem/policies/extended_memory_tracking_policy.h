@@ -24,6 +24,7 @@ namespace fs
         ExtendedMemoryTracking();
         void onAllocation(void* ptr, size_t size, size_t alignment, const SourceInfo& info);
         void onDeallocation(void* ptr, size_t size);
+        inline void onReallocation(void*, void*) {}
 
         inline size_t getNumAllocations() const { return _profile.numAllocations; }
         inline size_t getAllocatedSize() const { return _profile.usedSize; }
@@ -0,0 +1,35 @@
+#ifndef FS_MEMORY_BUDGET_POLICY_H
+#define FS_MEMORY_BUDGET_POLICY_H
+
+#include "fscore/types.h"
+#include "fsmem/memory_budget.h"
+
+namespace fs
+{
+    // Arenas are not budgeted by default; every call below compiles away.
+    class NoMemoryBudget
+    {
+    public:
+        explicit NoMemoryBudget(const char*) {}
+
+        inline MemoryBudget::ChargeResult charge(size_t) const { return MemoryBudget::ChargeResult::Charged; }
+        inline void release(size_t) const {}
+        inline void signalPressure() const {}
+        inline void setParent(MemoryBudget*) const {}
+        inline size_t getUsedSize() const { return 0; }
+    };
+
+    // The arena owns a MemoryBudget charged to memory::getGlobalBudget(). Charging is
+    // atomic and shared with every other budgeted arena, so only opt in for arenas that
+    // need limits or pressure events.
+    class SimpleMemoryBudget : public MemoryBudget
+    {
+    public:
+        explicit SimpleMemoryBudget(const char* name) :
+            MemoryBudget(name, &memory::getGlobalBudget())
+        {
+        }
+    };
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "fscore/types.h"
 #include "fscore/assert.h"
+#include "fsmem/utils.h"
 
 namespace fs
 {
@@ -24,35 +25,28 @@ namespace fs
             tagMemory(ptr, size, ALLLOCATED_TAG_PATTERN);
         }
 
+        // Freed memory is usually not touched again soon so large blocks are tagged with
+        // non-temporal stores instead of evicting the cache.
         inline void tagDeallocation(void* ptr, size_t size) const
         {
-            tagMemory(ptr, size, DEALLLOCATED_TAG_PATTERN);
-        }
-
-        inline void tagMemory(void* ptr, size_t size, const u32 pattern) const
-        {
-            union
+            if(size >= NON_TEMPORAL_THRESHOLD)
             {
-                u32* as_u32;
-                char* as_char;
-            };
-
-            char* start = static_cast<char*>(ptr);
-            char* current;
-            for(current = start;  static_cast<size_t>(current - start) + sizeof(u32) <= size; current+=sizeof(u32))
+                patternUtil::fillNonTemporal(ptr, size, DEALLLOCATED_TAG_PATTERN);
+            }
+            else
             {
-                as_char = current;
-                *as_u32 = pattern;
+                tagMemory(ptr, size, DEALLLOCATED_TAG_PATTERN);
             }
+        }
 
-            u32 numBitsToSet = 8 * (size - (current - start));
-            FS_ASSERT(numBitsToSet <= 32);
-
-            // Set the remaing bytes which did not fit into a u32 above.
-            u32 mask = 0xFFFFFFFF >> (32 - numBitsToSet);
-            as_char = current;
-            *as_u32 = (mask & pattern) + (~mask & *as_u32);
+        // Writes exactly size bytes. Nothing past the end of the block is touched or the
+        // next allocation is clobbered.
+        inline void tagMemory(void* ptr, size_t size, const u32 pattern) const
+        {
+            patternUtil::fill(ptr, size, pattern);
         }
+
+        static const size_t NON_TEMPORAL_THRESHOLD = 32 * 1024;
     };
 
     using DebugMemoryTaggingPolicy = MemoryTagging;
@@ -27,6 +27,7 @@ namespace fs
     public:
         inline void onAllocation(void*, size_t, size_t, const SourceInfo&) const {}
         inline void onDeallocation(void*, size_t) const {}
+        inline void onReallocation(void*, void*) const {}
         inline size_t getNumAllocations() const {return 0;}
         inline size_t getAllocatedSize() const {return 0;}
         inline void reset() {}
@@ -59,6 +60,9 @@ namespace fs
             _profile.usedSize -= size;
         }
 
+        // Called while both the original allocation and its replacement are live.
+        inline void onReallocation(void*, void*) {}
+
         inline size_t getNumAllocations() const {return _profile.numAllocations;}
         inline size_t getAllocatedSize() const {return _profile.usedSize;}
 
@@ -0,0 +1,152 @@
+#ifndef FS_QUARANTINE_POLICY_H
+#define FS_QUARANTINE_POLICY_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/utils.h"
+#include "fsmem/policies/memory_tagging_policy.h"
+
+namespace fs
+{
+    // AllocationPolicy that keeps freed blocks in a bounded FIFO instead of returning them
+    // to the backing allocator straight away. Blocks are filled with DEALLLOCATED_TAG_PATTERN
+    // when they enter the quarantine and the pattern is verified when they leave it, so a
+    // write through a dangling pointer asserts and the freed address is not reused while
+    // it is quarantined. The oldest block is released once maxBlocks blocks or maxBytes
+    // bytes are held. A single block larger than maxBytes is held on its own.
+    //
+    // The allocation size must be stored in a header because it is needed after the block
+    // has been poisoned.
+    template<class Alloc, class HeaderPolicy, u32 maxBlocks = 256, size_t maxBytes = 1024 * 1024>
+    class QuarantinedAllocator : Uncopyable
+    {
+        static_assert(HeaderPolicy::SIZE > 0, "QuarantinedAllocator requires a HeaderPolicy that stores the allocation size.");
+        static_assert(maxBlocks > 0, "maxBlocks must be greater than 0.");
+
+    public:
+        static const size_t HEADER_SIZE = HeaderPolicy::SIZE;
+
+        explicit QuarantinedAllocator(size_t size) :
+            _allocator(size)
+        {
+        }
+
+        QuarantinedAllocator(size_t initialSize, size_t maxSize) :
+            _allocator(initialSize, maxSize)
+        {
+        }
+
+        QuarantinedAllocator(void* start, void* end) :
+            _allocator(start, end)
+        {
+        }
+
+        ~QuarantinedAllocator()
+        {
+            flush();
+        }
+
+        inline void storeAllocationSize(void* ptr, size_t size)
+        {
+            _header.storeAllocationSize(ptr, size);
+        }
+
+        inline size_t getAllocationSize(void* ptr)
+        {
+            return _header.getAllocationSize(ptr);
+        }
+
+        inline void* allocate(size_t size, size_t alignment, size_t offset)
+        {
+            return _allocator.allocate(size, alignment, offset);
+        }
+
+        inline void free(void* ptr) { free(ptr, getAllocationSize(ptr)); }
+
+        void free(void* ptr, size_t size)
+        {
+            if(size >= MemoryTagging::NON_TEMPORAL_THRESHOLD)
+            {
+                patternUtil::fillNonTemporal(ptr, size, DEALLLOCATED_TAG_PATTERN);
+            }
+            else
+            {
+                patternUtil::fill(ptr, size, DEALLLOCATED_TAG_PATTERN);
+            }
+
+            while(_numBlocks == maxBlocks || (_numBlocks > 0 && _numBytes + size > maxBytes))
+            {
+                releaseOldest();
+            }
+
+            Block& block = _blocks[(_head + _numBlocks) % maxBlocks];
+            block.ptr = ptr;
+            block.size = size;
+            ++_numBlocks;
+            _numBytes += size;
+        }
+
+        // Verify and release every quarantined block to the backing allocator.
+        void flush()
+        {
+            while(_numBlocks > 0)
+            {
+                releaseOldest();
+            }
+        }
+
+        // Quarantined blocks are discarded without being verified.
+        inline void reset()
+        {
+            _head = 0;
+            _numBlocks = 0;
+            _numBytes = 0;
+            _allocator.reset();
+        }
+
+        inline void purge()
+        {
+            flush();
+            _allocator.purge();
+        }
+
+        // Quarantined blocks are still counted as used.
+        inline size_t getTotalUsedSize() { return _allocator.getTotalUsedSize(); }
+        inline size_t getVirtualSize() const { return _allocator.getVirtualSize(); }
+        inline size_t getPhysicalSize() const { return _allocator.getPhysicalSize(); }
+
+        inline u32 getNumQuarantinedBlocks() const { return _numBlocks; }
+        inline size_t getQuarantinedSize() const { return _numBytes; }
+
+    private:
+        struct Block
+        {
+            void* ptr;
+            size_t size;
+        };
+
+        void releaseOldest()
+        {
+            Block& block = _blocks[_head];
+            const void* mismatch = patternUtil::findMismatch(block.ptr, block.size, DEALLLOCATED_TAG_PATTERN);
+            FS_ASSERT_MSG_FORMATTED(mismatch == nullptr,
+                    "Freed block %p of size %u was written to at offset %u while quarantined.",
+                    block.ptr, (u32)block.size,
+                    mismatch ? (u32)((uptr)mismatch - (uptr)block.ptr) : 0u);
+
+            _allocator.free(block.ptr);
+            _head = (_head + 1) % maxBlocks;
+            --_numBlocks;
+            _numBytes -= block.size;
+        }
+
+        Alloc _allocator;
+        HeaderPolicy _header;
+        Block _blocks[maxBlocks];
+        u32 _head = 0;
+        u32 _numBlocks = 0;
+        size_t _numBytes = 0;
+    };
+}
+
+#endif
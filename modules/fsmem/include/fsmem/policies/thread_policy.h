@@ -2,12 +2,61 @@
 #define FS_THREAD_POLICY_H
 
 #include <mutex>
+#include <atomic>
+#include <thread>
 
 #include "fscore/types.h"
 #include "fscore/assert.h"
+#include "fscore/platforms.h"
 
 namespace fs
 {
+    namespace internal
+    {
+        // Platform specific utils for putting a thread to sleep on an address until
+        // another thread wakes it. On platforms without a native primitive wait yields.
+        template<u32 PlatformID>
+        class ThreadParking
+        {
+        public:
+            // Sleep while *pAddress == expected. May return spuriously.
+            static void wait(std::atomic<u32>* pAddress, u32 expected);
+            static void wakeOne(std::atomic<u32>* pAddress);
+        };
+
+        // Exponential backoff for spin loops. Pauses the cpu for a growing number of
+        // iterations and falls back to yielding the thread once yieldThreshold is reached.
+        template<u32 yieldThreshold = 10>
+        class SpinWait
+        {
+        public:
+            SpinWait() : _count(0) {}
+
+            inline void spinOnce()
+            {
+                if(_count < yieldThreshold)
+                {
+                    for(u32 i = 0; i < (1u << _count); ++i)
+                    {
+                        _mm_pause();
+                    }
+                    ++_count;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            inline void reset() { _count = 0; }
+
+        private:
+            u32 _count;
+        };
+    }
+
+    using ThreadParking = internal::ThreadParking<PLATFORM_ID>;
+
     class MutexPrimitive
     {
     public:
@@ -25,6 +74,157 @@ namespace fs
         std::mutex _mutex;
     };
 
+    // Spins for up to spinCount attempts before parking the thread.
+    // Uncontended enter/leave is a single atomic operation and leave only makes a
+    // system call when another thread is parked. Well suited for the short critical
+    // sections of MemoryArena.
+    template<u32 spinCount = 128>
+    class SpinThenParkPrimitive
+    {
+    public:
+        SpinThenParkPrimitive() : _state(UNLOCKED) {}
+
+        void enter()
+        {
+            // Always make at least one attempt so spinCount == 0 keeps the uncontended fast path.
+            for(u32 i = 0; ; ++i)
+            {
+                u32 expected = UNLOCKED;
+                if(_state.load(std::memory_order_relaxed) == UNLOCKED &&
+                   _state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return;
+                }
+                if(i >= spinCount)
+                {
+                    break;
+                }
+                _mm_pause();
+            }
+
+            // Mark the lock as contended so that leave will wake us.
+            while(_state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED)
+            {
+                ThreadParking::wait(&_state, CONTENDED);
+            }
+        }
+
+        void leave()
+        {
+            if(_state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+            {
+                ThreadParking::wakeOne(&_state);
+            }
+        }
+
+    private:
+        static const u32 UNLOCKED = 0;
+        static const u32 LOCKED = 1;
+        static const u32 CONTENDED = 2;
+
+        std::atomic<u32> _state;
+    };
+
+    // FIFO spin lock. Threads are served in the order they called enter so no thread
+    // can starve. Spinning is proportional to the distance from the ticket being served.
+    // Performs poorly when there are more waiting threads than cores because a
+    // preempted thread blocks every ticket queued behind it.
+    class TicketPrimitive
+    {
+    public:
+        TicketPrimitive() : _nextTicket(0), _nowServing(0) {}
+
+        void enter()
+        {
+            const u32 ticket = _nextTicket.fetch_add(1, std::memory_order_relaxed);
+            internal::SpinWait<> spinWait;
+
+            u32 serving;
+            while((serving = _nowServing.load(std::memory_order_acquire)) != ticket)
+            {
+                for(u32 i = 0; i < ticket - serving; ++i)
+                {
+                    spinWait.spinOnce();
+                }
+            }
+        }
+
+        void leave()
+        {
+            _nowServing.store(_nowServing.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<u32> _nextTicket;
+        std::atomic<u32> _nowServing;
+    };
+
+    // Spinning reader-writer lock with writer preference. enter and leave take the lock
+    // exclusively so it can be used anywhere a SynchronizationPrimitive is expected;
+    // enterShared and leaveShared allow any number of concurrent readers.
+    class ReaderWriterPrimitive
+    {
+    public:
+        ReaderWriterPrimitive() : _state(0) {}
+
+        void enter()
+        {
+            internal::SpinWait<> spinWait;
+            for(;;)
+            {
+                u32 state = _state.load(std::memory_order_relaxed);
+                if((state & ~WRITER_PENDING) == 0)
+                {
+                    // Acquiring clears the pending bit. Other waiting writers will set it again.
+                    if(_state.compare_exchange_weak(state, WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                }
+                else if((state & WRITER_PENDING) == 0)
+                {
+                    // Block new readers from entering while we wait.
+                    _state.fetch_or(WRITER_PENDING, std::memory_order_relaxed);
+                }
+                spinWait.spinOnce();
+            }
+        }
+
+        void leave()
+        {
+            FS_ASSERT(_state.load(std::memory_order_relaxed) & WRITER);
+            _state.fetch_sub(WRITER, std::memory_order_release);
+        }
+
+        void enterShared()
+        {
+            internal::SpinWait<> spinWait;
+            for(;;)
+            {
+                u32 state = _state.load(std::memory_order_relaxed);
+                if((state & (WRITER | WRITER_PENDING)) == 0 &&
+                   _state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return;
+                }
+                spinWait.spinOnce();
+            }
+        }
+
+        void leaveShared()
+        {
+            FS_ASSERT((_state.load(std::memory_order_relaxed) & READER_MASK) > 0);
+            _state.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        static const u32 WRITER = 1u << 31;
+        static const u32 WRITER_PENDING = 1u << 30;
+        static const u32 READER_MASK = WRITER_PENDING - 1;
+
+        std::atomic<u32> _state;
+    };
+
     class SingleThread
     {
     public:
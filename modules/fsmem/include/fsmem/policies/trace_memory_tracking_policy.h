@@ -0,0 +1,43 @@
+#ifndef FS_TRACE_MEMORY_TRACKING_POLICY_H
+#define FS_TRACE_MEMORY_TRACKING_POLICY_H
+
+#include <chrono>
+#include <thread>
+
+#include "fsmem/debug/memory.h"
+#include "fscore/types.h"
+#include "fsmem/stl_types.h"
+#include "fsmem/debug/allocation_trace.h"
+
+namespace fs
+{
+    // Records every allocation, free, reallocation and reset made through an arena into
+    // an AllocationTrace. The trace can be saved and later replayed against any
+    // allocator with memory::replayTrace. Sizes and alignments are those requested from
+    // the arena's AllocationPolicy so headers and guards are included.
+    class TraceMemoryTracking : public SimpleMemoryTracking
+    {
+    public:
+        TraceMemoryTracking();
+        void onAllocation(void* ptr, size_t size, size_t alignment, const SourceInfo& info);
+        void onDeallocation(void* ptr, size_t size);
+        void onReallocation(void* ptr, void* newPtr);
+        void reset();
+
+        inline const AllocationTrace& getTrace() const { return _trace; }
+        inline AllocationTrace& getTrace() { return _trace; }
+
+    protected:
+        u64 now() const;
+        u16 getThreadIndex();
+
+        AllocationTrace _trace;
+        // Address of each live allocation to the index of the event that allocated it.
+        DebugMap<uptr, u32> _liveAllocations;
+        DebugMap<std::thread::id, u16> _threads;
+        std::chrono::steady_clock::time_point _start;
+        u32 _nextId;
+    };
+}
+
+#endif
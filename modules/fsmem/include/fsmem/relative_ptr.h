@@ -0,0 +1,78 @@
+#ifndef FS_RELATIVE_PTR_H
+#define FS_RELATIVE_PTR_H
+
+#include <limits>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+
+namespace fs
+{
+    // Pointer stored as an offset from its own address. Data structures that only point
+    // within the same block of memory through RelativePtr stay valid when the block is
+    // copied or mapped at a different address, such as an arena image loaded from disk.
+    // The offset 0 is reserved for nullptr so a RelativePtr cannot point to itself.
+    template<class T, class OffsetType = i32>
+    class RelativePtr
+    {
+    public:
+        RelativePtr() :
+            _offset(0)
+        {
+        }
+
+        RelativePtr(T* ptr)
+        {
+            set(ptr);
+        }
+
+        // The offset is recalculated for the new location.
+        RelativePtr(const RelativePtr& other)
+        {
+            set(other.get());
+        }
+
+        inline RelativePtr& operator=(const RelativePtr& other)
+        {
+            set(other.get());
+            return *this;
+        }
+
+        inline RelativePtr& operator=(T* ptr)
+        {
+            set(ptr);
+            return *this;
+        }
+
+        inline T* get() const
+        {
+            return _offset == 0 ? nullptr : reinterpret_cast<T*>((uptr)this + (intptr_t)_offset);
+        }
+
+        inline void set(T* ptr)
+        {
+            if(!ptr)
+            {
+                _offset = 0;
+                return;
+            }
+
+            const intptr_t offset = (intptr_t)((uptr)ptr - (uptr)this);
+            FS_ASSERT_MSG(offset != 0, "RelativePtr cannot point to itself.");
+            FS_ASSERT_MSG(offset >= (intptr_t)std::numeric_limits<OffsetType>::min() &&
+                          offset <= (intptr_t)std::numeric_limits<OffsetType>::max(),
+                          "RelativePtr offset does not fit in OffsetType.");
+            _offset = (OffsetType)offset;
+        }
+
+        inline T* operator->() const { return get(); }
+        inline T& operator*() const { return *get(); }
+        inline T& operator[](size_t index) const { return get()[index]; }
+        inline explicit operator bool() const { return _offset != 0; }
+
+    private:
+        OffsetType _offset;
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef FS_SCRATCH_ARENA_H
+#define FS_SCRATCH_ARENA_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/source_info.h"
+#include "fsmem/allocators/stack_allocator.h"
+
+namespace fs
+{
+    // Growable stack of temporary memory owned by a single thread. Individual frees are
+    // ignored; memory is reclaimed when the ScratchScope that made the allocation exits.
+    // Get the calling thread's scratch arenas through ScratchScope.
+    class ScratchArena : Uncopyable
+    {
+    public:
+        using Marker = StackAllocatorBottomGrowable::Marker;
+
+        ScratchArena(size_t initialSize, size_t maxSize, const char* name = "ScratchArena");
+
+        inline void* allocate(size_t size, size_t alignment, const SourceInfo&)
+        {
+            return _stack.allocate(size, alignment, 0);
+        }
+
+        inline void free(void*) {}
+
+        inline Marker getMarker() const { return _stack.getMarker(); }
+        inline void rewind(const Marker& marker) { _stack.freeToMarker(marker); }
+
+        // Release physical memory above the current top of the stack.
+        inline void purge() { _stack.purge(); }
+
+        inline const char* getName() const { return _name; }
+        inline size_t getTotalUsedSize() const { return _stack.getTotalUsedSize(); }
+        inline size_t getVirtualSize() const { return _stack.getVirtualSize(); }
+        inline size_t getPhysicalSize() const { return _stack.getPhysicalSize(); }
+        inline u32 getNumScopes() const { return _numScopes; }
+
+    private:
+        friend class ScratchScope;
+
+        StackAllocatorBottomGrowable _stack;
+        const char* _name;
+        u32 _numScopes;
+    };
+
+    // Rewinds a per-thread scratch arena to where it was when the scope was entered.
+    // Each thread owns two scratch arenas. A function that returns results in an arena
+    // given to it by its caller passes that arena as the conflict so its own scratch
+    // memory comes from the other one and rewinding does not free the results:
+    //
+    //     fs::string<ScratchArena> join(ScratchArena& result, ...)
+    //     {
+    //         ScratchScope scratch(&result);
+    //         // temporaries in scratch.getArena(), output in result
+    //     }
+    //
+    // Scopes on the same arena must exit in reverse order of entering.
+    class ScratchScope : Uncopyable
+    {
+    public:
+        explicit ScratchScope(const ScratchArena* pConflict = nullptr);
+        ~ScratchScope();
+
+        inline ScratchArena& getArena() { return *_pArena; }
+
+        inline void* allocate(size_t size, size_t alignment = 16)
+        {
+            return _pArena->allocate(size, alignment, FS_SOURCE_INFO);
+        }
+
+    private:
+        ScratchArena* _pArena;
+        ScratchArena::Marker _marker;
+        u32 _depth;
+    };
+
+    namespace memory
+    {
+        // One of the calling thread's scratch arenas that is not pConflict. The arenas
+        // are created on first use and destroyed when the thread exits.
+        ScratchArena& getScratchArena(const ScratchArena* pConflict = nullptr);
+    }
+}
+
+#endif
@@ -60,36 +60,54 @@ namespace fs
     using dformat = boost::basic_format<char, std::char_traits<char>, DebugStlAllocator<char>>;
     using dwformat = boost::basic_format<wchar_t, std::char_traits<wchar_t>, DebugStlAllocator<wchar_t>>;
 
+    // A string paired with its 32 bit FNV-1a hash. The hash of a string literal is
+    // computed at compile time. Only the pointer is stored so the string must outlive the
+    // HashedString; use StringTable to get a copy that lives as long as the program.
     class HashedString
     {
     public:
-        explicit HashedString(const char* const pString) :
+        constexpr explicit HashedString(const char* const pString) :
             _hash(hashName(pString)),
-            _string(pString)
+            _pString(pString)
         {
         }
 
-        size_t getHashValue() const
+        constexpr u32 getHashValue() const
         {
             return _hash;
         }
 
-        const std::string& getString() const
+        constexpr const char* getString() const
         {
-            return _string;
+            return _pString;
         }
 
-        static size_t hashName(const char* pString);
+        static constexpr u32 hashName(const char* pString, u32 hash = FNV_OFFSET_BASIS)
+        {
+            return *pString ? hashName(pString + 1, (hash ^ (u8)*pString) * FNV_PRIME) : hash;
+        }
+
+        constexpr bool operator< (const HashedString& other) const
+        {
+            return getHashValue() < other.getHashValue();
+        }
 
-        bool operator< (const HashedString& other) const
+        constexpr bool operator== (const HashedString& other) const
         {
-            bool r = (getHashValue() < other.getHashValue());
-            return r;
+            return getHashValue() == other.getHashValue();
+        }
+
+        constexpr bool operator!= (const HashedString& other) const
+        {
+            return getHashValue() != other.getHashValue();
         }
 
     private:
-        size_t _hash;
-        std::string _string;
+        static const u32 FNV_OFFSET_BASIS = 2166136261u;
+        static const u32 FNV_PRIME = 16777619u;
+
+        u32 _hash;
+        const char* _pString;
     };
 
     struct CompareCString
@@ -0,0 +1,61 @@
+#ifndef FS_STRING_TABLE_H
+#define FS_STRING_TABLE_H
+
+#include <mutex>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/adapter.h"
+#include "fsmem/stl_types.h"
+#include "fsmem/containers/hash_map.h"
+
+namespace fs
+{
+    // Stores each unique string once and identifies it by a 32 bit id. The id of a string
+    // is its HashedString hash, so the id of a literal is known at compile time and
+    // containers keyed by id can be searched without interning or comparing strings.
+    // Interning a different string with the id of one already in the table asserts.
+    //
+    // Strings are copied into the arena and live until the table is destroyed.
+    class StringTable : Uncopyable
+    {
+    public:
+        explicit StringTable(IArenaAdapter* pArena);
+        ~StringTable();
+
+        // Returns the id of the string, copying it into the table if it is not there yet.
+        u32 intern(const char* pString);
+        u32 intern(const HashedString& string);
+
+        // Returns the table's copy of the string with the given id or nullptr if no string
+        // with that id has been interned.
+        const char* lookup(u32 id) const;
+
+        size_t getNumStrings() const;
+
+    private:
+        using Strings = HashMap<u32, const char*, IArenaAdapter>;
+
+        IArenaAdapter* _pArena;
+        mutable std::mutex _mutex;
+        Strings _strings;
+    };
+
+    namespace memory
+    {
+        // Table shared by the engine, backed by its own arena.
+        StringTable& getStringTable();
+
+        inline u32 internString(const char* pString)
+        {
+            return getStringTable().intern(pString);
+        }
+
+        inline const char* getInternedString(u32 id)
+        {
+            return getStringTable().lookup(id);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef FS_SUB_ARENA_H
+#define FS_SUB_ARENA_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/memory_arena.h"
+#include "fsmem/source_info.h"
+
+namespace fs
+{
+    // Area carved out of a parent arena with a single allocation and returned to it on
+    // destruction. Can be passed to any MemoryArena constructor that takes an area.
+    class SubArenaArea : Uncopyable
+    {
+    public:
+        template<class ParentArena>
+        SubArenaArea(ParentArena& parent, size_t size, size_t alignment, const SourceInfo& sourceInfo) :
+            _parent(&parent),
+            _free(&freeFromParent<ParentArena>)
+        {
+            _start = parent.allocate(size, alignment, sourceInfo);
+            FS_ASSERT_MSG(_start, "Failed to carve sub-arena area from parent arena.");
+            _end = reinterpret_cast<void*>((uptr)_start + size);
+        }
+
+        ~SubArenaArea()
+        {
+            if(_start)
+            {
+                _free(_parent, _start);
+            }
+        }
+
+        inline void* getStart() const {return _start;}
+        inline void* getEnd() const {return _end;}
+
+    private:
+        template<class ParentArena>
+        static void freeFromParent(void* parent, void* ptr)
+        {
+            static_cast<ParentArena*>(parent)->free(ptr);
+        }
+
+        void* _parent;
+        void (*_free)(void*, void*);
+        void* _start;
+        void* _end;
+    };
+
+    // A child arena whose memory is carved from a parent arena. The child is attached to
+    // the parent so its report is nested in the parent's ArenaReport, and its memory is
+    // returned to the parent when it is destroyed. With a LinearAllocator or
+    // StackAllocator the whole child is reset in O(1):
+    //
+    //     using LevelArena = MemoryArena<Allocator<LinearAllocator, NoAllocationHeader>, ...>;
+    //     SubArena<LevelArena> level(gameArena, 16 * 1024 * 1024, "Level");
+    //     void* ptr = level->allocate(...);
+    //     level->reset();
+    //
+    // The parent must outlive the child and cannot be reset while children exist.
+    template<class Arena>
+    class SubArena : public SubArenaLink, Uncopyable
+    {
+    public:
+        template<class ParentArena>
+        SubArena(ParentArena& parent, size_t size, const char* name = "UnkownSubArena", size_t alignment = 16) :
+            _area(parent, size, alignment, FS_SOURCE_INFO),
+            _arena(_area, name),
+            _parent(&parent),
+            _detach(&detachFromParent<ParentArena>)
+        {
+            // The area is already charged to the budget of the parent.
+            _arena.getBudget().setParent(nullptr);
+            parent.attachSubArena(*this);
+        }
+
+        ~SubArena()
+        {
+            _detach(_parent, *this);
+        }
+
+        inline Arena& get() { return _arena; }
+        inline const Arena& get() const { return _arena; }
+        inline Arena* operator->() { return &_arena; }
+        inline const Arena* operator->() const { return &_arena; }
+
+        virtual SharedPtr<ArenaReport> generateArenaReport() override
+        {
+            return _arena.generateArenaReport();
+        }
+
+    private:
+        template<class ParentArena>
+        static void detachFromParent(void* parent, SubArenaLink& link)
+        {
+            static_cast<ParentArena*>(parent)->detachSubArena(link);
+        }
+
+        // Declaration order matters: the arena is destroyed, and checked for leaks,
+        // before its area is returned to the parent.
+        SubArenaArea _area;
+        Arena _arena;
+        void* _parent;
+        void (*_detach)(void*, SubArenaLink&);
+    };
+}
+
+#endif
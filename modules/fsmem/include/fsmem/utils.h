@@ -11,6 +11,9 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 
+#include <emmintrin.h>
+#include <atomic>
+#include <thread>
 #include <boost/format.hpp>
 
 #include "fscore/types.h"
@@ -37,6 +40,27 @@ namespace fs
         // Round value up to the neares multiple.
         // multiple must be a non zero power of 2.
         inline size_t roundUpToMultiple(size_t value, size_t multiple);
+
+        inline bool isPowerOfTwo(size_t value);
+
+        // Index of the highest set bit. value must be non zero.
+        inline u32 log2(size_t value);
+    }
+
+    namespace patternUtil
+    {
+        // Fill exactly size bytes at ptr with a repeating 32 bit pattern. The pattern is
+        // laid out from ptr regardless of its alignment. The aligned body of the block is
+        // written 16 bytes at a time.
+        inline void fill(void* ptr, size_t size, u32 pattern);
+
+        // Same as fill but the aligned body is written with non-temporal stores which
+        // bypass the cache. Use for large blocks that will not be read again soon.
+        inline void fillNonTemporal(void* ptr, size_t size, u32 pattern);
+
+        // Address of the first byte in the block that does not match the pattern written
+        // by fill or nullptr if the whole block matches.
+        inline const void* findMismatch(const void* ptr, size_t size, u32 pattern);
     }
 
     namespace internal
@@ -53,10 +77,84 @@ namespace fs
             static void* allocatePhysicalMemory(size_t);
             static void freePhysicalMemory(void* ptr, size_t size);
             static void releaseAddressSpace(void* ptr, size_t size);
+
+            // Map the same size bytes of physical memory at two adjacent address ranges so
+            // that ptr[i] and ptr[i + size] alias. size must be a multiple of the page size.
+            static void* allocateMirroredMemory(size_t size);
+            static void freeMirroredMemory(void* ptr, size_t size);
         };
     }
 
     using VirtualMemory = internal::VirtualMemory<PLATFORM_ID>;
+
+    // Producer policies for VirtualRingBuffer.
+    class SingleProducer
+    {
+    public:
+        static inline bool reserve(std::atomic<u64>& reserved, u64 read, size_t size, size_t capacity, u64& position);
+        static inline void publish(std::atomic<u64>& committed, u64 position, size_t size);
+    };
+
+    // Producers reserve space with a CAS and publish in reservation order, so a producer
+    // waits for producers that reserved before it to commit.
+    class MultiProducer
+    {
+    public:
+        static inline bool reserve(std::atomic<u64>& reserved, u64 read, size_t size, size_t capacity, u64& position);
+        static inline void publish(std::atomic<u64>& committed, u64 position, size_t size);
+    };
+
+    // Byte ring buffer for a single consumer backed by mirrored virtual memory. Any range
+    // of up to getCapacity() bytes is contiguous in memory, so reads and writes are never
+    // split into two copies at the wrap around point. Positions are 64 bit counters that
+    // never wrap.
+    template<class ProducerPolicy>
+    class VirtualRingBuffer : Uncopyable
+    {
+    public:
+        struct Reservation
+        {
+            u8* data;
+            u64 position;
+            size_t size;
+        };
+
+        // size is rounded up to a power of two multiple of the page size.
+        explicit VirtualRingBuffer(size_t size);
+        ~VirtualRingBuffer();
+
+        // Reserve size contiguous bytes for writing. data is nullptr when there is not
+        // enough free space. The bytes become visible to the consumer on commitWrite.
+        inline Reservation beginWrite(size_t size);
+        inline void commitWrite(const Reservation& reservation);
+
+        // Consumer only. Returns the committed bytes which are all contiguous from the
+        // returned pointer. Release them with commitRead once they are consumed.
+        inline const u8* beginRead(size_t& size) const;
+        inline void commitRead(size_t size);
+
+        // Copy size bytes in as one block. Returns false when there is not enough space.
+        inline bool write(const void* data, size_t size);
+
+        // Copy up to size committed bytes out. Returns the number of bytes read.
+        inline size_t read(void* data, size_t size);
+
+        inline size_t getCapacity() const { return _capacity; }
+        inline size_t getSize() const { return (size_t)(_committed.load(std::memory_order_acquire) - _read.load(std::memory_order_relaxed)); }
+
+    private:
+        // Producer and consumer cursors live on separate cache lines.
+        static const size_t CACHE_LINE_SIZE = 64;
+
+        u8* _data;
+        size_t _capacity;
+        u8 _padding0[CACHE_LINE_SIZE - sizeof(u8*) - sizeof(size_t)];
+        std::atomic<u64> _reserved;
+        u8 _padding1[CACHE_LINE_SIZE - sizeof(std::atomic<u64>)];
+        std::atomic<u64> _committed;
+        u8 _padding2[CACHE_LINE_SIZE - sizeof(std::atomic<u64>)];
+        std::atomic<u64> _read;
+    };
 }
 
 #include "fsmem/utils.inl"
@@ -4,6 +4,8 @@
 #include "fsmem/utils.h"
 #include "fscore/assert.h"
 
+#include <string.h>
+
 #ifndef MAP_ANONYMOUS
 #  define MAP_ANONYMOUS MAP_ANON
 #endif
@@ -40,6 +42,278 @@ namespace fs
         {
             return (value + multiple - 1) & ~(multiple - 1);
         }
+
+        bool isPowerOfTwo(size_t value)
+        {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+
+        u32 log2(size_t value)
+        {
+            FS_ASSERT(value != 0);
+            return (u32)(sizeof(unsigned long long) * 8 - 1) - (u32)__builtin_clzll((unsigned long long)value);
+        }
+    }
+
+    namespace patternUtil
+    {
+        namespace internal
+        {
+            // The pattern as read by a u32 load offset bytes into the block.
+            inline u32 rotatePattern(u32 pattern, size_t offset)
+            {
+                const u32 shift = 8 * (offset & 3);
+                return shift == 0 ? pattern : (pattern >> shift) | (pattern << (32 - shift));
+            }
+
+            inline u8 patternByte(u32 pattern, size_t offset)
+            {
+                return static_cast<u8>(pattern >> (8 * (offset & 3)));
+            }
+
+            template<bool nonTemporal>
+            inline void fill(void* ptr, size_t size, u32 pattern)
+            {
+                u8* const start = static_cast<u8*>(ptr);
+                u8* const end = start + size;
+                u8* current = start;
+
+                u8* alignedStart = reinterpret_cast<u8*>(pointerUtil::alignTop(reinterpret_cast<uptr>(start), 16));
+                if(alignedStart > end)
+                {
+                    alignedStart = end;
+                }
+                for(; current < alignedStart; ++current)
+                {
+                    *current = patternByte(pattern, current - start);
+                }
+
+                const __m128i value = _mm_set1_epi32(static_cast<int>(rotatePattern(pattern, current - start)));
+                u8* const alignedEnd = current + ((end - current) & ~static_cast<ptrdiff_t>(15));
+                for(; current < alignedEnd; current += 16)
+                {
+                    if(nonTemporal)
+                    {
+                        _mm_stream_si128(reinterpret_cast<__m128i*>(current), value);
+                    }
+                    else
+                    {
+                        _mm_store_si128(reinterpret_cast<__m128i*>(current), value);
+                    }
+                }
+                if(nonTemporal)
+                {
+                    _mm_sfence();
+                }
+
+                for(; current < end; ++current)
+                {
+                    *current = patternByte(pattern, current - start);
+                }
+            }
+        }
+
+        void fill(void* ptr, size_t size, u32 pattern)
+        {
+            internal::fill<false>(ptr, size, pattern);
+        }
+
+        void fillNonTemporal(void* ptr, size_t size, u32 pattern)
+        {
+            internal::fill<true>(ptr, size, pattern);
+        }
+
+        const void* findMismatch(const void* ptr, size_t size, u32 pattern)
+        {
+            const u8* const start = static_cast<const u8*>(ptr);
+            const u8* const end = start + size;
+            const u8* current = start;
+
+            const u8* alignedStart = reinterpret_cast<const u8*>(pointerUtil::alignTop(reinterpret_cast<uptr>(start), 16));
+            if(alignedStart > end)
+            {
+                alignedStart = end;
+            }
+            for(; current < alignedStart; ++current)
+            {
+                if(*current != internal::patternByte(pattern, current - start))
+                {
+                    return current;
+                }
+            }
+
+            const __m128i value = _mm_set1_epi32(static_cast<int>(internal::rotatePattern(pattern, current - start)));
+
+            // Compare 64 bytes per iteration and only look for the exact byte once a
+            // mismatch is known to be in the chunk.
+            const u8* const alignedEnd64 = current + ((end - current) & ~static_cast<ptrdiff_t>(63));
+            for(; current < alignedEnd64; current += 64)
+            {
+                const __m128i* chunk = reinterpret_cast<const __m128i*>(current);
+                __m128i equal = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128(chunk), value),
+                                              _mm_cmpeq_epi8(_mm_load_si128(chunk + 1), value));
+                equal = _mm_and_si128(equal, _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128(chunk + 2), value),
+                                                           _mm_cmpeq_epi8(_mm_load_si128(chunk + 3), value)));
+                if(_mm_movemask_epi8(equal) != 0xFFFF)
+                {
+                    break;
+                }
+            }
+
+            const u8* const alignedEnd = current + ((end - current) & ~static_cast<ptrdiff_t>(15));
+            for(; current < alignedEnd; current += 16)
+            {
+                const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(current)), value));
+                if(mask != 0xFFFF)
+                {
+                    return current + __builtin_ctz(~mask);
+                }
+            }
+
+            for(; current < end; ++current)
+            {
+                if(*current != internal::patternByte(pattern, current - start))
+                {
+                    return current;
+                }
+            }
+
+            return nullptr;
+        }
+    }
+
+    bool SingleProducer::reserve(std::atomic<u64>& reserved, u64 read, size_t size, size_t capacity, u64& position)
+    {
+        position = reserved.load(std::memory_order_relaxed);
+        if(position + size - read > capacity)
+        {
+            return false;
+        }
+        reserved.store(position + size, std::memory_order_relaxed);
+        return true;
+    }
+
+    void SingleProducer::publish(std::atomic<u64>& committed, u64 position, size_t size)
+    {
+        committed.store(position + size, std::memory_order_release);
+    }
+
+    bool MultiProducer::reserve(std::atomic<u64>& reserved, u64 read, size_t size, size_t capacity, u64& position)
+    {
+        position = reserved.load(std::memory_order_relaxed);
+        do
+        {
+            if(position + size - read > capacity)
+            {
+                return false;
+            }
+        }
+        while(!reserved.compare_exchange_weak(position, position + size, std::memory_order_relaxed));
+        return true;
+    }
+
+    void MultiProducer::publish(std::atomic<u64>& committed, u64 position, size_t size)
+    {
+        // Yield once the wait is long enough that the earlier producer was likely preempted.
+        for(u32 spins = 0; committed.load(std::memory_order_acquire) != position; ++spins)
+        {
+            if(spins < 64)
+            {
+                _mm_pause();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        committed.store(position + size, std::memory_order_release);
+    }
+
+    template<class ProducerPolicy>
+    VirtualRingBuffer<ProducerPolicy>::VirtualRingBuffer(size_t size) :
+        _reserved(0),
+        _committed(0),
+        _read(0)
+    {
+        _capacity = VirtualMemory::getPageSize();
+        while(_capacity < size)
+        {
+            _capacity *= 2;
+        }
+
+        _data = static_cast<u8*>(VirtualMemory::allocateMirroredMemory(_capacity));
+        FS_ASSERT_MSG(_data, "Failed to map memory for VirtualRingBuffer.");
+    }
+
+    template<class ProducerPolicy>
+    VirtualRingBuffer<ProducerPolicy>::~VirtualRingBuffer()
+    {
+        if(_data)
+        {
+            VirtualMemory::freeMirroredMemory(_data, _capacity);
+        }
+    }
+
+    template<class ProducerPolicy>
+    typename VirtualRingBuffer<ProducerPolicy>::Reservation VirtualRingBuffer<ProducerPolicy>::beginWrite(size_t size)
+    {
+        Reservation reservation;
+        reservation.size = size;
+        if(ProducerPolicy::reserve(_reserved, _read.load(std::memory_order_acquire), size, _capacity, reservation.position))
+        {
+            reservation.data = _data + (reservation.position & (_capacity - 1));
+        }
+        else
+        {
+            reservation.data = nullptr;
+        }
+        return reservation;
+    }
+
+    template<class ProducerPolicy>
+    void VirtualRingBuffer<ProducerPolicy>::commitWrite(const Reservation& reservation)
+    {
+        FS_ASSERT(reservation.data);
+        ProducerPolicy::publish(_committed, reservation.position, reservation.size);
+    }
+
+    template<class ProducerPolicy>
+    const u8* VirtualRingBuffer<ProducerPolicy>::beginRead(size_t& size) const
+    {
+        const u64 read = _read.load(std::memory_order_relaxed);
+        size = (size_t)(_committed.load(std::memory_order_acquire) - read);
+        return _data + (read & (_capacity - 1));
+    }
+
+    template<class ProducerPolicy>
+    void VirtualRingBuffer<ProducerPolicy>::commitRead(size_t size)
+    {
+        FS_ASSERT(size <= getSize());
+        _read.store(_read.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    }
+
+    template<class ProducerPolicy>
+    bool VirtualRingBuffer<ProducerPolicy>::write(const void* data, size_t size)
+    {
+        Reservation reservation = beginWrite(size);
+        if(!reservation.data)
+        {
+            return false;
+        }
+        memcpy(reservation.data, data, size);
+        commitWrite(reservation);
+        return true;
+    }
+
+    template<class ProducerPolicy>
+    size_t VirtualRingBuffer<ProducerPolicy>::read(void* data, size_t size)
+    {
+        size_t available;
+        const u8* src = beginRead(available);
+        size = size < available ? size : available;
+        memcpy(data, src, size);
+        commitRead(size);
+        return size;
     }
 }
 
@@ -0,0 +1,205 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+// Compares the arena aware containers against the node based aliases of stl_types.h.
+// All containers allocate from the same arena without tracking or bounds checking so
+// the difference is the container itself.
+
+using Arena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                          SingleThread, NoBoundsChecking, NoMemoryTracking, NoMemoryTagging>;
+
+static const u32 smallIterations = 1000000;
+static const u32 lookupIterations = 4000000;
+static const size_t mapSizes[] = {8, 64, 1024, 65536};
+static const char* tagNames[] = {"FATAL", "ERROR", "WARN", "INFO", "DEBUG", "FILESYS", "RENDER", "AUDIO"};
+static const u32 numTags = sizeof(tagNames) / sizeof(tagNames[0]);
+
+static volatile u64 sink;
+
+template<class Container>
+struct Factory
+{
+    static Container create(Arena* pArena) { return Container(pArena); }
+};
+
+template<typename T>
+struct Factory<Vector<T, Arena>>
+{
+    static Vector<T, Arena> create(Arena* pArena) { return Vector<T, Arena>(StlAllocator<T, Arena>(pArena)); }
+};
+
+template<typename K, typename V, class Compare>
+struct Factory<Map<K, V, Arena, Compare>>
+{
+    static Map<K, V, Arena, Compare> create(Arena* pArena)
+    {
+        return Map<K, V, Arena, Compare>(Compare(), MapAllocator<K, V, Arena>(pArena));
+    }
+};
+
+// Create a container of a few listeners, walk it and destroy it, like a short lived
+// Event::Channel.
+template<class Container>
+double runSmallVector(Arena* pArena, u32 numElements)
+{
+    u64 sum = 0;
+    auto start = steady_clock::now();
+    for(u32 i = 0; i < smallIterations; ++i)
+    {
+        Container container = Factory<Container>::create(pArena);
+        for(u32 j = 0; j < numElements; ++j)
+        {
+            container.push_back(i + j);
+        }
+        for(u32 value : container)
+        {
+            sum += value;
+        }
+    }
+    auto end = steady_clock::now();
+    sink = sum;
+    return duration<double, nano>(end - start).count() / smallIterations;
+}
+
+// Look up log tags by name, like Logger::_tags and FileSystem::_mountedDevices.
+template<class Container>
+double runTagLookup(Arena* pArena)
+{
+    Container container = Factory<Container>::create(pArena);
+    for(u32 i = 0; i < numTags; ++i)
+    {
+        container.emplace(tagNames[i], i);
+    }
+
+    // Copies so that the keys are compared by value rather than by pointer.
+    char names[numTags][16];
+    for(u32 i = 0; i < numTags; ++i)
+    {
+        strcpy(names[i], tagNames[i]);
+    }
+
+    u64 sum = 0;
+    auto start = steady_clock::now();
+    for(u32 i = 0; i < lookupIterations; ++i)
+    {
+        sum += container.find(names[i % numTags])->second;
+    }
+    auto end = steady_clock::now();
+    sink = sum;
+    return duration<double, nano>(end - start).count() / lookupIterations;
+}
+
+// Returns nanoseconds per insert and per successful lookup of random keys.
+template<class Container>
+pair<double, double> runMap(Arena* pArena, size_t size)
+{
+    mt19937 random(1234);
+    vector<u32> keys(size);
+    for(u32& key : keys)
+    {
+        key = random();
+    }
+
+    Container container = Factory<Container>::create(pArena);
+    auto start = steady_clock::now();
+    for(u32 key : keys)
+    {
+        container.emplace(key, key);
+    }
+    auto end = steady_clock::now();
+    const double insertTime = duration<double, nano>(end - start).count() / size;
+
+    u64 sum = 0;
+    start = steady_clock::now();
+    for(u32 i = 0; i < lookupIterations; ++i)
+    {
+        sum += container.find(keys[i % size])->second;
+    }
+    end = steady_clock::now();
+    sink = sum;
+    return make_pair(insertTime, duration<double, nano>(end - start).count() / lookupIterations);
+}
+
+template<class Container>
+void benchmarkSmallVector(Arena* pArena, const char* containerType)
+{
+    cout << setw(56) << left << containerType;
+    for(u32 numElements : {2u, 4u, 8u, 16u})
+    {
+        cout << setw(10) << right << fixed << setprecision(1) << runSmallVector<Container>(pArena, numElements);
+    }
+    cout << endl;
+}
+
+template<class Container>
+void benchmarkTagLookup(Arena* pArena, const char* containerType)
+{
+    cout << setw(56) << left << containerType << setw(10) << right << fixed << setprecision(1)
+         << runTagLookup<Container>(pArena) << endl;
+}
+
+template<class Container>
+void benchmarkMap(Arena* pArena, const char* containerType, size_t maxSize)
+{
+    cout << setw(56) << left << containerType;
+    for(size_t size : mapSizes)
+    {
+        if(size > maxSize)
+        {
+            cout << setw(16) << right << "-";
+            continue;
+        }
+        auto times = runMap<Container>(pArena, size);
+        cout << setw(8) << right << fixed << setprecision(1) << times.first
+             << setw(8) << right << fixed << setprecision(1) << times.second;
+    }
+    cout << endl;
+}
+
+int main( int, char **)
+{
+    HeapArea area(256 * 1024 * 1024);
+    Arena arena(area, "ContainerArena");
+
+    cout << "create, fill and walk (ns)" << endl;
+    cout << setw(56) << left << "container" << setw(10) << right << "2" << setw(10) << "4" << setw(10) << "8" << setw(10) << "16" << endl;
+#define CURRENT_TEST(Container) \
+    benchmarkSmallVector<ArgumentType<void Container>::type>(&arena, FS_PP_STRINGIZE(Container))
+    CURRENT_TEST((Vector<u32, Arena>));
+    CURRENT_TEST((SmallVector<u32, 8, Arena>));
+#undef CURRENT_TEST
+
+    cout << endl << "log tag lookup (ns)" << endl;
+#define CURRENT_TEST(Container) \
+    benchmarkTagLookup<ArgumentType<void Container>::type>(&arena, FS_PP_STRINGIZE(Container))
+    CURRENT_TEST((Map<const char*, u32, Arena, CompareCString>));
+    CURRENT_TEST((FlatMap<const char*, u32, Arena, CompareCString>));
+#undef CURRENT_TEST
+
+    cout << endl << "random u32 keys, insert / lookup (ns)" << endl;
+    cout << setw(56) << left << "container";
+    for(size_t size : mapSizes)
+    {
+        cout << setw(16) << right << size;
+    }
+    cout << endl;
+#define CURRENT_TEST(Container, maxSize) \
+    benchmarkMap<ArgumentType<void Container>::type>(&arena, FS_PP_STRINGIZE(Container), maxSize)
+    CURRENT_TEST((Map<u32, u32, Arena>), 65536);
+    CURRENT_TEST((FlatMap<u32, u32, Arena>), 1024);
+    CURRENT_TEST((HashMap<u32, u32, Arena>), 65536);
+#undef CURRENT_TEST
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+static const u32 threadCounts[] = {1, 2, 4, 8, 16, 32};
+static const u32 numOperationsPerThread = 100000;
+
+// Runs numThreads threads that all call work() numOperationsPerThread times after a
+// common start signal. Returns the average ns per operation across all threads.
+template<class Work>
+double runThreads(u32 numThreads, Work work)
+{
+    std::atomic<bool> go(false);
+    std::atomic<u32> ready(0);
+    std::vector<std::thread> threads;
+
+    for(u32 i = 0; i < numThreads; ++i)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            ready++;
+            while(!go.load()) {}
+            for(u32 j = 0; j < numOperationsPerThread; ++j)
+            {
+                work();
+            }
+        }));
+    }
+
+    while(ready.load() != numThreads) {}
+    auto start = steady_clock::now();
+    go = true;
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto end = steady_clock::now();
+
+    return duration<double, nano>(end - start).count() / (double)(numOperationsPerThread * numThreads);
+}
+
+// Empty critical section: measures the cost of the primitive alone under contention.
+template<class Primitive>
+void primitive_EmptyCriticalSection(const char* primitiveType)
+{
+    cout << setw(28) << left << primitiveType;
+    for(u32 numThreads : threadCounts)
+    {
+        Primitive primitive;
+        u64 counter = 0;
+        double nsPerOp = runThreads(numThreads, [&]()
+        {
+            primitive.enter();
+            counter++;
+            primitive.leave();
+        });
+        cout << setw(10) << right << fixed << setprecision(1) << nsPerOp;
+    }
+    cout << endl;
+}
+
+// Allocate and free a small block from a single shared arena, the typical use of a
+// MultiThread policy.
+template<class Primitive>
+void arena_SharedAllocateFree(const char* primitiveType)
+{
+    using Arena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                              MultiThread<Primitive>,
+                              NoBoundsChecking,
+                              NoMemoryTracking,
+                              NoMemoryTagging>;
+
+    cout << setw(28) << left << primitiveType;
+    for(u32 numThreads : threadCounts)
+    {
+        HeapArea area(FS_SIZE_OF_MB * 32);
+        Arena arena(area, "BenchmarkArena");
+        double nsPerOp = runThreads(numThreads, [&]()
+        {
+            arena.free(arena.allocate(32, 8, FS_SOURCE_INFO));
+        });
+        cout << setw(10) << right << fixed << setprecision(1) << nsPerOp;
+    }
+    cout << endl;
+}
+
+void printHeader(const char* title)
+{
+    cout << title << " (ns/op)" << endl;
+    cout << setw(28) << left << "threads";
+    for(u32 numThreads : threadCounts)
+    {
+        cout << setw(10) << right << numThreads;
+    }
+    cout << endl;
+}
+
+int main( int, char **)
+{
+#define CURRENT_TEST(Primitive) \
+    primitive_EmptyCriticalSection<ArgumentType<void(Primitive)>::type>(FS_PP_STRINGIZE(Primitive))
+    printHeader("primitive_EmptyCriticalSection");
+    CURRENT_TEST(MutexPrimitive);
+    CURRENT_TEST(SpinThenParkPrimitive<>);
+    CURRENT_TEST(SpinThenParkPrimitive<0>);
+    CURRENT_TEST(TicketPrimitive);
+    CURRENT_TEST(ReaderWriterPrimitive);
+#undef CURRENT_TEST
+    cout << endl;
+
+#define CURRENT_TEST(Primitive) \
+    arena_SharedAllocateFree<ArgumentType<void(Primitive)>::type>(FS_PP_STRINGIZE(Primitive))
+    printHeader("arena_SharedAllocateFree");
+    CURRENT_TEST(MutexPrimitive);
+    CURRENT_TEST(SpinThenParkPrimitive<>);
+    CURRENT_TEST(SpinThenParkPrimitive<0>);
+    CURRENT_TEST(TicketPrimitive);
+    CURRENT_TEST(ReaderWriterPrimitive);
+#undef CURRENT_TEST
+
+    return 0;
+}
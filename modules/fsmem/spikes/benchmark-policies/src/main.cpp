@@ -0,0 +1,244 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+// Usage: fsmem-benchmark-policies [output.csv]
+// Instantiates MemoryArena for every combination of backing allocator and policy
+// listed below and writes one CSV row per configuration and workload:
+//
+//   workload,allocator,thread,bounds,tracking,tagging,ns_per_op,overhead_bytes,tracking_bytes
+//
+// overhead_bytes is the extra memory used by the backing allocator per allocation
+// beyond the requested size (headers, guards and alignment). tracking_bytes is the
+// memory used per allocation in the debug arena by the tracking policy. Names are
+// quoted because template arguments may contain commas.
+
+template<class... Ts> struct TypeList {};
+
+using Allocators = TypeList<HeapAllocator,
+                            StackAllocatorBottom,
+                            PoolAllocatorNonGrowable<64, 16>>;
+
+using ThreadPolicies = TypeList<SingleThread,
+                                MultiThread<MutexPrimitive>,
+                                MultiThread<SpinThenParkPrimitive<>>>;
+
+using BoundsCheckingPolicies = TypeList<NoBoundsChecking,
+                                        SimpleBoundsChecking,
+                                        ExtendedBoundsChecking>;
+
+using MemoryTrackingPolicies = TypeList<NoMemoryTracking,
+                                        SimpleMemoryTracking,
+                                        ExtendedMemoryTracking,
+                                        FullMemoryTracking>;
+
+using MemoryTaggingPolicies = TypeList<NoMemoryTagging,
+                                       MemoryTagging>;
+
+template<class T> struct Name;
+#define FS_BENCHMARK_NAME(...) \
+    template<> struct Name<__VA_ARGS__> { static const char* get() { return "\"" #__VA_ARGS__ "\""; } };
+FS_BENCHMARK_NAME(HeapAllocator)
+FS_BENCHMARK_NAME(StackAllocatorBottom)
+FS_BENCHMARK_NAME(PoolAllocatorNonGrowable<64, 16>)
+FS_BENCHMARK_NAME(SingleThread)
+FS_BENCHMARK_NAME(MultiThread<MutexPrimitive>)
+FS_BENCHMARK_NAME(MultiThread<SpinThenParkPrimitive<>>)
+FS_BENCHMARK_NAME(NoBoundsChecking)
+FS_BENCHMARK_NAME(SimpleBoundsChecking)
+FS_BENCHMARK_NAME(ExtendedBoundsChecking)
+FS_BENCHMARK_NAME(NoMemoryTracking)
+FS_BENCHMARK_NAME(SimpleMemoryTracking)
+FS_BENCHMARK_NAME(ExtendedMemoryTracking)
+FS_BENCHMARK_NAME(FullMemoryTracking)
+FS_BENCHMARK_NAME(NoMemoryTagging)
+FS_BENCHMARK_NAME(MemoryTagging)
+#undef FS_BENCHMARK_NAME
+
+// Which workloads a backing allocator can run.
+template<class Alloc> struct Capabilities
+{
+    static const bool mixedSizes = true;
+    static const bool anyOrder = true;
+};
+
+template<> struct Capabilities<StackAllocatorBottom>
+{
+    static const bool mixedSizes = true;
+    static const bool anyOrder = false;
+};
+
+template<> struct Capabilities<PoolAllocatorNonGrowable<64, 16>>
+{
+    static const bool mixedSizes = false;
+    static const bool anyOrder = true;
+};
+
+template<class ThreadPolicy> struct IsMultiThread { static const bool value = true; };
+template<> struct IsMultiThread<SingleThread> { static const bool value = false; };
+
+static const u32 numAllocations = 20000;
+static const u32 numThreads = 4;
+static const size_t fixedSize = 32;
+static const size_t alignment = 8;
+
+struct Result
+{
+    f64 nsPerOp = 0;
+    f64 overheadBytes = 0;
+    f64 trackingBytes = 0;
+};
+
+// Allocate numAllocations blocks then free them in reverse order.
+template<class Arena>
+Result singleThread(Arena& arena, bool mixedSizes)
+{
+    Result result;
+    vector<void*> ptrs(numAllocations);
+    vector<size_t> sizes(numAllocations, fixedSize);
+    size_t requestedSize = 0;
+    srand(1234);
+    for(u32 i = 0; i < numAllocations; ++i)
+    {
+        if(mixedSizes)
+        {
+            sizes[i] = 16 + rand() % 1024;
+        }
+        requestedSize += sizes[i];
+    }
+
+    const size_t usedBefore = arena.getTotalUsedSize();
+    const size_t debugUsedBefore = fs::memory::getDebugArena()->getTotalUsedSize();
+
+    auto start = steady_clock::now();
+    for(u32 i = 0; i < numAllocations; ++i)
+    {
+        ptrs[i] = arena.allocate(sizes[i], alignment, FS_SOURCE_INFO);
+    }
+    auto end = steady_clock::now();
+    f64 elapsed = duration<f64, nano>(end - start).count();
+
+    result.overheadBytes = ((f64)arena.getTotalUsedSize() - usedBefore - requestedSize) / numAllocations;
+    result.trackingBytes = ((f64)fs::memory::getDebugArena()->getTotalUsedSize() - debugUsedBefore) / numAllocations;
+
+    start = steady_clock::now();
+    for(i32 i = numAllocations - 1; i >= 0; --i)
+    {
+        arena.free(ptrs[i]);
+    }
+    end = steady_clock::now();
+    elapsed += duration<f64, nano>(end - start).count();
+
+    result.nsPerOp = elapsed / (numAllocations * 2);
+    return result;
+}
+
+// Every thread repeatedly allocates and frees a fixed size block from the same arena.
+template<class Arena>
+Result multiThread(Arena& arena)
+{
+    Result result;
+    vector<thread> threads;
+    auto start = steady_clock::now();
+    for(u32 t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(thread([&arena]()
+        {
+            for(u32 i = 0; i < numAllocations / numThreads; ++i)
+            {
+                arena.free(arena.allocate(fixedSize, alignment, FS_SOURCE_INFO));
+            }
+        }));
+    }
+    for(auto& t : threads)
+    {
+        t.join();
+    }
+    auto end = steady_clock::now();
+
+    result.nsPerOp = duration<f64, nano>(end - start).count() / ((numAllocations / numThreads) * numThreads * 2);
+    return result;
+}
+
+template<class Alloc, class Thread, class Bounds, class Tracking, class Tagging>
+void writeRow(ostream& out, const char* workload, const Result& result)
+{
+    out << workload << ","
+        << Name<Alloc>::get() << ","
+        << Name<Thread>::get() << ","
+        << Name<Bounds>::get() << ","
+        << Name<Tracking>::get() << ","
+        << Name<Tagging>::get() << ","
+        << result.nsPerOp << ","
+        << result.overheadBytes << ","
+        << result.trackingBytes << "\n";
+}
+
+template<class Alloc, class Thread, class Bounds, class Tracking, class Tagging>
+void runConfiguration(ostream& out)
+{
+    using Arena = MemoryArena<Allocator<Alloc, AllocationHeaderU32>, Thread, Bounds, Tracking, Tagging>;
+    HeapArea area(FS_SIZE_OF_MB);
+
+    {
+        Arena arena(area, "BenchmarkArena");
+        writeRow<Alloc, Thread, Bounds, Tracking, Tagging>(out, "single_fixed", singleThread(arena, false));
+    }
+
+    if(Capabilities<Alloc>::mixedSizes)
+    {
+        Arena arena(area, "BenchmarkArena");
+        writeRow<Alloc, Thread, Bounds, Tracking, Tagging>(out, "single_mixed", singleThread(arena, true));
+    }
+
+    if(IsMultiThread<Thread>::value && Capabilities<Alloc>::anyOrder)
+    {
+        Arena arena(area, "BenchmarkArena");
+        writeRow<Alloc, Thread, Bounds, Tracking, Tagging>(out, "multi_fixed", multiThread(arena));
+    }
+}
+
+// Expands to runConfiguration for every element of the cartesian product of Lists.
+template<class Done, class... Lists> struct Product;
+
+template<class... Done>
+struct Product<TypeList<Done...>>
+{
+    static void run(ostream& out) { runConfiguration<Done...>(out); }
+};
+
+template<class... Done, class... Heads, class... Rest>
+struct Product<TypeList<Done...>, TypeList<Heads...>, Rest...>
+{
+    static void run(ostream& out)
+    {
+        int expand[] = {0, (Product<TypeList<Done..., Heads>, Rest...>::run(out), 0)...};
+        (void)expand;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    ofstream file;
+    if(argc > 1)
+    {
+        file.open(argv[1]);
+    }
+    ostream& out = file.is_open() ? file : cout;
+
+    out << "workload,allocator,thread,bounds,tracking,tagging,ns_per_op,overhead_bytes,tracking_bytes\n";
+    Product<TypeList<>, Allocators, ThreadPolicies, BoundsCheckingPolicies,
+            MemoryTrackingPolicies, MemoryTaggingPolicies>::run(out);
+
+    return 0;
+}
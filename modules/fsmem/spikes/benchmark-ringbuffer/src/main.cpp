@@ -0,0 +1,234 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+// Compares VirtualRingBuffer against a conventional ring buffer that splits every copy
+// that crosses the end of the buffer in two. Both use the same cursors so the only
+// difference is the copy. Messages are framed as a u32 size followed by the payload.
+// The virtual buffer consumer parses messages in place while the split copy consumer
+// has to copy each message out before it can look at it.
+
+static const size_t bufferSize = 64 * 1024;
+static const size_t bytesPerProducer = 16 * 1024 * 1024;
+static const u32 producerCounts[] = {1, 2, 4};
+static const size_t messageSizes[] = {16, 256, 2048};
+
+template<class ProducerPolicy>
+class SplitCopyRingBuffer : Uncopyable
+{
+public:
+    explicit SplitCopyRingBuffer(size_t size) :
+        _data(size),
+        _reserved(0),
+        _committed(0),
+        _read(0)
+    {
+    }
+
+    bool write(const void* data, size_t size)
+    {
+        u64 position;
+        if(!ProducerPolicy::reserve(_reserved, _read.load(std::memory_order_acquire), size, _data.size(), position))
+        {
+            return false;
+        }
+        const size_t index = position % _data.size();
+        const size_t first = min(size, _data.size() - index);
+        memcpy(&_data[index], data, first);
+        memcpy(&_data[0], static_cast<const u8*>(data) + first, size - first);
+        ProducerPolicy::publish(_committed, position, size);
+        return true;
+    }
+
+    size_t getSize() const
+    {
+        return (size_t)(_committed.load(std::memory_order_acquire) - _read.load(std::memory_order_relaxed));
+    }
+
+    // Copy exactly size bytes without consuming them.
+    void peek(void* data, size_t size) const
+    {
+        const size_t index = _read.load(std::memory_order_relaxed) % _data.size();
+        const size_t first = min(size, _data.size() - index);
+        memcpy(data, &_data[index], first);
+        memcpy(static_cast<u8*>(data) + first, &_data[0], size - first);
+    }
+
+    void commitRead(size_t size)
+    {
+        _read.store(_read.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    }
+
+private:
+    vector<u8> _data;
+    std::atomic<u64> _reserved;
+    std::atomic<u64> _committed;
+    std::atomic<u64> _read;
+};
+
+// Writes one framed message. Space for the header and payload is reserved together so
+// messages from different producers never interleave.
+template<class Buffer>
+void writeMessage(Buffer& buffer, const u8* message, size_t size);
+
+template<class ProducerPolicy>
+void writeMessage(VirtualRingBuffer<ProducerPolicy>& buffer, const u8* message, size_t size)
+{
+    typename VirtualRingBuffer<ProducerPolicy>::Reservation reservation;
+    while(!(reservation = buffer.beginWrite(sizeof(u32) + size)).data)
+    {
+        this_thread::yield();
+    }
+    const u32 header = (u32)size;
+    memcpy(reservation.data, &header, sizeof(u32));
+    memcpy(reservation.data + sizeof(u32), message, size);
+    buffer.commitWrite(reservation);
+}
+
+template<class ProducerPolicy>
+void writeMessage(SplitCopyRingBuffer<ProducerPolicy>& buffer, const u8* message, size_t size)
+{
+    // The split copy buffer has no reservations so the frame is assembled first.
+    u8 frame[sizeof(u32) + 2048];
+    const u32 header = (u32)size;
+    memcpy(frame, &header, sizeof(u32));
+    memcpy(frame + sizeof(u32), message, size);
+    while(!buffer.write(frame, sizeof(u32) + size))
+    {
+        this_thread::yield();
+    }
+}
+
+// Consume every complete message currently in the buffer. Returns the bytes consumed
+// and accumulates a checksum of the payloads.
+template<class ProducerPolicy>
+size_t readMessages(VirtualRingBuffer<ProducerPolicy>& buffer, u64& checksum)
+{
+    size_t available;
+    const u8* data = buffer.beginRead(available);
+    size_t consumed = 0;
+    while(available - consumed >= sizeof(u32))
+    {
+        u32 size;
+        memcpy(&size, data + consumed, sizeof(u32));
+        const u8* payload = data + consumed + sizeof(u32);
+        checksum += payload[0] + payload[size - 1];
+        consumed += sizeof(u32) + size;
+    }
+    buffer.commitRead(consumed);
+    return consumed;
+}
+
+template<class ProducerPolicy>
+size_t readMessages(SplitCopyRingBuffer<ProducerPolicy>& buffer, u64& checksum)
+{
+    u8 payload[2048];
+    size_t consumed = 0;
+    while(buffer.getSize() >= sizeof(u32))
+    {
+        u32 frame[1 + 2048 / sizeof(u32)];
+        buffer.peek(frame, sizeof(u32));
+        const u32 size = frame[0];
+        buffer.peek(frame, sizeof(u32) + size);
+        memcpy(payload, frame + 1, size);
+        checksum += payload[0] + payload[size - 1];
+        buffer.commitRead(sizeof(u32) + size);
+        consumed += sizeof(u32) + size;
+    }
+    return consumed;
+}
+
+// Returns the throughput in MB/s from the first write to the last read.
+template<class Buffer>
+double run(u32 numProducers, size_t messageSize)
+{
+    Buffer buffer(bufferSize);
+    vector<u8> message(messageSize, 0xAB);
+    const size_t messagesPerProducer = bytesPerProducer / messageSize;
+    const size_t totalBytes = (sizeof(u32) + messageSize) * messagesPerProducer * numProducers;
+
+    auto start = steady_clock::now();
+    vector<thread> producers;
+    for(u32 p = 0; p < numProducers; ++p)
+    {
+        producers.push_back(thread([&]()
+        {
+            for(size_t i = 0; i < messagesPerProducer; ++i)
+            {
+                writeMessage(buffer, message.data(), messageSize);
+            }
+        }));
+    }
+
+    u64 checksum = 0;
+    size_t received = 0;
+    while(received < totalBytes)
+    {
+        size_t consumed = readMessages(buffer, checksum);
+        if(consumed == 0)
+        {
+            this_thread::yield();
+        }
+        received += consumed;
+    }
+    auto end = steady_clock::now();
+
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    if(checksum != (u64)0xAB * 2 * messagesPerProducer * numProducers)
+    {
+        cout << "checksum mismatch" << endl;
+    }
+
+    return (totalBytes / (1024.0 * 1024.0)) / duration<double>(end - start).count();
+}
+
+template<class Buffer>
+void benchmark(const char* bufferType, u32 numProducers)
+{
+    cout << setw(48) << left << bufferType << setw(10) << right << numProducers;
+    for(size_t messageSize : messageSizes)
+    {
+        cout << setw(12) << right << fixed << setprecision(1) << run<Buffer>(numProducers, messageSize);
+    }
+    cout << endl;
+}
+
+int main( int, char **)
+{
+    cout << "throughput (MB/s)" << endl;
+    cout << setw(48) << left << "buffer" << setw(10) << right << "producers";
+    for(size_t messageSize : messageSizes)
+    {
+        cout << setw(12) << right << messageSize;
+    }
+    cout << endl;
+
+#define CURRENT_TEST(Buffer, numProducers) \
+    benchmark<ArgumentType<void(Buffer)>::type>(FS_PP_STRINGIZE(Buffer), numProducers)
+    CURRENT_TEST(VirtualRingBuffer<SingleProducer>, 1);
+    CURRENT_TEST(SplitCopyRingBuffer<SingleProducer>, 1);
+    for(u32 numProducers : producerCounts)
+    {
+        CURRENT_TEST(VirtualRingBuffer<MultiProducer>, numProducers);
+        CURRENT_TEST(SplitCopyRingBuffer<MultiProducer>, numProducers);
+    }
+#undef CURRENT_TEST
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+using namespace std;
+
+// Usage: fsmem-replay-trace [trace file]
+// Without a trace file a sample trace is recorded from a synthetic frame loop, saved
+// to content/sample.fstrace and then replayed. Record a real trace by using
+// TraceMemoryTracking in an arena and saving getMemoryTracker().getTrace().
+
+using TracedArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                SingleThread,
+                                NoBoundsChecking,
+                                TraceMemoryTracking,
+                                NoMemoryTagging>;
+
+static const size_t replayAreaSize = FS_SIZE_OF_MB * 4;
+
+// Peak resident set size of the process in kB. Linux only.
+size_t getPeakResidentSize()
+{
+    ifstream status("/proc/self/status");
+    std::string line;
+    while(getline(status, line))
+    {
+        if(line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return strtoul(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Reset the peak resident set size so each replay reports its own peak.
+void resetPeakResidentSize()
+{
+    ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+}
+
+void recordSampleTrace(AllocationTrace& trace)
+{
+    HeapArea area(FS_SIZE_OF_MB);
+    TracedArena arena(area, "TracedArena");
+    srand(1234);
+
+    const u32 numFrames = 200;
+    const u32 maxLongLived = 256;
+    void* longLived[maxLongLived] = {};
+    void* growing = arena.allocate(64, 16, FS_SOURCE_INFO);
+    size_t growingSize = 64;
+
+    for(u32 frame = 0; frame < numFrames; ++frame)
+    {
+        // Short lived per frame temporaries freed in reverse order.
+        void* temporaries[32];
+        for(u32 i = 0; i < 32; ++i)
+        {
+            temporaries[i] = arena.allocate(16 + rand() % 256, 8, FS_SOURCE_INFO);
+        }
+        for(i32 i = 31; i >= 0; --i)
+        {
+            arena.free(temporaries[i]);
+        }
+
+        // Long lived objects replaced at random.
+        for(u32 i = 0; i < 4; ++i)
+        {
+            u32 slot = rand() % maxLongLived;
+            if(longLived[slot])
+            {
+                arena.free(longLived[slot]);
+            }
+            longLived[slot] = arena.allocate(32 * (1 + rand() % 16), 16, FS_SOURCE_INFO);
+        }
+
+        // A container that grows over time.
+        if(frame % 20 == 0 && growingSize < 64 * 1024)
+        {
+            growingSize *= 2;
+            growing = arena.reallocate(growing, growingSize, 16, FS_SOURCE_INFO);
+        }
+    }
+
+    for(u32 i = 0; i < maxLongLived; ++i)
+    {
+        if(longLived[i])
+        {
+            arena.free(longLived[i]);
+        }
+    }
+    arena.free(growing);
+
+    trace = arena.getMemoryTracker().getTrace();
+}
+
+void printHeader()
+{
+    cout << setw(24) << left << "allocator"
+         << setw(12) << right << "Mops/s"
+         << setw(8) << "p50"
+         << setw(8) << "p90"
+         << setw(8) << "p99"
+         << setw(8) << "p99.9"
+         << setw(10) << "max"
+         << setw(12) << "peakUsed"
+         << setw(8) << "frag"
+         << setw(12) << "peakRSS kB"
+         << setw(8) << "failed" << endl;
+}
+
+template<class Allocator>
+void replay(const char* allocatorType, const AllocationTrace& trace)
+{
+    HeapArea area(replayAreaSize);
+    Allocator allocator(area.getStart(), area.getEnd());
+    TraceReplayReport report;
+
+    resetPeakResidentSize();
+    fs::memory::replayTrace(trace, allocator, report);
+    const size_t peakResidentSize = getPeakResidentSize();
+
+    cout << setw(24) << left << allocatorType
+         << setw(12) << right << fixed << setprecision(2) << report.operationsPerSecond / 1e6
+         << setw(8) << report.latencyP50
+         << setw(8) << report.latencyP90
+         << setw(8) << report.latencyP99
+         << setw(8) << report.latencyP999
+         << setw(10) << report.latencyMax
+         << setw(12) << report.peakUsedSize
+         << setw(8) << setprecision(3) << report.fragmentation
+         << setw(12) << peakResidentSize
+         << setw(8) << report.numFailedAllocations << endl;
+}
+
+int main(int argc, char** argv)
+{
+    AllocationTrace trace;
+    if(argc > 1)
+    {
+        if(!trace.load(argv[1]))
+        {
+            cout << "Could not load trace " << argv[1] << endl;
+            return 1;
+        }
+    }
+    else
+    {
+        recordSampleTrace(trace);
+        trace.save("content/sample.fstrace");
+    }
+
+    cout << "events: " << trace.getNumEvents()
+         << ", allocations: " << trace.getIdRange()
+         << ", threads: " << trace.getNumThreads()
+         << ", max size: " << trace.getMaxAllocationSize()
+         << ", lifo: " << (trace.isLifo() ? "yes" : "no") << endl;
+    cout << "latencies in ns" << endl;
+    printHeader();
+
+#define CURRENT_TEST(Allocator) \
+    replay<ArgumentType<void(Allocator)>::type>(FS_PP_STRINGIZE(Allocator), trace)
+    CURRENT_TEST(HeapAllocator);
+    CURRENT_TEST(MallocAllocator);
+    if(trace.isLifo())
+    {
+        CURRENT_TEST(StackAllocatorBottom);
+        CURRENT_TEST(StackAllocatorTop);
+    }
+    if(trace.getMaxAllocationSize() <= 496 && trace.getMaxAlignment() <= 16)
+    {
+        CURRENT_TEST((PoolAllocatorNonGrowable<512, 16>));
+    }
+#undef CURRENT_TEST
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "fsmem/allocators/guard_page_allocator.h"
+
+#include "fscore/assert.h"
+#include "fsmem/utils.h"
+
+using namespace fs;
+
+GuardPageAllocator::GuardPageAllocator() :
+    _blocks(nullptr),
+    _pageSize(VirtualMemory::getPageSize()),
+    _virtualSize(0),
+    _physicalSize(0)
+{
+}
+
+GuardPageAllocator::GuardPageAllocator(void* start, void* end) :
+    GuardPageAllocator()
+{
+    (void)start;
+    (void)end;
+}
+
+GuardPageAllocator::~GuardPageAllocator()
+{
+    reset();
+}
+
+void* GuardPageAllocator::allocate(size_t size, size_t alignment, size_t offset)
+{
+    FS_ASSERT(size > 0);
+    alignment = alignment == 0 ? 1 : alignment;
+    FS_ASSERT(bitUtil::isPowerOfTwo(alignment));
+
+    // Enough accessible pages for the allocation, the worst case alignment padding and
+    // the block bookkeeping in front of it followed by one guard page.
+    const size_t accessibleSize = bitUtil::roundUpToMultiple(size + alignment + sizeof(Block) + alignof(Block), _pageSize);
+    const size_t reservedSize = accessibleSize + _pageSize;
+
+    void* reservation = VirtualMemory::reserveAddressSpace(reservedSize);
+    if(!reservation)
+    {
+        return nullptr;
+    }
+
+    if(!VirtualMemory::allocatePhysicalMemory(reservation, accessibleSize))
+    {
+        VirtualMemory::releaseAddressSpace(reservation, reservedSize);
+        return nullptr;
+    }
+
+    // Push the allocation as far towards the guard page as alignment allows.
+    const uptr guardPage = (uptr)reservation + accessibleSize;
+    const uptr userPtr = (((guardPage - size + offset) & ~(alignment - 1))) - offset;
+
+    Block* block = getBlock(userPtr);
+    FS_ASSERT((uptr)block >= (uptr)reservation);
+    block->prev = nullptr;
+    block->next = _blocks;
+    block->reservation = reservation;
+    block->reservedSize = reservedSize;
+    if(_blocks)
+    {
+        _blocks->prev = block;
+    }
+    _blocks = block;
+
+    _virtualSize += reservedSize;
+    _physicalSize += accessibleSize;
+
+    return (void*)userPtr;
+}
+
+void GuardPageAllocator::free(void* ptr)
+{
+    FS_ASSERT(ptr);
+    Block* block = getBlock((uptr)ptr);
+
+    if(block->prev)
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        FS_ASSERT_MSG(_blocks == block, "Pointer was not allocated by this GuardPageAllocator.");
+        _blocks = block->next;
+    }
+
+    if(block->next)
+    {
+        block->next->prev = block->prev;
+    }
+
+    release(block);
+}
+
+void GuardPageAllocator::reset()
+{
+    while(_blocks)
+    {
+        Block* next = _blocks->next;
+        release(_blocks);
+        _blocks = next;
+    }
+}
+
+GuardPageAllocator::Block* GuardPageAllocator::getBlock(uptr userPtr)
+{
+    return (Block*)((userPtr - sizeof(Block)) & ~(alignof(Block) - 1));
+}
+
+void GuardPageAllocator::release(Block* block)
+{
+    void* reservation = block->reservation;
+    const size_t reservedSize = block->reservedSize;
+
+    _virtualSize -= reservedSize;
+    _physicalSize -= reservedSize - _pageSize;
+
+    VirtualMemory::releaseAddressSpace(reservation, reservedSize);
+}
@@ -1,5 +1,8 @@
 #include "fsmem/allocators/heap_allocator.h"
 
+#include <cstring>
+#include <new>
+
 #include "fsmem/utils.h"
 
 using namespace fs;
@@ -12,7 +15,9 @@ namespace
 
 HeapAllocator::HeapAllocator(void* start, void* end) :
     _start(start),
-    _end(end)
+    _end(end),
+    _pMovable(nullptr),
+    _compactCursor(0)
 {
     FS_ASSERT(start);
     FS_ASSERT(end);
@@ -32,6 +37,11 @@ void HeapAllocator::createHeap()
 {
     _mspace = create_mspace_with_base(_start, (uptr)_end - (uptr)_start, 0);
     FS_ASSERT_MSG(_mspace, "Failed to create dlmalloc heap");
+
+    // Keep dlmalloc from mapping more memory from the system when the heap is full or
+    // fragmented; requests that do not fit fail instead.
+    mspace_set_footprint_limit(_mspace, (uptr)_end - (uptr)_start);
+    _tableArena.space = _mspace;
 }
 
 void* HeapAllocator::allocate(size_t size, size_t alignment, size_t offset)
@@ -45,14 +55,14 @@ void* HeapAllocator::allocate(size_t size, size_t alignment, size_t offset)
     // We waste up to 'alignment' bytes in order to ensure we can align and
     // offset the memory as requested.
     uptr ptr = (uptr)mspace_malloc(_mspace, size + alignment);
-    FS_ASSERT_MSG((void*)ptr >= _start && (void*)ptr < _end, "mspace_malloc exceeded budget.");
-
     if((void*)ptr == nullptr)
     {
         FS_ASSERT(!"Failed to allocate memory from dlmalloc heap.");
         return nullptr;
     }
 
+    FS_ASSERT_MSG((void*)ptr >= _start && (void*)ptr < _end, "mspace_malloc exceeded budget.");
+
     void* header = (void*)(pointerUtil::alignTop(ptr + offset, alignment) - offset);
     const u32 headerSize = (uptr)header - ptr + SIZE_OF_ALLOCATION_OFFSET;
 
@@ -96,11 +106,145 @@ void HeapAllocator::free(void* ptr)
 
 void HeapAllocator::reset()
 {
+    // The relocation table lives in the heap so it is discarded with everything else and
+    // recreated empty.
+    const u32 maxMovable = _pMovable ? _pMovable->capacity() : 0;
+    _pMovable = nullptr;
+    _compactCursor = 0;
+
     destroy_mspace(_mspace);
     createHeap();
+
+    if(maxMovable > 0)
+    {
+        enableMovableAllocations(maxMovable);
+    }
 }
 
 size_t HeapAllocator::getTotalUsedSize()
 {
     return mspace_mallinfo(_mspace).uordblks;
 }
+
+void HeapAllocator::enableMovableAllocations(u32 maxMovable)
+{
+    FS_ASSERT_MSG(!_pMovable, "Movable allocations are already enabled.");
+
+    void* pTable = _tableArena.allocate(sizeof(MovablePool), alignof(MovablePool), FS_SOURCE_INFO);
+    FS_ASSERT_MSG(pTable, "Failed to allocate the relocation table.");
+    _pMovable = new (pTable) MovablePool(&_tableArena, maxMovable);
+}
+
+HeapAllocator::MovableHandle HeapAllocator::allocateMovable(size_t size, size_t alignment)
+{
+    FS_ASSERT_MSG(_pMovable, "Movable allocations must be enabled first.");
+    if(_pMovable->full())
+    {
+        return MovableHandle();
+    }
+
+    void* ptr = mspace_memalign(_mspace, alignment, size);
+    if(!ptr)
+    {
+        return MovableHandle();
+    }
+
+    MovableBlock block = {ptr, size, alignment, 0};
+    return _pMovable->create(block);
+}
+
+void HeapAllocator::freeMovable(MovableHandle handle)
+{
+    FS_ASSERT(_pMovable);
+    MovableBlock* pBlock = _pMovable->get(handle);
+    FS_ASSERT_MSG(pBlock, "Freeing a stale movable allocation.");
+    FS_ASSERT_MSG(pBlock->pinCount == 0, "Freeing a pinned movable allocation.");
+
+    mspace_free(_mspace, pBlock->ptr);
+    _pMovable->destroy(handle);
+}
+
+void* HeapAllocator::getMovable(MovableHandle handle) const
+{
+    FS_ASSERT(_pMovable);
+    const MovableBlock* pBlock = _pMovable->get(handle);
+    return pBlock ? pBlock->ptr : nullptr;
+}
+
+void HeapAllocator::pinMovable(MovableHandle handle)
+{
+    FS_ASSERT(_pMovable);
+    MovableBlock* pBlock = _pMovable->get(handle);
+    FS_ASSERT(pBlock);
+    ++pBlock->pinCount;
+}
+
+void HeapAllocator::unpinMovable(MovableHandle handle)
+{
+    FS_ASSERT(_pMovable);
+    MovableBlock* pBlock = _pMovable->get(handle);
+    FS_ASSERT(pBlock && pBlock->pinCount > 0);
+    --pBlock->pinCount;
+}
+
+size_t HeapAllocator::compact(size_t maxBytes)
+{
+    if(!_pMovable)
+    {
+        return 0;
+    }
+
+    // dlmalloc hands out the best fitting free chunk. When that chunk is below the
+    // allocation, moving the allocation there frees its old chunk to merge with its
+    // neighbours. Otherwise the new chunk is given back and the allocation stays.
+    size_t movedBytes = 0;
+    const u32 numBlocks = _pMovable->size();
+    for(u32 i = 0; i < numBlocks && movedBytes < maxBytes; ++i)
+    {
+        if(_compactCursor >= _pMovable->size())
+        {
+            _compactCursor = 0;
+        }
+
+        MovableBlock& block = (*_pMovable)[_compactCursor++];
+        if(block.pinCount > 0)
+        {
+            continue;
+        }
+
+        void* ptr = mspace_memalign(_mspace, block.alignment, block.size);
+        if(!ptr)
+        {
+            continue;
+        }
+
+        if(ptr < block.ptr)
+        {
+            std::memcpy(ptr, block.ptr, block.size);
+            mspace_free(_mspace, block.ptr);
+            block.ptr = ptr;
+            movedBytes += block.size;
+        }
+        else
+        {
+            mspace_free(_mspace, ptr);
+        }
+    }
+
+    return movedBytes;
+}
+
+u32 HeapAllocator::getNumMovableAllocations() const
+{
+    return _pMovable ? _pMovable->size() : 0;
+}
+
+void* HeapAllocator::MspaceArena::allocate(size_t size, size_t alignment, const SourceInfo&)
+{
+    return mspace_memalign(space, alignment, size);
+}
+
+void HeapAllocator::MspaceArena::free(void* ptr)
+{
+    mspace_free(space, ptr);
+}
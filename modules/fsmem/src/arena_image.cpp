@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "fsmem/arena_image.h"
+
+using namespace fs;
+
+ArenaImage::ArenaImage() :
+    _data(nullptr),
+    _dataSize(0),
+    _rootOffset(0)
+{
+}
+
+bool ArenaImage::open(const void* data, size_t size)
+{
+    _data = nullptr;
+    _dataSize = 0;
+    _rootOffset = 0;
+
+    if(!data || size < sizeof(ArenaImageHeader))
+    {
+        return false;
+    }
+
+    const ArenaImageHeader* header = static_cast<const ArenaImageHeader*>(data);
+    const bool valid = header->magic == ArenaImageHeader::MAGIC &&
+                       header->version == ArenaImageHeader::VERSION &&
+                       header->dataOffset >= sizeof(ArenaImageHeader) &&
+                       header->dataOffset <= size &&
+                       header->dataSize <= size - header->dataOffset &&
+                       header->rootOffset < header->dataSize;
+    FS_ASSERT_MSG(valid, "Data is not a compatible arena image.");
+    if(!valid)
+    {
+        return false;
+    }
+
+    _data = static_cast<const u8*>(data) + header->dataOffset;
+    _dataSize = header->dataSize;
+    _rootOffset = header->rootOffset;
+    return true;
+}
+
+bool memory::saveArenaImage(const char* path, const void* start, size_t size, const void* root)
+{
+    FS_ASSERT(start);
+    FS_ASSERT_MSG((uptr)root >= (uptr)start && (uptr)root < (uptr)start + size,
+                  "Arena image root must be within the saved memory.");
+
+    FILE* pFile = fopen(path, "wb");
+    if(!pFile)
+    {
+        return false;
+    }
+
+    ArenaImageHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ArenaImageHeader::MAGIC;
+    header.version = ArenaImageHeader::VERSION;
+    header.dataOffset = sizeof(header) + (uptr)start % ArenaImageHeader::MAX_ALIGNMENT;
+    header.dataSize = size;
+    header.rootOffset = (uptr)root - (uptr)start;
+
+    const u8 padding[ArenaImageHeader::MAX_ALIGNMENT] = {};
+    const size_t paddingSize = header.dataOffset - sizeof(header);
+
+    bool success = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    success = success && (paddingSize == 0 || fwrite(padding, paddingSize, 1, pFile) == 1);
+    success = success && (size == 0 || fwrite(start, size, 1, pFile) == 1);
+
+    return fclose(pFile) == 0 && success;
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <algorithm>
+
+#include "fsmem/debug/allocation_trace.h"
+
+using namespace fs;
+
+namespace
+{
+    const u32 traceMagic = 0x54415346; // "FSAT"
+    const u32 traceVersion = 1;
+
+    struct TraceFileHeader
+    {
+        u32 magic;
+        u32 version;
+        u32 eventSize;
+        u32 reserved;
+        u64 numEvents;
+    };
+}
+
+AllocationTrace::AllocationTrace() :
+    _events(DebugStlAllocator<AllocationTraceEvent>())
+{
+}
+
+u32 AllocationTrace::getIdRange() const
+{
+    u32 range = 0;
+    for(auto& event : _events)
+    {
+        if(event.type != AllocationTraceEvent::RESET && event.id + 1 > range)
+        {
+            range = event.id + 1;
+        }
+    }
+    return range;
+}
+
+u32 AllocationTrace::getNumThreads() const
+{
+    u32 numThreads = 0;
+    for(auto& event : _events)
+    {
+        if((u32)event.thread + 1 > numThreads)
+        {
+            numThreads = event.thread + 1;
+        }
+    }
+    return numThreads;
+}
+
+size_t AllocationTrace::getMaxAllocationSize() const
+{
+    size_t maxSize = 0;
+    for(auto& event : _events)
+    {
+        maxSize = std::max(maxSize, (size_t)event.size);
+    }
+    return maxSize;
+}
+
+size_t AllocationTrace::getMaxAlignment() const
+{
+    size_t maxAlignment = 0;
+    for(auto& event : _events)
+    {
+        if(event.type == AllocationTraceEvent::ALLOCATE || event.type == AllocationTraceEvent::REALLOCATE)
+        {
+            maxAlignment = std::max(maxAlignment, (size_t)1 << event.alignmentLog2);
+        }
+    }
+    return maxAlignment;
+}
+
+bool AllocationTrace::isLifo() const
+{
+    DebugVector<u32> stack{DebugStlAllocator<u32>()};
+    for(auto& event : _events)
+    {
+        switch(event.type)
+        {
+            case AllocationTraceEvent::ALLOCATE:
+            case AllocationTraceEvent::REALLOCATE:
+                stack.push_back(event.id);
+                break;
+            case AllocationTraceEvent::FREE:
+                if(stack.empty() || stack.back() != event.id)
+                {
+                    return false;
+                }
+                stack.pop_back();
+                break;
+            case AllocationTraceEvent::RESET:
+                stack.clear();
+                break;
+        }
+    }
+    return true;
+}
+
+bool AllocationTrace::save(const char* path) const
+{
+    FILE* pFile = fopen(path, "wb");
+    if(!pFile)
+    {
+        return false;
+    }
+
+    TraceFileHeader header;
+    header.magic = traceMagic;
+    header.version = traceVersion;
+    header.eventSize = sizeof(AllocationTraceEvent);
+    header.reserved = 0;
+    header.numEvents = _events.size();
+
+    bool success = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    if(success && !_events.empty())
+    {
+        success = fwrite(_events.data(), sizeof(AllocationTraceEvent), _events.size(), pFile) == _events.size();
+    }
+
+    return fclose(pFile) == 0 && success;
+}
+
+bool AllocationTrace::load(const char* path)
+{
+    FILE* pFile = fopen(path, "rb");
+    if(!pFile)
+    {
+        return false;
+    }
+
+    TraceFileHeader header;
+    bool success = fread(&header, sizeof(header), 1, pFile) == 1 &&
+                   header.magic == traceMagic &&
+                   header.version == traceVersion &&
+                   header.eventSize == sizeof(AllocationTraceEvent);
+    FS_ASSERT_MSG(success, "File is not a compatible allocation trace.");
+
+    if(success)
+    {
+        _events.resize(header.numEvents);
+        if(header.numEvents > 0)
+        {
+            success = fread(_events.data(), sizeof(AllocationTraceEvent), header.numEvents, pFile) == header.numEvents;
+        }
+    }
+
+    if(!success)
+    {
+        _events.clear();
+    }
+
+    fclose(pFile);
+    return success;
+}
+
+void TraceReplayReport::computeLatencies(DebugVector<u32>& latencies)
+{
+    totalNanoseconds = 0;
+    for(u32 latency : latencies)
+    {
+        totalNanoseconds += latency;
+    }
+    operationsPerSecond = totalNanoseconds > 0 ? (f64)latencies.size() / (totalNanoseconds * 1e-9) : 0;
+
+    if(latencies.empty())
+    {
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](f64 p) -> u64
+    {
+        size_t index = (size_t)(p * (latencies.size() - 1) + 0.5);
+        return latencies[index];
+    };
+
+    latencyP50 = percentile(0.5);
+    latencyP90 = percentile(0.9);
+    latencyP99 = percentile(0.99);
+    latencyP999 = percentile(0.999);
+    latencyMax = latencies.back();
+}
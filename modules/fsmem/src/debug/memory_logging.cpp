@@ -6,6 +6,7 @@
 #include "fsmem/allocators/stl_allocator.h"
 #include "fsmem/debug/arena_report.h"
 #include "fsmem/debug/utils.h"
+#include "fsmem/memory_budget.h"
 
 using namespace fs;
 
@@ -62,4 +63,36 @@ void memory::logArenaReport(const SharedPtr<ArenaReport> report)
     {
         FS_CORE_INFO("    >>> No Allocation Info <<<");
     }
+
+    if(report->firstSubArena)
+    {
+        FS_CORE_INFOF("    Sub-arena Allocations: %u", report->numOfSubArenaAllocations);
+        FS_CORE_INFOF("    Sub-arena Allocated:   %u", report->subArenaAllocated);
+        for(auto subArena = report->firstSubArena; subArena; subArena = subArena->nextSibling)
+        {
+            FS_CORE_INFOF("    Sub-arena of %s:", report->arenaName);
+            logArenaReport(subArena);
+        }
+    }
+}
+
+namespace
+{
+    void logMemoryBudget(const MemoryBudget& budget, void*)
+    {
+        FS_CORE_INFOF("    %s: %u used | %u peak | %u soft | %u hard%s"
+                , budget.getName()
+                , budget.getUsedSize()
+                , budget.getPeakSize()
+                , budget.getSoftLimit()
+                , budget.getHardLimit()
+                , budget.isUnderPressure() ? " | under pressure" : "");
+    }
+}
+
+void memory::logMemoryBudgets()
+{
+    FS_CORE_INFO("logging memory budgets:");
+    logMemoryBudget(getGlobalBudget(), nullptr);
+    visitMemoryBudgets(&logMemoryBudget, nullptr);
 }
@@ -0,0 +1,214 @@
+#include <atomic>
+#include <cstdlib>
+
+#include "fsmem/global_new.h"
+#include "fsmem/adapter.h"
+#include "fsmem/source_info.h"
+
+using namespace fs;
+
+namespace
+{
+    const size_t HEADER_SIZE = 16;
+    const size_t SIZE_CLASS_GRANULARITY = 16;
+    const u32 NUM_SIZE_CLASSES = 16;
+    const u32 MAX_CACHED_BLOCKS_PER_CLASS = 32;
+
+    // Stored immediately before every pointer returned by globalNew. Allocations made
+    // while no arena is set come from malloc and have a null pArena. sizeClass is 0 for
+    // allocations that are too large or too aligned to be cached.
+    struct BlockHeader
+    {
+        IArenaAdapter* pArena;
+        u32 sizeClass;
+        u32 offset;
+    };
+
+    static_assert(sizeof(BlockHeader) == HEADER_SIZE, "BlockHeader must be 16 bytes.");
+
+    struct FreeBlock
+    {
+        FreeBlock* pNext;
+    };
+
+    // Zero initialized and trivially destructible so that it can be used at any point in
+    // the lifetime of a thread, including by destructors that run after the cache was
+    // flushed on exit.
+    struct ThreadCache
+    {
+        IArenaAdapter* pOverride;
+        IArenaAdapter* pArena;
+        FreeBlock* heads[NUM_SIZE_CLASSES];
+        u32 counts[NUM_SIZE_CLASSES];
+        u32 numCached;
+        bool inArena;
+        bool exited;
+    };
+
+    thread_local ThreadCache t_cache;
+
+    class ThreadCacheGuard
+    {
+    public:
+        ~ThreadCacheGuard()
+        {
+            memory::flushGlobalNewCache();
+            t_cache.exited = true;
+        }
+    };
+
+    thread_local ThreadCacheGuard t_cacheGuard;
+
+    std::atomic<IArenaAdapter*> g_pArena(nullptr);
+
+    inline uptr alignUp(uptr value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(uptr)(alignment - 1);
+    }
+
+    inline void* finishBlock(void* pBlock, size_t alignment, IArenaAdapter* pArena, u32 sizeClass)
+    {
+        const uptr user = alignUp((uptr)pBlock + HEADER_SIZE, alignment);
+        BlockHeader* pHeader = reinterpret_cast<BlockHeader*>(user) - 1;
+        pHeader->pArena = pArena;
+        pHeader->sizeClass = sizeClass;
+        pHeader->offset = (u32)(user - (uptr)pBlock);
+        return reinterpret_cast<void*>(user);
+    }
+
+    void freeToArena(IArenaAdapter* pArena, void* pBlock)
+    {
+        // Anything the arena allocates internally goes to malloc instead of back into it.
+        ThreadCache& cache = t_cache;
+        const bool inArena = cache.inArena;
+        cache.inArena = true;
+        pArena->free(pBlock);
+        cache.inArena = inArena;
+    }
+}
+
+void memory::setGlobalNewArena(IArenaAdapter* pArena)
+{
+    flushGlobalNewCache();
+    g_pArena.store(pArena, std::memory_order_release);
+}
+
+IArenaAdapter* memory::getGlobalNewArena()
+{
+    return g_pArena.load(std::memory_order_acquire);
+}
+
+void memory::flushGlobalNewCache()
+{
+    ThreadCache& cache = t_cache;
+    for(u32 i = 0; i < NUM_SIZE_CLASSES; ++i)
+    {
+        while(cache.heads[i])
+        {
+            FreeBlock* pFree = cache.heads[i];
+            cache.heads[i] = pFree->pNext;
+            freeToArena(cache.pArena, reinterpret_cast<u8*>(pFree) - HEADER_SIZE);
+        }
+        cache.counts[i] = 0;
+    }
+
+    cache.numCached = 0;
+    cache.pArena = nullptr;
+}
+
+void* memory::globalNew(size_t size, size_t alignment)
+{
+    ThreadCache& cache = t_cache;
+    IArenaAdapter* pArena = cache.pOverride ? cache.pOverride : g_pArena.load(std::memory_order_acquire);
+    alignment = alignment < HEADER_SIZE ? HEADER_SIZE : alignment;
+
+    if(!pArena || cache.inArena)
+    {
+        // The header may need up to alignment bytes in front of the user pointer since
+        // malloc only guarantees HEADER_SIZE alignment.
+        void* pBlock = malloc(size + alignment);
+        return pBlock ? finishBlock(pBlock, alignment, nullptr, 0) : nullptr;
+    }
+
+    u32 sizeClass = 0;
+    if(alignment == HEADER_SIZE && size <= NUM_SIZE_CLASSES * SIZE_CLASS_GRANULARITY && !cache.exited)
+    {
+        sizeClass = size == 0 ? 1 : (u32)((size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY);
+        size = sizeClass * SIZE_CLASS_GRANULARITY;
+
+        if(cache.pArena == pArena && cache.heads[sizeClass - 1])
+        {
+            FreeBlock* pFree = cache.heads[sizeClass - 1];
+            cache.heads[sizeClass - 1] = pFree->pNext;
+            cache.counts[sizeClass - 1]--;
+            cache.numCached--;
+            return pFree;
+        }
+
+        if(cache.numCached == 0)
+        {
+            cache.pArena = pArena;
+        }
+    }
+
+    cache.inArena = true;
+    void* pBlock = pArena->allocate(size + alignment, alignment, FS_SOURCE_INFO);
+    cache.inArena = false;
+
+    return pBlock ? finishBlock(pBlock, alignment, pArena, sizeClass) : nullptr;
+}
+
+void memory::globalDelete(void* ptr)
+{
+    if(!ptr)
+    {
+        return;
+    }
+
+    BlockHeader* pHeader = reinterpret_cast<BlockHeader*>(ptr) - 1;
+    void* pBlock = reinterpret_cast<u8*>(ptr) - pHeader->offset;
+    IArenaAdapter* pArena = pHeader->pArena;
+
+    if(!pArena)
+    {
+        ::free(pBlock);
+        return;
+    }
+
+    ThreadCache& cache = t_cache;
+    const u32 sizeClass = pHeader->sizeClass;
+    if(sizeClass != 0 && pArena == cache.pArena && !cache.exited && !cache.inArena &&
+       cache.counts[sizeClass - 1] < MAX_CACHED_BLOCKS_PER_CLASS)
+    {
+        // Registers the flush on thread exit the first time a block is cached.
+        (void)&t_cacheGuard;
+
+        FreeBlock* pFree = reinterpret_cast<FreeBlock*>(ptr);
+        pFree->pNext = cache.heads[sizeClass - 1];
+        cache.heads[sizeClass - 1] = pFree;
+        cache.counts[sizeClass - 1]++;
+        cache.numCached++;
+        return;
+    }
+
+    freeToArena(pArena, pBlock);
+}
+
+GlobalNewScope::GlobalNewScope(IArenaAdapter* pArena) :
+    _pArena(pArena),
+    _pPrevious(t_cache.pOverride)
+{
+    t_cache.pOverride = pArena;
+}
+
+GlobalNewScope::~GlobalNewScope()
+{
+    t_cache.pOverride = _pPrevious;
+
+    // The arena of a scope is often short lived. Blocks freed later are returned to it
+    // directly instead of being cached against it.
+    if(t_cache.pArena == _pArena)
+    {
+        memory::flushGlobalNewCache();
+    }
+}
@@ -0,0 +1,194 @@
+#include <mutex>
+
+#include "fsmem/memory_budget.h"
+
+using namespace fs;
+
+namespace
+{
+    class BudgetRegistry
+    {
+    public:
+        std::mutex mutex;
+        MemoryBudget* pFirst = nullptr;
+    };
+
+    BudgetRegistry& getRegistry()
+    {
+        static BudgetRegistry registry;
+        return registry;
+    }
+}
+
+MemoryBudget::MemoryBudget(const char* name, MemoryBudget* pParent) :
+    MemoryBudget(name, pParent, true)
+{
+}
+
+MemoryBudget::MemoryBudget(const char* name, MemoryBudget* pParent, bool registered) :
+    _name(name),
+    _pParent(pParent),
+    _softLimit(0),
+    _hardLimit(0),
+    _used(0),
+    _peak(0),
+    _underPressure(false),
+    _pressurePending(false),
+    _callback(nullptr),
+    _pUserData(nullptr),
+    _registered(registered),
+    _pPrevBudget(nullptr),
+    _pNextBudget(nullptr)
+{
+    if(_registered)
+    {
+        BudgetRegistry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        _pNextBudget = registry.pFirst;
+        if(registry.pFirst)
+        {
+            registry.pFirst->_pPrevBudget = this;
+        }
+        registry.pFirst = this;
+    }
+}
+
+MemoryBudget::~MemoryBudget()
+{
+    // Leaks are reported by the arena. Keep the parent usage correct regardless.
+    if(_pParent)
+    {
+        _pParent->release(getUsedSize());
+    }
+
+    if(_registered)
+    {
+        BudgetRegistry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if(_pPrevBudget)
+        {
+            _pPrevBudget->_pNextBudget = _pNextBudget;
+        }
+        else
+        {
+            registry.pFirst = _pNextBudget;
+        }
+
+        if(_pNextBudget)
+        {
+            _pNextBudget->_pPrevBudget = _pPrevBudget;
+        }
+    }
+}
+
+void MemoryBudget::setLimits(size_t softLimit, size_t hardLimit)
+{
+    FS_ASSERT_MSG(hardLimit == 0 || softLimit <= hardLimit, "Soft limit of a memory budget must not exceed its hard limit.");
+    _softLimit = softLimit;
+    _hardLimit = hardLimit;
+}
+
+void MemoryBudget::setParent(MemoryBudget* pParent)
+{
+    FS_ASSERT_MSG(getUsedSize() == 0, "Cannot change the parent of a memory budget that is in use.");
+    _pParent = pParent;
+}
+
+void MemoryBudget::setPressureCallback(PressureCallback callback, void* pUserData)
+{
+    _callback = callback;
+    _pUserData = pUserData;
+}
+
+MemoryBudget::ChargeResult MemoryBudget::charge(size_t size)
+{
+    bool pressure = false;
+    if(!chargeSelf(size, &pressure))
+    {
+        return ChargeResult::Exceeded;
+    }
+
+    if(_pParent)
+    {
+        const ChargeResult result = _pParent->charge(size);
+        if(result == ChargeResult::Exceeded)
+        {
+            releaseSelf(size);
+            return ChargeResult::Exceeded;
+        }
+
+        pressure = pressure || result == ChargeResult::Pressure;
+    }
+
+    return pressure ? ChargeResult::Pressure : ChargeResult::Charged;
+}
+
+void MemoryBudget::release(size_t size)
+{
+    releaseSelf(size);
+    if(_pParent)
+    {
+        _pParent->release(size);
+    }
+}
+
+void MemoryBudget::signalPressure()
+{
+    if(_pressurePending.exchange(false, std::memory_order_acquire) && _callback)
+    {
+        _callback(_pUserData, *this);
+    }
+
+    if(_pParent)
+    {
+        _pParent->signalPressure();
+    }
+}
+
+bool MemoryBudget::chargeSelf(size_t size, bool* pPressure)
+{
+    const size_t used = _used.fetch_add(size, std::memory_order_relaxed) + size;
+    if(_hardLimit != 0 && used > _hardLimit)
+    {
+        _used.fetch_sub(size, std::memory_order_relaxed);
+        _pressurePending.store(true, std::memory_order_release);
+        return false;
+    }
+
+    size_t peak = _peak.load(std::memory_order_relaxed);
+    while(used > peak && !_peak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+
+    if(_softLimit != 0 && used > _softLimit && !_underPressure.exchange(true, std::memory_order_relaxed))
+    {
+        _pressurePending.store(true, std::memory_order_release);
+        *pPressure = true;
+    }
+
+    return true;
+}
+
+void MemoryBudget::releaseSelf(size_t size)
+{
+    const size_t used = _used.fetch_sub(size, std::memory_order_relaxed);
+    FS_ASSERT_MSG(used >= size, "Released more memory than was charged to the budget.");
+    if(used - size <= _softLimit)
+    {
+        _underPressure.store(false, std::memory_order_relaxed);
+    }
+}
+
+MemoryBudget& memory::getGlobalBudget()
+{
+    static MemoryBudget budget("Global", nullptr, false);
+    return budget;
+}
+
+void memory::visitMemoryBudgets(void (*visitor)(const MemoryBudget& budget, void* pUserData), void* pUserData)
+{
+    BudgetRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(const MemoryBudget* pBudget = registry.pFirst; pBudget; pBudget = pBudget->_pNextBudget)
+    {
+        visitor(*pBudget, pUserData);
+    }
+}
@@ -0,0 +1,42 @@
+#include "fsmem/policies/thread_policy.h"
+
+#ifdef LINUX
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif
+
+#include "fscore/types.h"
+
+using namespace fs;
+
+namespace fs
+{
+namespace internal
+{
+    static_assert(sizeof(std::atomic<u32>) == sizeof(u32), "futex requires std::atomic<u32> to be a plain 32bit word.");
+
+    template<>
+    void ThreadParking<PLATFORM_ID>::wait(std::atomic<u32>* pAddress, u32 expected)
+    {
+#ifdef LINUX
+        syscall(SYS_futex, reinterpret_cast<u32*>(pAddress), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        if(pAddress->load(std::memory_order_relaxed) == expected)
+        {
+            std::this_thread::yield();
+        }
+#endif
+    }
+
+    template<>
+    void ThreadParking<PLATFORM_ID>::wakeOne(std::atomic<u32>* pAddress)
+    {
+#ifdef LINUX
+        syscall(SYS_futex, reinterpret_cast<u32*>(pAddress), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        (void)pAddress;
+#endif
+    }
+}
+}
@@ -0,0 +1,6 @@
+#include "fsmem/policies/thread_policy.h"
+
+using namespace fs;
+using namespace fs::internal;
+
+static_assert(false, "Windows implementation of thread parking is not yet provided.");
@@ -0,0 +1,103 @@
+#include "fscore/assert.h"
+#include "fsmem/policies/trace_memory_tracking_policy.h"
+#include "fsmem/utils.h"
+
+using namespace fs;
+using namespace std::chrono;
+
+TraceMemoryTracking::TraceMemoryTracking() :
+    _liveAllocations(DebugMapAllocator<uptr, u32>()),
+    _threads(DebugMapAllocator<std::thread::id, u16>()),
+    _start(steady_clock::now()),
+    _nextId(0)
+{
+}
+
+void TraceMemoryTracking::onAllocation(void* ptr, size_t size, size_t alignment, const SourceInfo& info)
+{
+    SimpleMemoryTracking::onAllocation(ptr, size, alignment, info);
+
+    FS_ASSERT_MSG(size <= 0xFFFFFFFF, "Allocation is too large to be traced.");
+    FS_ASSERT(bitUtil::isPowerOfTwo(alignment));
+
+    AllocationTraceEvent event;
+    event.type = AllocationTraceEvent::ALLOCATE;
+    event.alignmentLog2 = (u8)bitUtil::log2(alignment);
+    event.thread = getThreadIndex();
+    event.id = _nextId++;
+    event.relatedId = 0;
+    event.size = (u32)size;
+    event.timestamp = now();
+    event.lifetime = 0;
+
+    if(!_liveAllocations.insert(std::make_pair((uptr)ptr, (u32)_trace.getNumEvents())).second)
+    {
+        FS_ASSERT(!"Allocation already traced. Must be deallocated before being traced again.");
+    }
+    _trace.push(event);
+}
+
+void TraceMemoryTracking::onDeallocation(void* ptr, size_t size)
+{
+    SimpleMemoryTracking::onDeallocation(ptr, size);
+
+    auto iter = _liveAllocations.find((uptr)ptr);
+    FS_ASSERT_MSG(iter != _liveAllocations.end(),
+                  "Could not find allocation in trace. It was never tracked. Invalid free?");
+
+    AllocationTraceEvent& allocation = _trace[iter->second];
+    _liveAllocations.erase(iter);
+
+    AllocationTraceEvent event;
+    event.type = AllocationTraceEvent::FREE;
+    event.alignmentLog2 = allocation.alignmentLog2;
+    event.thread = getThreadIndex();
+    event.id = allocation.id;
+    event.relatedId = 0;
+    event.size = allocation.size;
+    event.timestamp = now();
+    event.lifetime = event.timestamp - allocation.timestamp;
+
+    allocation.lifetime = event.lifetime;
+    _trace.push(event);
+}
+
+void TraceMemoryTracking::onReallocation(void* ptr, void* newPtr)
+{
+    auto oldIter = _liveAllocations.find((uptr)ptr);
+    auto newIter = _liveAllocations.find((uptr)newPtr);
+    FS_ASSERT_MSG(oldIter != _liveAllocations.end() && newIter != _liveAllocations.end(),
+                  "Both allocations must be live when a reallocation is traced.");
+
+    AllocationTraceEvent& allocation = _trace[newIter->second];
+    allocation.type = AllocationTraceEvent::REALLOCATE;
+    allocation.relatedId = _trace[oldIter->second].id;
+}
+
+void TraceMemoryTracking::reset()
+{
+    SimpleMemoryTracking::reset();
+    _liveAllocations.clear();
+
+    AllocationTraceEvent event;
+    event.type = AllocationTraceEvent::RESET;
+    event.alignmentLog2 = 0;
+    event.thread = getThreadIndex();
+    event.id = 0;
+    event.relatedId = 0;
+    event.size = 0;
+    event.timestamp = now();
+    event.lifetime = 0;
+    _trace.push(event);
+}
+
+u64 TraceMemoryTracking::now() const
+{
+    return (u64)duration_cast<nanoseconds>(steady_clock::now() - _start).count();
+}
+
+u16 TraceMemoryTracking::getThreadIndex()
+{
+    auto result = _threads.insert(std::make_pair(std::this_thread::get_id(), (u16)_threads.size()));
+    return result.first->second;
+}
@@ -0,0 +1,55 @@
+#include "fsmem/scratch_arena.h"
+
+#ifndef FS_SCRATCH_ARENA_SIZE
+#define FS_SCRATCH_ARENA_SIZE 64 * 1024 * 1024
+#endif
+
+#ifndef FS_SCRATCH_ARENA_INITIAL_SIZE
+#define FS_SCRATCH_ARENA_INITIAL_SIZE 64 * 1024
+#endif
+
+using namespace fs;
+
+namespace
+{
+    class ThreadScratchArenas
+    {
+    public:
+        ThreadScratchArenas() :
+            first(FS_SCRATCH_ARENA_INITIAL_SIZE, FS_SCRATCH_ARENA_SIZE, "ScratchArena0"),
+            second(FS_SCRATCH_ARENA_INITIAL_SIZE, FS_SCRATCH_ARENA_SIZE, "ScratchArena1")
+        {
+        }
+
+        ScratchArena first;
+        ScratchArena second;
+    };
+}
+
+ScratchArena::ScratchArena(size_t initialSize, size_t maxSize, const char* name) :
+    _stack(initialSize, maxSize),
+    _name(name),
+    _numScopes(0)
+{
+}
+
+ScratchScope::ScratchScope(const ScratchArena* pConflict) :
+    _pArena(&memory::getScratchArena(pConflict))
+{
+    _marker = _pArena->getMarker();
+    _depth = _pArena->_numScopes++;
+}
+
+ScratchScope::~ScratchScope()
+{
+    FS_ASSERT_MSG(_pArena->_numScopes == _depth + 1,
+                  "ScratchScopes on the same arena must exit in reverse order.");
+    _pArena->_numScopes = _depth;
+    _pArena->rewind(_marker);
+}
+
+ScratchArena& memory::getScratchArena(const ScratchArena* pConflict)
+{
+    static thread_local ThreadScratchArenas arenas;
+    return pConflict == &arenas.first ? arenas.second : arenas.first;
+}
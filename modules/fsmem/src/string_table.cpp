@@ -0,0 +1,97 @@
+#include "fsmem/string_table.h"
+
+#include <cstring>
+
+#include "fscore/assert.h"
+#include "fsmem/debug/memory.h"
+
+#ifndef FS_STRING_TABLE_SIZE
+#define FS_STRING_TABLE_SIZE 1024 * 1024
+#endif
+
+using namespace fs;
+
+namespace
+{
+    // The table serializes access itself so the arena does not need a lock.
+    using StringTableArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                         SingleThread,
+                                         NoBoundsChecking,
+                                         NoMemoryTracking,
+                                         NoMemoryTagging>;
+}
+
+StringTable::StringTable(IArenaAdapter* pArena) :
+    _pArena(pArena),
+    _strings(pArena)
+{
+    FS_ASSERT(pArena);
+}
+
+StringTable::~StringTable()
+{
+    for(auto& pair : _strings)
+    {
+        _pArena->free(const_cast<char*>(pair.second));
+    }
+}
+
+u32 StringTable::intern(const char* pString)
+{
+    FS_ASSERT(pString);
+    return intern(HashedString(pString));
+}
+
+u32 StringTable::intern(const HashedString& string)
+{
+    const u32 id = string.getHashValue();
+
+    const char* pExisting = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _strings.find(id);
+        if(iter != _strings.end())
+        {
+            pExisting = iter->second;
+        }
+        else
+        {
+            const size_t size = std::strlen(string.getString()) + 1;
+            char* pCopy = static_cast<char*>(_pArena->allocate(size, 1, FS_SOURCE_INFO));
+            FS_ASSERT_MSG(pCopy, "StringTable failed to allocate memory.");
+            std::memcpy(pCopy, string.getString(), size);
+            _strings.emplace(id, pCopy);
+        }
+    }
+
+    // A failed assert logs and the logger may look up strings, so assert without the lock.
+    // Copies live as long as the table so the pointer is still valid.
+    if(pExisting)
+    {
+        FS_ASSERT_MSG_FORMATTED(std::strcmp(pExisting, string.getString()) == 0,
+                                "'%s' and '%s' have the same id 0x%08x.",
+                                pExisting, string.getString(), id);
+    }
+    return id;
+}
+
+const char* StringTable::lookup(u32 id) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _strings.find(id);
+    return iter != _strings.end() ? iter->second : nullptr;
+}
+
+size_t StringTable::getNumStrings() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _strings.size();
+}
+
+StringTable& memory::getStringTable()
+{
+    static StringTableArena arena((size_t)(FS_STRING_TABLE_SIZE), "StringTableArena");
+    static ArenaAdapter<StringTableArena> adapter(&arena);
+    static StringTable table(&adapter);
+    return table;
+}
@@ -1,3 +1,6 @@
+#include <fcntl.h>
+#include <stdio.h>
+
 #include "fsmem/utils.h"
 #include "fscore/types.h"
 
@@ -92,5 +95,81 @@ namespace internal
                                     , ptr , size , errno);
         }
     }
+
+    // Shared memory object backing both halves of a mirrored mapping. The name is removed
+    // straight away so the memory is released when the last mapping goes away.
+    static int createSharedMemory(size_t size)
+    {
+#ifdef __linux__
+        int fd = memfd_create("fs_mirrored", MFD_CLOEXEC);
+#else
+        char name[64];
+        static std::atomic<u32> counter(0);
+        snprintf(name, sizeof(name), "/fs_mirrored_%d_%u", (int)getpid(), counter++);
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(fd != -1)
+        {
+            shm_unlink(name);
+        }
+#endif
+        if(fd != -1 && ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    template<>
+    void* VirtualMemory<PLATFORM_ID>::allocateMirroredMemory(size_t size)
+    {
+        FS_ASSERT(size > 0 && size % getPageSize() == 0);
+
+        int fd = createSharedMemory(size);
+        if(fd == -1)
+        {
+            FS_ASSERT_MSG_FORMATTED(false,
+                                    "Failed to create shared memory of size %u. errno: %i"
+                                    , size , errno);
+            return nullptr;
+        }
+
+        // Reserve both halves first so nothing else can be mapped in between.
+        u8* ptr = static_cast<u8*>(mmap(nullptr, size * 2, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0));
+        if(ptr == MAP_FAILED)
+        {
+            FS_ASSERT_MSG_FORMATTED(false,
+                                    "Failed to reserve mirrored size %u. errno: %i"
+                                    , size , errno);
+            close(fd);
+            return nullptr;
+        }
+
+        void* first = mmap(ptr, size, PROT_READ|PROT_WRITE, MAP_FIXED|MAP_SHARED, fd, 0);
+        void* second = mmap(ptr + size, size, PROT_READ|PROT_WRITE, MAP_FIXED|MAP_SHARED, fd, 0);
+        close(fd);
+
+        if(first == MAP_FAILED || second == MAP_FAILED)
+        {
+            FS_ASSERT_MSG_FORMATTED(false,
+                                    "Failed to map mirrored size %u. errno: %i"
+                                    , size , errno);
+            munmap(ptr, size * 2);
+            return nullptr;
+        }
+
+        return ptr;
+    }
+
+    template<>
+    void VirtualMemory<PLATFORM_ID>::freeMirroredMemory(void* ptr, size_t size)
+    {
+        if(munmap(ptr, size * 2))
+        {
+            FS_ASSERT_MSG_FORMATTED(false,
+                                    "Failed to release mirrored ptr %p of size %u. errno: %i"
+                                    , ptr , size , errno);
+        }
+    }
 }
 }
@@ -0,0 +1,29 @@
+#ifndef FS_CONTAINER_FIXTURE_H
+#define FS_CONTAINER_FIXTURE_H
+
+#include "fscore.h"
+#include "fsmem.h"
+
+// Arena used by the container, string table and smart pointer tests. The arena asserts
+// on leaks when the fixture is destroyed, so every test also checks that its container
+// released all of its memory.
+struct ContainerFixture
+{
+    using ContainerArena = fs::MemoryArena<fs::Allocator<fs::HeapAllocator, fs::AllocationHeaderU32>,
+                                           fs::SingleThread, fs::SimpleBoundsChecking, fs::SimpleMemoryTracking,
+                                           fs::MemoryTagging>;
+
+    ContainerFixture() :
+        area(1024 * 1024),
+        arena(area, "ContainerArena"),
+        adapter(&arena)
+    {
+    }
+
+    // Order below matters for allocation deallocation order
+    fs::HeapArea area;
+    ContainerArena arena;
+    fs::ArenaAdapter<ContainerArena> adapter;
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdio.h>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct AllocationTraceFixture
+{
+    using TracedArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                    SingleThread, NoBoundsChecking, TraceMemoryTracking, NoMemoryTagging>;
+
+    AllocationTraceFixture() :
+        area(VirtualMemory::getPageSize() * 16)
+    {
+    }
+
+    ~AllocationTraceFixture()
+    {
+
+    }
+
+    HeapArea area;
+};
+
+BOOST_FIXTURE_TEST_SUITE(allocation_trace, AllocationTraceFixture)
+
+BOOST_AUTO_TEST_CASE(record_events)
+{
+    TracedArena arena(area);
+    const size_t headerSize = AllocationHeaderU32::SIZE;
+
+    void* a = arena.allocate(32, 8, FS_SOURCE_INFO);
+    void* b = arena.allocate(64, 16, FS_SOURCE_INFO);
+    arena.free(a);
+    b = arena.reallocate(b, 128, 16, FS_SOURCE_INFO);
+    arena.free(b);
+
+    const AllocationTrace& trace = arena.getMemoryTracker().getTrace();
+    BOOST_REQUIRE(trace.getNumEvents() == 6);
+
+    BOOST_CHECK(trace[0].type == AllocationTraceEvent::ALLOCATE);
+    BOOST_CHECK(trace[0].id == 0);
+    BOOST_CHECK(trace[0].size == 32 + headerSize);
+    BOOST_CHECK(trace[0].alignmentLog2 == 3);
+    BOOST_CHECK(trace[0].thread == 0);
+
+    BOOST_CHECK(trace[1].type == AllocationTraceEvent::ALLOCATE);
+    BOOST_CHECK(trace[1].id == 1);
+    BOOST_CHECK(trace[1].alignmentLog2 == 4);
+
+    BOOST_CHECK(trace[2].type == AllocationTraceEvent::FREE);
+    BOOST_CHECK(trace[2].id == 0);
+    BOOST_CHECK(trace[2].lifetime == trace[2].timestamp - trace[0].timestamp);
+    BOOST_CHECK(trace[0].lifetime == trace[2].lifetime);
+
+    BOOST_CHECK(trace[3].type == AllocationTraceEvent::REALLOCATE);
+    BOOST_CHECK(trace[3].id == 2);
+    BOOST_CHECK(trace[3].relatedId == 1);
+    BOOST_CHECK(trace[3].size == 128 + headerSize);
+
+    BOOST_CHECK(trace[4].type == AllocationTraceEvent::FREE);
+    BOOST_CHECK(trace[4].id == 1);
+    BOOST_CHECK(trace[5].type == AllocationTraceEvent::FREE);
+    BOOST_CHECK(trace[5].id == 2);
+
+    BOOST_CHECK(trace.getIdRange() == 3);
+    BOOST_CHECK(trace.getNumThreads() == 1);
+    BOOST_CHECK(trace.getMaxAlignment() == 16);
+    BOOST_CHECK(!trace.isLifo());
+}
+
+BOOST_AUTO_TEST_CASE(record_reset)
+{
+    TracedArena arena(area);
+    arena.allocate(32, 8, FS_SOURCE_INFO);
+    arena.reset();
+    void* ptr = arena.allocate(32, 8, FS_SOURCE_INFO);
+    arena.free(ptr);
+
+    const AllocationTrace& trace = arena.getMemoryTracker().getTrace();
+    BOOST_REQUIRE(trace.getNumEvents() == 4);
+    BOOST_CHECK(trace[1].type == AllocationTraceEvent::RESET);
+    BOOST_CHECK(trace[0].lifetime == 0);
+    BOOST_CHECK(trace[2].id == 1);
+    BOOST_CHECK(trace.isLifo());
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+    TracedArena arena(area);
+    void* a = arena.allocate(32, 8, FS_SOURCE_INFO);
+    void* b = arena.allocate(48, 8, FS_SOURCE_INFO);
+    arena.free(b);
+    arena.free(a);
+
+    const AllocationTrace& trace = arena.getMemoryTracker().getTrace();
+    const char* path = "fsmem_test_allocation_trace.bin";
+    BOOST_REQUIRE(trace.save(path));
+
+    AllocationTrace loaded;
+    BOOST_REQUIRE(loaded.load(path));
+    remove(path);
+
+    BOOST_REQUIRE(loaded.getNumEvents() == trace.getNumEvents());
+    for(size_t i = 0; i < trace.getNumEvents(); ++i)
+    {
+        BOOST_CHECK(memcmp(&loaded[i], &trace[i], sizeof(AllocationTraceEvent)) == 0);
+    }
+    BOOST_CHECK(loaded.isLifo());
+}
+
+BOOST_AUTO_TEST_CASE(replay)
+{
+    TracedArena arena(area);
+    void* ptrs[16];
+    for(u32 i = 0; i < 16; ++i)
+    {
+        ptrs[i] = arena.allocate(16 * (i + 1), 8, FS_SOURCE_INFO);
+    }
+    ptrs[3] = arena.reallocate(ptrs[3], 512, 8, FS_SOURCE_INFO);
+    for(u32 i = 0; i < 16; i += 2)
+    {
+        arena.free(ptrs[i]);
+    }
+    for(u32 i = 1; i < 16; i += 2)
+    {
+        arena.free(ptrs[i]);
+    }
+
+    const AllocationTrace& trace = arena.getMemoryTracker().getTrace();
+
+    HeapArea replayArea(VirtualMemory::getPageSize() * 16);
+    HeapAllocator allocator(replayArea.getStart(), replayArea.getEnd());
+    const size_t initialUsedSize = allocator.getTotalUsedSize();
+    TraceReplayReport report;
+    fs::memory::replayTrace(trace, allocator, report);
+
+    BOOST_CHECK(report.numAllocations == 16);
+    BOOST_CHECK(report.numReallocations == 1);
+    BOOST_CHECK(report.numFrees == 17);
+    BOOST_CHECK(report.numFailedAllocations == 0);
+    BOOST_CHECK(report.peakLiveSize > 0);
+    BOOST_CHECK(report.peakUsedSize >= report.peakLiveSize);
+    BOOST_CHECK(report.fragmentation >= 0.0f && report.fragmentation < 1.0f);
+    BOOST_CHECK(report.latencyP50 <= report.latencyP99);
+    BOOST_CHECK(report.latencyP99 <= report.latencyMax);
+    BOOST_CHECK(allocator.getTotalUsedSize() == initialUsedSize);
+}
+
+BOOST_AUTO_TEST_CASE(replay_lifo_on_stack)
+{
+    TracedArena arena(area);
+    void* a = arena.allocate(32, 8, FS_SOURCE_INFO);
+    void* b = arena.allocate(64, 8, FS_SOURCE_INFO);
+    arena.free(b);
+    arena.free(a);
+
+    const AllocationTrace& trace = arena.getMemoryTracker().getTrace();
+    BOOST_REQUIRE(trace.isLifo());
+
+    HeapArea replayArea(VirtualMemory::getPageSize());
+    StackAllocatorBottom allocator(replayArea.getStart(), replayArea.getEnd());
+    TraceReplayReport report;
+    fs::memory::replayTrace(trace, allocator, report);
+
+    BOOST_CHECK(report.numFailedAllocations == 0);
+    BOOST_CHECK(allocator.getTotalUsedSize() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdio.h>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct ArenaImageFixture
+{
+    using ImageArena = MemoryArena<Allocator<LinearAllocator, NoAllocationHeader>,
+                                   SingleThread, NoBoundsChecking, NoMemoryTracking, NoMemoryTagging>;
+
+    struct Entry
+    {
+        u32 key;
+        RelativePtr<const char> name;
+        RelativePtr<Entry> next;
+    };
+
+    struct Root
+    {
+        u32 numEntries;
+        RelativePtr<Entry> first;
+    };
+
+    ArenaImageFixture() :
+        area(4096)
+    {
+    }
+
+    // Read the whole file into page aligned memory like a mapping of the file would be.
+    void* readFile(const char* path, size_t& size)
+    {
+        FILE* pFile = fopen(path, "rb");
+        BOOST_REQUIRE(pFile);
+        fseek(pFile, 0, SEEK_END);
+        size = ftell(pFile);
+        fseek(pFile, 0, SEEK_SET);
+
+        mappedSize = bitUtil::roundUpToMultiple(size, VirtualMemory::getPageSize());
+        void* data = VirtualMemory::allocatePhysicalMemory(mappedSize);
+        BOOST_REQUIRE(fread(data, size, 1, pFile) == 1);
+        fclose(pFile);
+        return data;
+    }
+
+    HeapArea area;
+    size_t mappedSize = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(arena_image, ArenaImageFixture)
+
+BOOST_AUTO_TEST_CASE(relative_ptr)
+{
+    u32 values[2] = {1, 2};
+    RelativePtr<u32> ptr;
+    BOOST_CHECK(!ptr);
+    BOOST_CHECK(ptr.get() == nullptr);
+
+    ptr = &values[1];
+    BOOST_CHECK(ptr);
+    BOOST_CHECK(*ptr == 2);
+
+    // Copies point to the same object from their new location.
+    RelativePtr<u32> copy(ptr);
+    BOOST_CHECK(copy.get() == &values[1]);
+    copy = nullptr;
+    BOOST_CHECK(!copy);
+}
+
+BOOST_AUTO_TEST_CASE(save_and_open)
+{
+    static const char* names[] = {"alpha", "beta", "gamma"};
+    const char* path = "fsmem_test_arena_image.bin";
+
+    {
+        ImageArena arena(area, "ImageArena");
+        Root* root = new(arena.allocate(sizeof(Root), 64, FS_SOURCE_INFO)) Root();
+        root->numEntries = 3;
+
+        RelativePtr<Entry>* link = &root->first;
+        for(u32 i = 0; i < 3; ++i)
+        {
+            const size_t length = strlen(names[i]) + 1;
+            char* name = static_cast<char*>(arena.allocate(length, 1, FS_SOURCE_INFO));
+            memcpy(name, names[i], length);
+
+            Entry* entry = new(arena.allocate(sizeof(Entry), alignof(Entry), FS_SOURCE_INFO)) Entry();
+            entry->key = i * 10;
+            entry->name = name;
+            *link = entry;
+            link = &entry->next;
+        }
+
+        BOOST_REQUIRE(fs::memory::saveArenaImage(path, arena, root));
+        arena.reset();
+    }
+
+    size_t size;
+    void* data = readFile(path, size);
+
+    ArenaImage image;
+    BOOST_REQUIRE(image.open(data, size));
+    const Root* root = image.getRoot<Root>();
+    BOOST_CHECK((uptr)root % 64 == 0);
+    BOOST_REQUIRE(root->numEntries == 3);
+
+    u32 i = 0;
+    for(const Entry* entry = root->first.get(); entry; entry = entry->next.get(), ++i)
+    {
+        BOOST_CHECK(entry->key == i * 10);
+        BOOST_CHECK(strcmp(entry->name.get(), names[i]) == 0);
+        BOOST_CHECK((uptr)entry >= (uptr)image.getData());
+        BOOST_CHECK((uptr)entry < (uptr)image.getData() + image.getDataSize());
+    }
+    BOOST_CHECK(i == 3);
+
+    // Corrupt header.
+    static_cast<ArenaImageHeader*>(data)->magic = 0;
+    FS_REQUIRE_ASSERT([&](){ image.open(data, size); });
+    BOOST_CHECK(!image.open(data, sizeof(ArenaImageHeader) - 1));
+
+    VirtualMemory::releaseAddressSpace(data, mappedSize);
+    remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct ArenaUniquePtrFixture : ContainerFixture
+{
+    struct Base
+    {
+        virtual ~Base() {}
+        virtual u32 getValue() const { return 0; }
+    };
+
+    struct Derived : public Base
+    {
+        Derived(u32 value, u32* pNumDestroyed) :
+            value(value),
+            pNumDestroyed(pNumDestroyed)
+        {
+        }
+
+        ~Derived()
+        {
+            ++*pNumDestroyed;
+        }
+
+        virtual u32 getValue() const override { return value; }
+
+        u32 value;
+        u32* pNumDestroyed;
+    };
+
+    ArenaUniquePtrFixture() :
+        numDestroyed(0)
+    {
+    }
+
+    u32 numDestroyed;
+};
+
+BOOST_FIXTURE_TEST_SUITE(arena_unique_ptr, ArenaUniquePtrFixture)
+
+BOOST_AUTO_TEST_CASE(deletes_from_arena)
+{
+    static_assert(sizeof(ArenaUniquePtr<u32, ContainerArena>) == 2 * sizeof(void*),
+                  "The deleter should only hold the arena.");
+
+    {
+        auto pValue = makeArenaUnique<Derived>(&arena, 5u, &numDestroyed);
+        BOOST_CHECK(pValue->value == 5);
+        BOOST_CHECK(arena.getNumAllocations() == 1);
+
+        auto pMoved = std::move(pValue);
+        BOOST_CHECK(!pValue);
+        BOOST_CHECK(pMoved.get_deleter().getArena() == &arena);
+    }
+    BOOST_CHECK(numDestroyed == 1);
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(converts_to_base)
+{
+    ArenaUniquePtr<Base, ContainerArena> pBase = makeArenaUnique<Derived>(&arena, 7u, &numDestroyed);
+    BOOST_CHECK(pBase->getValue() == 7);
+
+    pBase.reset();
+    BOOST_CHECK(numDestroyed == 1);
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
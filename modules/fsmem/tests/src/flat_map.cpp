@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_FIXTURE_TEST_SUITE(flat_map, ContainerFixture)
+
+BOOST_AUTO_TEST_CASE(insert_find_erase)
+{
+    FlatMap<u32, std::string, ContainerArena> map(&arena);
+
+    BOOST_CHECK(map.insert(std::make_pair(3u, std::string("three"))).second);
+    BOOST_CHECK(map.emplace(1u, "one").second);
+    BOOST_CHECK(map.emplace(2u, "two").second);
+    BOOST_CHECK(!map.emplace(2u, "duplicate").second);
+    map[5] = "five";
+
+    BOOST_REQUIRE(map.size() == 4);
+    BOOST_CHECK(map.at(2) == "two");
+    BOOST_CHECK(map.find(4) == map.end());
+    BOOST_CHECK(map.count(5) == 1);
+
+    // Sorted by key.
+    u32 previous = 0;
+    for(auto& pair : map)
+    {
+        BOOST_CHECK(pair.first > previous);
+        previous = pair.first;
+    }
+
+    BOOST_CHECK(map.erase(1) == 1);
+    BOOST_CHECK(map.erase(1) == 0);
+    BOOST_CHECK(map.begin()->first == 2);
+
+    // Small maps do not allocate.
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(c_string_keys)
+{
+    FlatMap<const char*, u32, ContainerArena, CompareCString, 2> map(&arena);
+    map["gzip"] = 1;
+    map["disk"] = 2;
+    map["zip"] = 3;
+
+    std::string key("disk");
+    BOOST_CHECK(map.at(key.c_str()) == 2);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(flat_set)
+{
+    FlatSet<u32, ContainerArena> set(&arena);
+    BOOST_CHECK(set.insert(5).second);
+    BOOST_CHECK(set.insert(1).second);
+    BOOST_CHECK(set.insert(3).second);
+    BOOST_CHECK(!set.insert(3).second);
+
+    BOOST_REQUIRE(set.size() == 3);
+    BOOST_CHECK(*set.begin() == 1);
+    BOOST_CHECK(set.count(3) == 1);
+    BOOST_CHECK(set.erase(3) == 1);
+    BOOST_CHECK(set.find(3) == set.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
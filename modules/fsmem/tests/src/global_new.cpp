@@ -0,0 +1,151 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+// Replaces operator new for the whole test executable. Without a global arena every
+// allocation goes to malloc so the other tests are unaffected.
+FS_IMPLEMENT_GLOBAL_NEW
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct GlobalNewFixture
+{
+    using NewArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                 MultiThread<MutexPrimitive>, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    GlobalNewFixture() :
+        area(256 * 1024),
+        arena(area, "GlobalNewArena"),
+        adapter(&arena),
+        otherArea(64 * 1024),
+        otherArena(otherArea, "OtherNewArena"),
+        otherAdapter(&otherArena)
+    {
+    }
+
+    ~GlobalNewFixture()
+    {
+        fs::memory::setGlobalNewArena(nullptr);
+    }
+
+    HeapArea area;
+    NewArena arena;
+    ArenaAdapter<NewArena> adapter;
+    HeapArea otherArea;
+    NewArena otherArena;
+    ArenaAdapter<NewArena> otherAdapter;
+};
+
+BOOST_FIXTURE_TEST_SUITE(global_new, GlobalNewFixture)
+
+// Checks are made after routing is turned off so that Boost does not allocate from the
+// arenas under test.
+
+BOOST_AUTO_TEST_CASE(malloc_without_arena)
+{
+    int* pValue = new int(5);
+    BOOST_CHECK(*pValue == 5);
+    BOOST_CHECK((uptr)pValue % fs::memory::GLOBAL_NEW_ALIGNMENT == 0);
+    delete pValue;
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(route_to_arena_and_cache)
+{
+    fs::memory::setGlobalNewArena(&adapter);
+    int* pFirst = new int(1);
+    const size_t numAfterNew = arena.getNumAllocations();
+    delete pFirst;
+    const size_t numAfterDelete = arena.getNumAllocations();
+    int* pSecond = new int(2);
+    delete pSecond;
+
+    char* pLarge = new char[4096];
+    const size_t numAfterLarge = arena.getNumAllocations();
+    delete[] pLarge;
+    const size_t numAfterLargeDelete = arena.getNumAllocations();
+    fs::memory::setGlobalNewArena(nullptr);
+
+    BOOST_CHECK(numAfterNew == 1);
+    // Small blocks are cached by the thread and reused.
+    BOOST_CHECK(numAfterDelete == 1);
+    BOOST_CHECK(pSecond == pFirst);
+    // Large blocks are returned immediately.
+    BOOST_CHECK(numAfterLarge == 2);
+    BOOST_CHECK(numAfterLargeDelete == 1);
+    // Changing the arena flushed the cache.
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(scope_overrides_global_arena)
+{
+    fs::memory::setGlobalNewArena(&adapter);
+    std::vector<int>* pVector = nullptr;
+    size_t numOther = 0;
+    {
+        GlobalNewScope scope(&otherAdapter);
+        pVector = new std::vector<int>(100, 7);
+        numOther = otherArena.getNumAllocations();
+
+        // Cached for the scope's arena until the scope exits.
+        delete new int(3);
+    }
+    const size_t numGlobal = arena.getNumAllocations();
+    const size_t numOtherAfterScope = otherArena.getNumAllocations();
+
+    // Freed to the arena it came from regardless of the current scope.
+    delete pVector;
+    const size_t numOtherAfterDelete = otherArena.getNumAllocations();
+    fs::memory::setGlobalNewArena(nullptr);
+
+    BOOST_CHECK(numOther == 2);
+    BOOST_CHECK(numGlobal == 0);
+    BOOST_CHECK(numOtherAfterScope == 2);
+    BOOST_CHECK(numOtherAfterDelete == 0);
+}
+
+BOOST_AUTO_TEST_CASE(aligned_allocation)
+{
+    fs::memory::setGlobalNewArena(&adapter);
+    void* ptr = fs::memory::globalNew(100, 128);
+    const size_t numAllocations = arena.getNumAllocations();
+    fs::memory::globalDelete(ptr);
+    fs::memory::setGlobalNewArena(nullptr);
+
+    void* pMalloc = fs::memory::globalNew(100, 128);
+    fs::memory::globalDelete(pMalloc);
+
+    BOOST_CHECK((uptr)ptr % 128 == 0);
+    BOOST_CHECK((uptr)pMalloc % 128 == 0);
+    BOOST_CHECK(numAllocations == 1);
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(thread_exit_flushes_cache)
+{
+    fs::memory::setGlobalNewArena(&adapter);
+    std::thread thread([]()
+    {
+        for(u32 i = 0; i < 10; ++i)
+        {
+            delete new int(i);
+        }
+    });
+    thread.join();
+    const size_t numAllocations = arena.getNumAllocations();
+    fs::memory::setGlobalNewArena(nullptr);
+
+    BOOST_CHECK(numAllocations == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
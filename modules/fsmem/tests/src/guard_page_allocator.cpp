@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct GuardPageAllocatorFixture
+{
+    using ArenaWithGuardPages = MemoryArena<Allocator<GuardPageAllocator, AllocationHeaderU32>,
+                                            SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    // Run func in a child process and return true if it was killed by a segfault.
+    template<class Func>
+    bool faults(Func func)
+    {
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            // Boost.Test catches signals in the forked test runner as well.
+            signal(SIGSEGV, SIG_DFL);
+            func();
+            _exit(0);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(guard_page_allocator, GuardPageAllocatorFixture)
+
+BOOST_AUTO_TEST_CASE(allocate_and_free)
+{
+    GuardPageAllocator allocator;
+    const size_t pageSize = VirtualMemory::getPageSize();
+
+    u8* ptr = static_cast<u8*>(allocator.allocate(100, 1, 0));
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(((uptr)ptr + 100) % pageSize == 0);
+    memset(ptr, 0xFF, 100);
+    BOOST_CHECK(allocator.getVirtualSize() == allocator.getPhysicalSize() + pageSize);
+
+    // The block ends within one alignment of the guard page.
+    u8* aligned = static_cast<u8*>(allocator.allocate(64, 16, 4));
+    BOOST_REQUIRE(aligned);
+    BOOST_CHECK(((uptr)aligned + 4) % 16 == 0);
+    BOOST_CHECK(pageSize - ((uptr)aligned + 64) % pageSize < 16);
+
+    u8* large = static_cast<u8*>(allocator.allocate(pageSize * 3, 8, 0));
+    BOOST_REQUIRE(large);
+    memset(large, 0xFF, pageSize * 3);
+
+    allocator.free(aligned);
+    allocator.free(ptr);
+    allocator.free(large);
+    BOOST_CHECK(allocator.getVirtualSize() == 0);
+    BOOST_CHECK(allocator.getPhysicalSize() == 0);
+
+    allocator.allocate(32, 8, 0);
+    allocator.allocate(32, 8, 0);
+    allocator.reset();
+    BOOST_CHECK(allocator.getVirtualSize() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(overrun_faults)
+{
+    GuardPageAllocator allocator;
+
+    u8* ptr = static_cast<u8*>(allocator.allocate(100, 1, 0));
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(!faults([&](){ ptr[99] = 0; }));
+    BOOST_CHECK(faults([&](){ ptr[100] = 0; }));
+
+    allocator.free(ptr);
+    BOOST_CHECK(faults([&](){ ptr[0] = 0; }));
+}
+
+BOOST_AUTO_TEST_CASE(arena_with_guard_pages)
+{
+    SourceInfo info(__FILE__, __LINE__);
+
+    HeapArea area(1024);
+    ArenaWithGuardPages arena(area);
+
+    u8* ptr = static_cast<u8*>(arena.allocate(64, 8, info));
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(((uptr)ptr + 64) % VirtualMemory::getPageSize() == 0);
+    BOOST_CHECK(faults([&](){ ptr[64] = 0; }));
+
+    ptr = static_cast<u8*>(arena.reallocate(ptr, 128, 8, info));
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(faults([&](){ ptr[128] = 0; }));
+    arena.free(ptr);
+    BOOST_CHECK(arena.getMemoryTracker().getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_FIXTURE_TEST_SUITE(handle_pool, ContainerFixture)
+
+BOOST_AUTO_TEST_CASE(create_get_destroy)
+{
+    HandlePool<std::string, ContainerArena> pool(&arena, 4);
+    BOOST_CHECK(pool.empty());
+
+    Handle<std::string> first = pool.create("first");
+    Handle<std::string> second = pool.create(3, 'b');
+    BOOST_REQUIRE(!first.isNull() && !second.isNull());
+    BOOST_CHECK(first != second);
+    BOOST_CHECK(*pool.get(first) == "first");
+    BOOST_CHECK(*pool.get(second) == "bbb");
+    BOOST_CHECK(pool.size() == 2);
+
+    BOOST_CHECK(pool.destroy(first));
+    BOOST_CHECK(!pool.isAlive(first));
+    BOOST_CHECK(pool.get(first) == nullptr);
+    BOOST_CHECK(!pool.destroy(first));
+    BOOST_CHECK(*pool.get(second) == "bbb");
+
+    // The slot is reused with a new generation so the stale handle still fails.
+    Handle<std::string> third = pool.create("third");
+    BOOST_CHECK(third.getIndex() == first.getIndex());
+    BOOST_CHECK(third.getGeneration() != first.getGeneration());
+    BOOST_CHECK(pool.get(first) == nullptr);
+    BOOST_CHECK(*pool.get(third) == "third");
+
+    BOOST_CHECK(pool.get(Handle<std::string>()) == nullptr);
+    BOOST_CHECK(pool.get(Handle<std::string>(3, 1)) == nullptr);
+    BOOST_CHECK(pool.get(Handle<std::string>::fromValue(third.getValue())) == pool.get(third));
+}
+
+BOOST_AUTO_TEST_CASE(objects_stay_packed)
+{
+    HandlePool<u32, ContainerArena> pool(&arena, 8);
+    Handle<u32> handles[8];
+    for(u32 i = 0; i < 8; ++i)
+    {
+        handles[i] = pool.create(i);
+    }
+    BOOST_CHECK(pool.full());
+    BOOST_CHECK(pool.create(8u).isNull());
+
+    pool.destroy(handles[1]);
+    pool.destroy(handles[4]);
+    pool.destroy(handles[0]);
+    BOOST_REQUIRE(pool.size() == 5);
+
+    u32 sum = 0;
+    for(u32 value : pool)
+    {
+        sum += value;
+    }
+    BOOST_CHECK(sum == 2 + 3 + 5 + 6 + 7);
+
+    // Handles of moved objects still resolve and iteration positions map back to them.
+    for(u32 i : {2u, 3u, 5u, 6u, 7u})
+    {
+        BOOST_REQUIRE(pool.get(handles[i]));
+        BOOST_CHECK(*pool.get(handles[i]) == i);
+    }
+    for(u32 i = 0; i < pool.size(); ++i)
+    {
+        BOOST_CHECK(pool.get(pool.getHandle(i)) == &pool[i]);
+    }
+
+    // Destroying while iterating in reverse.
+    for(u32 i = pool.size(); i-- > 0;)
+    {
+        if(pool[i] % 2 == 1)
+        {
+            pool.destroy(pool.getHandle(i));
+        }
+    }
+    BOOST_CHECK(pool.size() == 2);
+    BOOST_CHECK(*pool.get(handles[2]) == 2 && *pool.get(handles[6]) == 6);
+}
+
+BOOST_AUTO_TEST_CASE(generation_wraps)
+{
+    HandlePool<u32, ContainerArena> pool(&arena, 1);
+    Handle<u32> first = pool.create(0u);
+    Handle<u32> handle = first;
+    for(u32 i = 0; i < Handle<u32>::MAX_GENERATION; ++i)
+    {
+        pool.destroy(handle);
+        handle = pool.create(i);
+        BOOST_REQUIRE(!handle.isNull());
+    }
+
+    // After every generation has been used the first one comes around again.
+    BOOST_CHECK(handle == first);
+}
+
+BOOST_AUTO_TEST_CASE(destroys_remaining_objects)
+{
+    {
+        HandlePool<std::string, ContainerArena> pool(&arena, 16);
+        pool.create("a long string that does not fit in the small string buffer");
+        pool.create("another long string that does not fit in the small string buffer");
+        BOOST_CHECK(arena.getNumAllocations() == 3);
+    }
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
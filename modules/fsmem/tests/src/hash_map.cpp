@@ -0,0 +1,106 @@
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_FIXTURE_TEST_SUITE(hash_map, ContainerFixture)
+
+BOOST_AUTO_TEST_CASE(insert_find_erase)
+{
+    HashMap<std::string, u32, ContainerArena> map(&arena);
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+
+    BOOST_CHECK(map.emplace("one", 1).second);
+    BOOST_CHECK(map.insert(std::make_pair(std::string("two"), 2u)).second);
+    BOOST_CHECK(!map.emplace("one", 10).second);
+    map["three"] = 3;
+
+    BOOST_REQUIRE(map.size() == 3);
+    BOOST_CHECK(map.at("one") == 1);
+    BOOST_CHECK(map.find("two")->second == 2);
+    BOOST_CHECK(map.find("four") == map.end());
+
+    size_t count = 0;
+    for(const auto& pair : map)
+    {
+        BOOST_CHECK(pair.second >= 1 && pair.second <= 3);
+        ++count;
+    }
+    BOOST_CHECK(count == 3);
+
+    BOOST_CHECK(map.erase("two") == 1);
+    BOOST_CHECK(map.erase("two") == 0);
+    map.erase(map.find("one"));
+    BOOST_CHECK(map.size() == 1);
+    BOOST_CHECK(map.count("three") == 1);
+}
+
+BOOST_AUTO_TEST_CASE(matches_std_map)
+{
+    // Random inserts and erases exercise growth and the backward shift on erase.
+    HashMap<u32, u32, ContainerArena> map(&arena);
+    std::map<u32, u32> expected;
+    std::mt19937 random(1234);
+
+    for(u32 i = 0; i < 20000; ++i)
+    {
+        const u32 key = random() % 2048;
+        if(random() % 3 == 0)
+        {
+            BOOST_REQUIRE(map.erase(key) == expected.erase(key));
+        }
+        else
+        {
+            map[key] = i;
+            expected[key] = i;
+        }
+    }
+
+    BOOST_REQUIRE(map.size() == expected.size());
+    for(const auto& pair : expected)
+    {
+        auto iter = map.find(pair.first);
+        BOOST_REQUIRE(iter != map.end());
+        BOOST_REQUIRE(iter->second == pair.second);
+    }
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+}
+
+BOOST_AUTO_TEST_CASE(reserve_and_move)
+{
+    HashMap<u32, u32, ContainerArena> map(&arena, 100);
+    const size_t capacity = map.capacity();
+    BOOST_CHECK(capacity * 3 >= 100 * 4);
+
+    for(u32 i = 0; i < 100; ++i)
+    {
+        map[i] = i * 2;
+    }
+    BOOST_CHECK(map.capacity() == capacity);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+
+    HashMap<u32, u32, ContainerArena> moved(std::move(map));
+    BOOST_CHECK(moved.size() == 100 && moved.at(50) == 100);
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 #include "fstest.h"
 #include "fscore.h"
 #include "fsmem.h"
@@ -156,6 +158,93 @@ BOOST_AUTO_TEST_CASE(allocate_aligned_offset)
     BOOST_REQUIRE(pointerUtil::alignTopAmount((uptr)ptr + 32, 64) == 0);
 }
 
+BOOST_AUTO_TEST_CASE(movable_allocations)
+{
+    HeapAllocator allocator(allocatorSize);
+    BOOST_CHECK(!allocator.hasMovableAllocations());
+    allocator.enableMovableAllocations(16);
+    BOOST_CHECK(allocator.hasMovableAllocations());
+
+    auto handle = allocator.allocateMovable(smallAllocationSize, 64);
+    BOOST_REQUIRE(!handle.isNull());
+    void* ptr = allocator.getMovable(handle);
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(pointerUtil::alignTopAmount((uptr)ptr, 64) == 0);
+    BOOST_CHECK(allocator.getNumMovableAllocations() == 1);
+
+    allocator.freeMovable(handle);
+    BOOST_CHECK(allocator.getMovable(handle) == nullptr);
+    BOOST_CHECK(allocator.getNumMovableAllocations() == 0);
+
+    // The relocation table limits the number of movable allocations.
+    for(u32 i = 0; i < 16; ++i)
+    {
+        BOOST_REQUIRE(!allocator.allocateMovable(tinyAllocationSize, defaultAlignment).isNull());
+    }
+    BOOST_CHECK(allocator.allocateMovable(tinyAllocationSize, defaultAlignment).isNull());
+
+    allocator.reset();
+    BOOST_CHECK(allocator.hasMovableAllocations());
+    BOOST_CHECK(allocator.getNumMovableAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(compact_fragmented_heap)
+{
+    const size_t blockSize = 1024;
+    const u32 maxBlocks = allocatorSize / blockSize;
+
+    HeapAllocator allocator(allocatorSize);
+    allocator.enableMovableAllocations(maxBlocks);
+
+    // Fill the heap.
+    std::vector<HeapAllocator::MovableHandle> handles;
+    for(;;)
+    {
+        auto handle = allocator.allocateMovable(blockSize, defaultAlignment);
+        if(handle.isNull())
+        {
+            break;
+        }
+        memset(allocator.getMovable(handle), handles.size(), blockSize);
+        handles.push_back(handle);
+    }
+    const u32 numBlocks = handles.size();
+    BOOST_REQUIRE(numBlocks > 32 && numBlocks < maxBlocks);
+
+    // Free every other block. Half the heap is free but only in small holes.
+    for(u32 i = 0; i < numBlocks; i += 2)
+    {
+        allocator.freeMovable(handles[i]);
+    }
+    const size_t largeSize = blockSize * 8;
+    BOOST_REQUIRE(allocator.allocateMovable(largeSize, defaultAlignment).isNull());
+
+    // Pinned blocks stay where they are.
+    void* pPinned = allocator.getMovable(handles[1]);
+    allocator.pinMovable(handles[1]);
+
+    // Each step moves a bounded number of bytes.
+    size_t movedBytes = allocator.compact(blockSize);
+    BOOST_CHECK(movedBytes <= blockSize);
+    for(u32 step = 0; step < numBlocks && movedBytes > 0; ++step)
+    {
+        movedBytes = allocator.compact(blockSize * 4);
+        BOOST_CHECK(movedBytes <= blockSize * 4);
+    }
+
+    BOOST_CHECK(allocator.getMovable(handles[1]) == pPinned);
+    allocator.unpinMovable(handles[1]);
+
+    for(u32 i = 1; i < numBlocks; i += 2)
+    {
+        const u8* pBlock = static_cast<const u8*>(allocator.getMovable(handles[i]));
+        BOOST_REQUIRE(pBlock);
+        BOOST_CHECK(pBlock[0] == (u8)i && pBlock[blockSize - 1] == (u8)i);
+    }
+
+    BOOST_CHECK(!allocator.allocateMovable(largeSize, defaultAlignment).isNull());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct IntrusivePtrFixture : ContainerFixture
+{
+    class Resource : public RefCounted
+    {
+    public:
+        virtual ~Resource() {}
+        virtual const char* getName() const = 0;
+    };
+
+    class Texture : public Resource
+    {
+    public:
+        explicit Texture(u32* pNumDestroyed) :
+            _pNumDestroyed(pNumDestroyed)
+        {
+        }
+
+        ~Texture()
+        {
+            ++*_pNumDestroyed;
+        }
+
+        virtual const char* getName() const override { return "texture"; }
+
+    private:
+        u32* _pNumDestroyed;
+    };
+
+    IntrusivePtrFixture() :
+        numDestroyed(0)
+    {
+    }
+
+    u32 numDestroyed;
+};
+
+BOOST_FIXTURE_TEST_SUITE(intrusive_ptr, IntrusivePtrFixture)
+
+BOOST_AUTO_TEST_CASE(shares_without_control_block)
+{
+    static_assert(sizeof(IntrusivePtr<Resource>) == sizeof(void*), "IntrusivePtr should be a single pointer.");
+
+    IntrusivePtr<Resource> pResource = makeIntrusive<Texture>(&arena, &numDestroyed);
+    BOOST_REQUIRE(pResource);
+    BOOST_CHECK(pResource->getRefCount() == 1);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+
+    {
+        IntrusivePtr<Resource> pCopy = pResource;
+        BOOST_CHECK(pResource->getRefCount() == 2);
+        BOOST_CHECK(pCopy == pResource);
+        BOOST_CHECK(std::string(pCopy->getName()) == "texture");
+
+        IntrusivePtr<Resource> pMoved = std::move(pCopy);
+        BOOST_CHECK(!pCopy && pCopy == nullptr);
+        BOOST_CHECK(pResource->getRefCount() == 2);
+    }
+    BOOST_CHECK(pResource->getRefCount() == 1);
+    BOOST_CHECK(numDestroyed == 0);
+
+    pResource = nullptr;
+    BOOST_CHECK(numDestroyed == 1);
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(objects_not_made_by_make_intrusive_are_not_deleted)
+{
+    {
+        Texture texture(&numDestroyed);
+        IntrusivePtr<Texture> pTexture(&texture);
+        BOOST_CHECK(texture.getRefCount() == 1);
+        pTexture.reset();
+        BOOST_CHECK(texture.getRefCount() == 0);
+        BOOST_CHECK(numDestroyed == 0);
+    }
+    BOOST_CHECK(numDestroyed == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
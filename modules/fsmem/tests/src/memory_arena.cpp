@@ -43,6 +43,13 @@ struct MemoryArenaFixture
     using ArenaWithFullTracking = MemoryArena<Allocator<StackAllocatorBottomGrowable, AllocationHeaderU32>,
                                               SingleThread, SimpleBoundsChecking, FullMemoryTracking, MemoryTagging>;
 
+    using ArenaWithIncrementalBoundsChecking = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                                           SingleThread, IncrementalBoundsChecking<2>,
+                                                           ExtendedMemoryTracking, NoMemoryTagging>;
+
+    using ArenaWithQuarantine = MemoryArena<QuarantinedAllocator<HeapAllocator, AllocationHeaderU32, 4, 256>,
+                                            SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
     MemoryArenaFixture()
     {
     }
@@ -207,6 +214,44 @@ BOOST_AUTO_TEST_CASE(arean_with_simple_bounds_checking)
     }
 }
 
+BOOST_AUTO_TEST_CASE(arena_with_incremental_bounds_checking)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    HeapArea heapArea(allocatorSize * 4);
+    ArenaWithIncrementalBoundsChecking arena(heapArea);
+
+    const u32 numAllocations = 8;
+    char* ptrs[numAllocations];
+    for(u32 i = 0; i < numAllocations; ++i)
+    {
+        ptrs[i] = static_cast<char*>(arena.allocate(smallAllocationSize, defaultAlignment, info));
+        BOOST_REQUIRE(ptrs[i]);
+    }
+
+    // Intact guards are scrubbed without asserting.
+    for(u32 i = 0; i < numAllocations; ++i)
+    {
+        arena.free(arena.allocate(smallAllocationSize, defaultAlignment, info));
+    }
+
+    // Overrun one allocation. Scrubbing two allocations per call with two calls per
+    // allocate/free pair must find it within numAllocations / 2 pairs.
+    u32* pBack = reinterpret_cast<u32*>(ptrs[5] + smallAllocationSize);
+    *pBack = 0;
+    FS_REQUIRE_ASSERT([&](){
+        for(u32 i = 0; i < numAllocations / 2; ++i)
+        {
+            arena.free(arena.allocate(smallAllocationSize, defaultAlignment, info));
+        }
+    });
+
+    *pBack = BOUNDS_BACK_PATTERN;
+    for(u32 i = 0; i < numAllocations; ++i)
+    {
+        arena.free(ptrs[i]);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(arena_with_memory_tagging)
 {
     SourceInfo info(__FILE__, __LINE__);
@@ -248,6 +293,52 @@ BOOST_AUTO_TEST_CASE(arena_with_memory_tagging)
 
 }
 
+BOOST_AUTO_TEST_CASE(arena_with_quarantine)
+{
+    SourceInfo info(__FILE__, __LINE__);
+
+    HeapArea area(allocatorSize * 4);
+    ArenaWithQuarantine arena(area);
+
+    // A freed block is poisoned and its address is not handed out again while quarantined.
+    void* ptr1 = arena.allocate(smallAllocationSize, defaultAlignment, info);
+    BOOST_REQUIRE(ptr1);
+    arena.free(ptr1);
+    BOOST_CHECK(*static_cast<u32*>(ptr1) == DEALLLOCATED_TAG_PATTERN);
+    void* ptr2 = arena.allocate(smallAllocationSize, defaultAlignment, info);
+    BOOST_REQUIRE(ptr2);
+    BOOST_CHECK(ptr2 != ptr1);
+    arena.free(ptr2);
+
+    // Limited by the number of blocks.
+    void* ptrs[6];
+    for(u32 i = 0; i < 6; ++i)
+    {
+        ptrs[i] = arena.allocate(8, defaultAlignment, info);
+    }
+    for(u32 i = 0; i < 6; ++i)
+    {
+        arena.free(ptrs[i]);
+    }
+    BOOST_CHECK(arena.getAllocator().getNumQuarantinedBlocks() == 4);
+
+    // Limited by the number of bytes.
+    void* large = arena.allocate(largeAllocationSize * 2, defaultAlignment, info);
+    arena.free(large);
+    BOOST_CHECK(arena.getAllocator().getNumQuarantinedBlocks() == 1);
+    BOOST_CHECK(arena.getAllocator().getQuarantinedSize() == largeAllocationSize * 2 + AllocationHeaderU32::SIZE);
+
+    arena.purge();
+    BOOST_CHECK(arena.getAllocator().getNumQuarantinedBlocks() == 0);
+    BOOST_CHECK(arena.getMemoryTracker().getNumAllocations() == 0);
+
+    // A write through a dangling pointer is caught when the block leaves the quarantine.
+    u32* dangling = static_cast<u32*>(arena.allocate(smallAllocationSize, defaultAlignment, info));
+    arena.free(dangling);
+    dangling[3] = 0;
+    FS_REQUIRE_ASSERT([&](){ arena.purge(); });
+}
+
 BOOST_AUTO_TEST_CASE(debug_arena)
 {
     SourceInfo info(__FILE__, __LINE__);
@@ -0,0 +1,227 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct MemoryBudgetFixture
+{
+    using BudgetArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                    SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging,
+                                    SimpleMemoryBudget>;
+
+    MemoryBudgetFixture() :
+        area(64 * 1024),
+        arena(area, "BudgetArena"),
+        numSignals(0)
+    {
+    }
+
+    static void onPressure(void* pUserData, const MemoryBudget&)
+    {
+        static_cast<MemoryBudgetFixture*>(pUserData)->numSignals++;
+    }
+
+    HeapArea area;
+    BudgetArena arena;
+    u32 numSignals;
+};
+
+BOOST_FIXTURE_TEST_SUITE(memory_budget, MemoryBudgetFixture)
+
+BOOST_AUTO_TEST_CASE(charge_and_release)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& budget = arena.getBudget();
+    MemoryBudget& global = fs::memory::getGlobalBudget();
+    const size_t globalUsed = global.getUsedSize();
+
+    void* ptr = arena.allocate(100, 16, info);
+    BOOST_REQUIRE(ptr);
+    BOOST_CHECK(budget.getUsedSize() == 100 + AllocationHeaderU32::SIZE);
+    BOOST_CHECK(global.getUsedSize() == globalUsed + budget.getUsedSize());
+
+    arena.free(ptr);
+    BOOST_CHECK(budget.getUsedSize() == 0);
+    BOOST_CHECK(budget.getPeakSize() == 100 + AllocationHeaderU32::SIZE);
+    BOOST_CHECK(global.getUsedSize() == globalUsed);
+}
+
+BOOST_AUTO_TEST_CASE(soft_limit_signals_once)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& budget = arena.getBudget();
+    budget.setLimits(256, 0);
+    budget.setPressureCallback(&onPressure, this);
+
+    void* a = arena.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 0);
+    BOOST_CHECK(!budget.isUnderPressure());
+
+    void* b = arena.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 1);
+    BOOST_CHECK(budget.isUnderPressure());
+
+    // Already under pressure.
+    void* c = arena.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 1);
+
+    arena.free(c);
+    arena.free(b);
+    BOOST_CHECK(!budget.isUnderPressure());
+
+    b = arena.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 2);
+
+    arena.free(b);
+    arena.free(a);
+}
+
+BOOST_AUTO_TEST_CASE(hard_limit_refuses)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& budget = arena.getBudget();
+    budget.setLimits(0, 512);
+    budget.setPressureCallback(&onPressure, this);
+
+    void* a = arena.allocate(400, 16, info);
+    BOOST_REQUIRE(a);
+
+    void* b = a;
+    FS_REQUIRE_ASSERT([&](){b = arena.allocate(400, 16, info);});
+    BOOST_CHECK(b == nullptr);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+    BOOST_CHECK(budget.getUsedSize() == 400 + AllocationHeaderU32::SIZE);
+
+    // Listeners get a chance to free memory before the allocation is refused.
+    BOOST_CHECK(numSignals == 1);
+
+    arena.free(a);
+}
+
+BOOST_AUTO_TEST_CASE(reallocate_past_hard_limit_keeps_original)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& budget = arena.getBudget();
+    budget.setLimits(0, 512);
+
+    u8* a = static_cast<u8*>(arena.allocate(200, 16, info));
+    BOOST_REQUIRE(a);
+    a[0] = 42;
+
+    void* b = a;
+    FS_REQUIRE_ASSERT([&](){b = arena.reallocate(a, 400, 16, info);});
+    BOOST_CHECK(b == nullptr);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+    BOOST_CHECK(budget.getUsedSize() == 200 + AllocationHeaderU32::SIZE);
+    BOOST_CHECK(a[0] == 42);
+
+    arena.free(a);
+}
+
+BOOST_AUTO_TEST_CASE(pressure_listener_frees_before_retry)
+{
+    SourceInfo info(__FILE__, __LINE__);
+
+    struct Cache
+    {
+        BudgetArena* pArena;
+        void* ptr;
+
+        static void evict(void* pUserData, const MemoryBudget&)
+        {
+            Cache* pCache = static_cast<Cache*>(pUserData);
+            pCache->pArena->free(pCache->ptr);
+            pCache->ptr = nullptr;
+        }
+    };
+
+    Cache cache = {&arena, arena.allocate(400, 16, info)};
+    arena.getBudget().setLimits(0, 512);
+    arena.getBudget().setPressureCallback(&Cache::evict, &cache);
+
+    void* ptr = arena.allocate(400, 16, info);
+    BOOST_CHECK(ptr);
+    BOOST_CHECK(cache.ptr == nullptr);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+
+    arena.free(ptr);
+}
+
+BOOST_AUTO_TEST_CASE(global_limit)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& global = fs::memory::getGlobalBudget();
+    const size_t globalUsed = global.getUsedSize();
+    global.setLimits(globalUsed + 256, globalUsed + 1024);
+    global.setPressureCallback(&onPressure, this);
+
+    HeapArea otherArea(64 * 1024);
+    BudgetArena other(otherArea, "OtherArena");
+    void* a = arena.allocate(200, 16, info);
+    void* b = other.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 1);
+    BOOST_CHECK(global.isUnderPressure());
+    BOOST_CHECK(!arena.getBudget().isUnderPressure());
+
+    void* c = nullptr;
+    FS_REQUIRE_ASSERT([&](){c = other.allocate(1024, 16, info);});
+    BOOST_CHECK(c == nullptr);
+    BOOST_CHECK(other.getBudget().getUsedSize() == 200 + AllocationHeaderU32::SIZE);
+
+    other.free(b);
+    arena.free(a);
+    global.setLimits(0, 0);
+    global.setPressureCallback(nullptr, nullptr);
+    BOOST_CHECK(global.getUsedSize() == globalUsed);
+}
+
+BOOST_AUTO_TEST_CASE(failed_allocation_is_refunded)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& global = fs::memory::getGlobalBudget();
+    const size_t globalUsed = global.getUsedSize();
+
+    void* ptr = &arena;
+    FS_REQUIRE_ASSERT([&](){ptr = arena.allocate(128 * 1024, 16, info);});
+    BOOST_CHECK(ptr == nullptr);
+    BOOST_CHECK(arena.getBudget().getUsedSize() == 0);
+    BOOST_CHECK(global.getUsedSize() == globalUsed);
+}
+
+BOOST_AUTO_TEST_CASE(unbudgeted_arena_is_not_charged)
+{
+    using PlainArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                   SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    SourceInfo info(__FILE__, __LINE__);
+    MemoryBudget& global = fs::memory::getGlobalBudget();
+    const size_t globalUsed = global.getUsedSize();
+
+    HeapArea plainArea(64 * 1024);
+    PlainArena plain(plainArea, "PlainArena");
+    void* ptr = plain.allocate(100, 16, info);
+    BOOST_CHECK(global.getUsedSize() == globalUsed);
+    BOOST_CHECK(plain.getBudget().getUsedSize() == 0);
+    plain.free(ptr);
+}
+
+BOOST_AUTO_TEST_CASE(reset_releases)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    arena.allocate(100, 16, info);
+    arena.allocate(100, 16, info);
+    BOOST_CHECK(arena.getBudget().getUsedSize() > 0);
+
+    arena.reset();
+    BOOST_CHECK(arena.getBudget().getUsedSize() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
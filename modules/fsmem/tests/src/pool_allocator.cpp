@@ -77,7 +77,7 @@ struct PoolAllocatorFixture
             counter++;
 
             uptr ptrPrev = as_uptr;
-            runner = (FreelistNode<indexSize>*)(freelist.getStart() + runner->offset);
+            runner = (FreelistNode<indexSize>*)(freelist.getStart() + runner->offset - 1);
             as_freelist = runner;
             uptr ptrNext = as_uptr;
 
@@ -213,6 +213,37 @@ BOOST_AUTO_TEST_CASE(freelist_out_of_memory)
     BOOST_REQUIRE(ptr == nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(freelist_release_out_of_order)
+{
+    const size_t elementSize = 8;
+    const size_t alignment = 8;
+    const size_t totalMemory = 256;
+    const u32 numElements = totalMemory / elementSize;
+
+    u8 pMemory[totalMemory];
+    Freelist<IndexSize::eightBytes> freelist = createAndVerifyFreelist<IndexSize::eightBytes>(pMemory, totalMemory, elementSize, alignment, 0);
+
+    void* ptrs[numElements];
+    for(u32 i = 0; i < numElements; ++i)
+    {
+        ptrs[i] = freelist.obtain();
+        BOOST_REQUIRE(ptrs[i]);
+    }
+
+    // Releasing the first slot before others must not cut off the rest of the list.
+    freelist.release(ptrs[0]);
+    for(u32 i = 1; i < numElements; ++i)
+    {
+        freelist.release(ptrs[i]);
+    }
+
+    for(u32 i = 0; i < numElements; ++i)
+    {
+        BOOST_CHECK(freelist.obtain());
+    }
+    BOOST_CHECK(freelist.obtain() == nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(allocate_and_free_from_page)
 {
     PoolAllocatorNonGrowable<largeAllocationSize, defaultAlignment> allocator(allocatorSize);
@@ -0,0 +1,91 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct ScratchArenaFixture
+{
+    // Builds the result in the caller's arena using scratch memory for temporaries.
+    char* concatenate(ScratchArena& result, const char* a, const char* b)
+    {
+        ScratchScope scratch(&result);
+        BOOST_CHECK(&scratch.getArena() != &result);
+
+        fs::string<ScratchArena> temp(a, &scratch.getArena());
+        temp += b;
+
+        char* out = static_cast<char*>(result.allocate(temp.size() + 1, 1, FS_SOURCE_INFO));
+        memcpy(out, temp.c_str(), temp.size() + 1);
+        return out;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(scratch_arena, ScratchArenaFixture)
+
+BOOST_AUTO_TEST_CASE(scope_rewinds)
+{
+    ScratchArena& arena = fs::memory::getScratchArena();
+    const size_t usedBefore = arena.getTotalUsedSize();
+
+    {
+        ScratchScope scope;
+        BOOST_CHECK(&scope.getArena() == &arena);
+        BOOST_REQUIRE(scope.allocate(1024));
+        void* ptr = scope.allocate(100, 64);
+        BOOST_CHECK((uptr)ptr % 64 == 0);
+
+        {
+            ScratchScope inner;
+            inner.allocate(4096);
+            BOOST_CHECK(arena.getNumScopes() == 2);
+        }
+        BOOST_CHECK(arena.getNumScopes() == 1);
+        BOOST_CHECK(arena.getTotalUsedSize() > usedBefore);
+
+        // Grows past the initial commit.
+        BOOST_REQUIRE(scope.allocate(1024 * 1024));
+    }
+
+    BOOST_CHECK(arena.getTotalUsedSize() == usedBefore);
+    BOOST_CHECK(arena.getNumScopes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(conflicting_scopes)
+{
+    ScratchScope outer;
+    char* joined = concatenate(outer.getArena(), "a fairly long string that will not fit in sso ",
+                               "and another one appended to it");
+    BOOST_CHECK(strcmp(joined, "a fairly long string that will not fit in sso and another one appended to it") == 0);
+
+    // Both arenas are in use so a third scope conflicting with the second goes back to the first.
+    ScratchScope second(&outer.getArena());
+    ScratchScope third(&second.getArena());
+    BOOST_CHECK(&third.getArena() == &outer.getArena());
+}
+
+BOOST_AUTO_TEST_CASE(arenas_are_per_thread)
+{
+    ScratchArena* mainArena = &fs::memory::getScratchArena();
+    ScratchArena* otherArena = nullptr;
+    std::thread thread([&otherArena]()
+    {
+        ScratchScope scope;
+        scope.allocate(64);
+        otherArena = &scope.getArena();
+    });
+    thread.join();
+    BOOST_CHECK(otherArena != nullptr);
+    BOOST_CHECK(otherArena != mainArena);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
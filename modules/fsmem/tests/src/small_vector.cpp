@@ -0,0 +1,105 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_FIXTURE_TEST_SUITE(small_vector, ContainerFixture)
+
+BOOST_AUTO_TEST_CASE(inline_until_full)
+{
+    SmallVector<u32, 4, ContainerArena> vector(&arena);
+    BOOST_CHECK(vector.empty());
+    BOOST_CHECK(vector.capacity() == 4);
+
+    for(u32 i = 0; i < 4; ++i)
+    {
+        vector.push_back(i);
+    }
+    BOOST_CHECK(vector.isInline());
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+
+    vector.push_back(4);
+    BOOST_CHECK(!vector.isInline());
+    BOOST_CHECK(vector.capacity() == 8);
+    BOOST_CHECK(arena.getNumAllocations() == 1);
+
+    for(u32 i = 0; i < vector.size(); ++i)
+    {
+        BOOST_CHECK(vector[i] == i);
+    }
+
+    vector.clear();
+    BOOST_CHECK(vector.empty());
+}
+
+BOOST_AUTO_TEST_CASE(insert_and_erase)
+{
+    SmallVector<std::string, 2, ContainerArena> vector(&arena);
+    vector.push_back("b");
+    vector.push_back("d");
+    vector.insert(vector.begin(), "a");
+    vector.insert(vector.begin() + 2, "c");
+    vector.emplace_back("e");
+
+    BOOST_REQUIRE(vector.size() == 5);
+    BOOST_CHECK(vector[0] == "a" && vector[1] == "b" && vector[2] == "c" && vector[3] == "d" && vector[4] == "e");
+
+    auto iter = vector.erase(vector.begin() + 1);
+    BOOST_CHECK(*iter == "c");
+    vector.erase(vector.begin(), vector.begin() + 2);
+    BOOST_REQUIRE(vector.size() == 2);
+    BOOST_CHECK(vector.front() == "d" && vector.back() == "e");
+
+    vector.pop_back();
+    BOOST_CHECK(vector.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+    SmallVector<std::string, 2, ContainerArena> vector(&arena);
+    vector.push_back("one");
+    vector.push_back("two");
+    vector.push_back("three");
+
+    SmallVector<std::string, 2, ContainerArena> copy(vector);
+    BOOST_CHECK(copy.size() == 3 && copy[2] == "three");
+    BOOST_CHECK(arena.getNumAllocations() == 2);
+
+    // Heap storage is stolen instead of reallocated.
+    SmallVector<std::string, 2, ContainerArena> moved(std::move(vector));
+    BOOST_CHECK(moved.size() == 3 && moved[0] == "one");
+    BOOST_CHECK(vector.empty() && vector.isInline());
+    BOOST_CHECK(arena.getNumAllocations() == 2);
+
+    SmallVector<std::string, 2, ContainerArena> small(&arena);
+    small.push_back("inline");
+    SmallVector<std::string, 2, ContainerArena> movedSmall(std::move(small));
+    BOOST_CHECK(movedSmall.isInline() && movedSmall[0] == "inline");
+
+    moved.resize(5);
+    BOOST_CHECK(moved.size() == 5 && moved[4].empty());
+    moved.resize(1);
+    BOOST_CHECK(moved.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(push_back_own_element)
+{
+    SmallVector<std::string, 1, ContainerArena> vector(&arena);
+    vector.push_back("first");
+    vector.push_back(vector[0]);
+    BOOST_CHECK(vector.size() == 2 && vector[1] == "first");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+#include "container_fixture.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_FIXTURE_TEST_SUITE(string_table, ContainerFixture)
+
+BOOST_AUTO_TEST_CASE(hash_at_compile_time)
+{
+    static_assert(HashedString("").getHashValue() == 0x811c9dc5, "FNV-1a offset basis");
+    static_assert(HashedString("a").getHashValue() == 0xe40c292c, "FNV-1a of 'a'");
+
+    constexpr HashedString fatal("FATAL");
+    std::string runtime("FATAL");
+    BOOST_CHECK(HashedString(runtime.c_str()) == fatal);
+    BOOST_CHECK(HashedString("ERROR") != fatal);
+}
+
+BOOST_AUTO_TEST_CASE(intern_once)
+{
+    std::string name("disk");
+    {
+        StringTable table(&adapter);
+        const u32 id = table.intern(name.c_str());
+        BOOST_CHECK(id == HashedString("disk").getHashValue());
+        BOOST_CHECK(table.intern(HashedString("disk")) == id);
+        BOOST_CHECK(table.getNumStrings() == 1);
+
+        // Hash table storage plus one copy of the string.
+        BOOST_CHECK(arena.getNumAllocations() == 2);
+
+        const char* pInterned = table.lookup(id);
+        BOOST_REQUIRE(pInterned);
+        BOOST_CHECK(pInterned != name.c_str());
+        name = "changed";
+        BOOST_CHECK(std::string(pInterned) == "disk");
+
+        BOOST_CHECK(table.lookup(HashedString("gzip").getHashValue()) == nullptr);
+    }
+    BOOST_CHECK(arena.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(collision_asserts)
+{
+    StringTable table(&adapter);
+    const u32 id = table.intern("costarring");
+    FS_REQUIRE_ASSERT([&](){ BOOST_CHECK(table.intern("liquid") == id); });
+    BOOST_CHECK(std::string(table.lookup(id)) == "costarring");
+}
+
+struct LookupLogger : public ILogger
+{
+    LookupLogger(const StringTable* pTable, u32 id) : pTable(pTable), id(id), pFound(nullptr) {}
+
+    virtual void log(const char*, const char*, const char*, u32, const char*, ...) override
+    {
+        pFound = pTable->lookup(id);
+    }
+
+    const StringTable* pTable;
+    u32 id;
+    const char* pFound;
+};
+
+BOOST_AUTO_TEST_CASE(collision_asserts_without_lock)
+{
+    StringTable table(&adapter);
+    const u32 id = table.intern("costarring");
+
+    // FS_REQUIRE_ASSERT removes the logger, so install one that uses the table by hand.
+    LookupLogger logger(&table, id);
+    ILogger* pOldLogger = fs::core::getLogger();
+    fs::core::setLogger(&logger);
+    fs::setAssertTriggered(false);
+    fs::setIgnoreAsserts(true);
+    table.intern("liquid");
+    fs::setIgnoreAsserts(false);
+    fs::core::setLogger(pOldLogger);
+
+    BOOST_CHECK(fs::getAssertTriggered());
+    BOOST_REQUIRE(logger.pFound);
+    BOOST_CHECK(std::string(logger.pFound) == "costarring");
+}
+
+BOOST_AUTO_TEST_CASE(global_table)
+{
+    const u32 id = fs::memory::internString("FILESYS");
+    BOOST_CHECK(id == HashedString("FILESYS").getHashValue());
+    BOOST_CHECK(std::string(fs::memory::getInternedString(id)) == "FILESYS");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
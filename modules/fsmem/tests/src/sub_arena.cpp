@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct SubArenaFixture
+{
+    using ParentArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                    SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    using LinearSubArena = MemoryArena<Allocator<LinearAllocator, AllocationHeaderU32>,
+                                       SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    using StackSubArena = MemoryArena<Allocator<StackAllocatorBottom, AllocationHeaderU32>,
+                                      SingleThread, NoBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+    SubArenaFixture() :
+        area(64 * 1024),
+        parent(area, "Parent")
+    {
+    }
+
+    HeapArea area;
+    ParentArena parent;
+};
+
+BOOST_FIXTURE_TEST_SUITE(sub_arena, SubArenaFixture)
+
+BOOST_AUTO_TEST_CASE(carve_and_return)
+{
+    SourceInfo info(__FILE__, __LINE__);
+
+    {
+        SubArena<LinearSubArena> child(parent, 4096, "Child");
+        BOOST_CHECK(parent.getNumAllocations() == 1);
+        BOOST_CHECK(child->getVirtualSize() == 4096);
+
+        void* ptr = child->allocate(128, 16, info);
+        BOOST_REQUIRE(ptr);
+        BOOST_CHECK((uptr)ptr % 16 == 0);
+
+        // Reset as a unit without freeing individual allocations.
+        child->allocate(128, 16, info);
+        child->reset();
+        BOOST_CHECK(child->getTotalUsedSize() == 0);
+        BOOST_CHECK(child->getNumAllocations() == 0);
+    }
+
+    BOOST_CHECK(parent.getNumAllocations() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(nested_reports)
+{
+    SourceInfo info(__FILE__, __LINE__);
+
+    SubArena<StackSubArena> level(parent, 8192, "Level");
+    void* levelPtr = level->allocate(64, 8, info);
+
+    {
+        SubArena<LinearSubArena> frame(level.get(), 1024, "Frame");
+        SubArena<LinearSubArena> request(parent, 1024, "Request");
+
+        frame->allocate(32, 8, info);
+        frame->allocate(32, 8, info);
+        request->allocate(16, 8, info);
+
+        auto report = parent.generateArenaReport();
+        BOOST_CHECK(report->numOfAllocations == 2);
+        BOOST_CHECK(report->numOfSubArenaAllocations == 2 + 2 + 1);
+
+        // Most recently attached first.
+        auto requestReport = report->firstSubArena;
+        BOOST_REQUIRE(requestReport);
+        BOOST_CHECK(strcmp(requestReport->arenaName, "Request") == 0);
+        BOOST_CHECK(requestReport->numOfAllocations == 1);
+        BOOST_CHECK(!requestReport->firstSubArena);
+
+        auto levelReport = requestReport->nextSibling;
+        BOOST_REQUIRE(levelReport);
+        BOOST_CHECK(strcmp(levelReport->arenaName, "Level") == 0);
+        BOOST_CHECK(levelReport->numOfAllocations == 2);
+        BOOST_CHECK(levelReport->numOfSubArenaAllocations == 2);
+        BOOST_REQUIRE(levelReport->firstSubArena);
+        BOOST_CHECK(strcmp(levelReport->firstSubArena->arenaName, "Frame") == 0);
+        BOOST_CHECK(!levelReport->nextSibling);
+
+        frame->reset();
+        request->reset();
+    }
+
+    // Destroyed sub-arenas are detached and their memory returned.
+    auto report = parent.generateArenaReport();
+    BOOST_CHECK(report->numOfSubArenaAllocations == 1);
+    BOOST_REQUIRE(report->firstSubArena);
+    BOOST_CHECK(!report->firstSubArena->nextSibling);
+    BOOST_CHECK(!report->firstSubArena->firstSubArena);
+    BOOST_CHECK(level->getNumAllocations() == 1);
+
+    level->free(levelPtr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,164 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct ThreadPolicyFixture
+{
+    ThreadPolicyFixture() :
+        numThreads(4),
+        numIterations(20000)
+    {
+    }
+
+    ~ThreadPolicyFixture()
+    {
+
+    }
+
+    // Increment a non atomic counter from many threads. Any failure of mutual exclusion
+    // results in lost increments.
+    template<class Primitive>
+    void testMutualExclusion()
+    {
+        Primitive primitive;
+        u32 counter = 0;
+
+        std::vector<std::thread> threads;
+        for(u32 i = 0; i < numThreads; ++i)
+        {
+            threads.push_back(std::thread([&]()
+            {
+                for(u32 j = 0; j < numIterations; ++j)
+                {
+                    primitive.enter();
+                    counter++;
+                    primitive.leave();
+                }
+            }));
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        BOOST_CHECK(counter == numThreads * numIterations);
+    }
+
+    template<class ThreadPolicy>
+    void testArena()
+    {
+        using Arena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                  ThreadPolicy, SimpleBoundsChecking, SimpleMemoryTracking, NoMemoryTagging>;
+
+        HeapArea area(VirtualMemory::getPageSize() * 256);
+        Arena arena(area, "ThreadPolicyArena");
+
+        std::vector<std::thread> threads;
+        for(u32 i = 0; i < numThreads; ++i)
+        {
+            threads.push_back(std::thread([&]()
+            {
+                for(u32 j = 0; j < numIterations / 10; ++j)
+                {
+                    void* ptr = arena.allocate(32, 8, FS_SOURCE_INFO);
+                    BOOST_REQUIRE(ptr);
+                    arena.free(ptr);
+                }
+            }));
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        BOOST_CHECK(arena.getNumAllocations() == 0);
+    }
+
+    const u32 numThreads;
+    const u32 numIterations;
+};
+
+BOOST_FIXTURE_TEST_SUITE(thread_policy, ThreadPolicyFixture)
+
+BOOST_AUTO_TEST_CASE(mutual_exclusion)
+{
+    testMutualExclusion<MutexPrimitive>();
+    testMutualExclusion<SpinThenParkPrimitive<>>();
+    testMutualExclusion<SpinThenParkPrimitive<0>>();
+    testMutualExclusion<TicketPrimitive>();
+    testMutualExclusion<ReaderWriterPrimitive>();
+}
+
+BOOST_AUTO_TEST_CASE(arena_with_primitives)
+{
+    testArena<MultiThread<MutexPrimitive>>();
+    testArena<MultiThread<SpinThenParkPrimitive<>>>();
+    testArena<MultiThread<TicketPrimitive>>();
+    testArena<MultiThread<ReaderWriterPrimitive>>();
+}
+
+BOOST_AUTO_TEST_CASE(reader_writer_shared_and_exclusive)
+{
+    ReaderWriterPrimitive primitive;
+    std::atomic<u32> readersInside(0);
+    std::atomic<u32> maxReadersInside(0);
+    std::atomic<bool> writerOverlapped(false);
+    u32 value = 0;
+
+    std::vector<std::thread> threads;
+    for(u32 i = 0; i < numThreads; ++i)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            for(u32 j = 0; j < numIterations / 10; ++j)
+            {
+                primitive.enterShared();
+                u32 inside = ++readersInside;
+                u32 max = maxReadersInside.load();
+                while(inside > max && !maxReadersInside.compare_exchange_weak(max, inside)) {}
+                readersInside--;
+                primitive.leaveShared();
+            }
+        }));
+    }
+
+    threads.push_back(std::thread([&]()
+    {
+        for(u32 j = 0; j < numIterations / 10; ++j)
+        {
+            primitive.enter();
+            if(readersInside.load() != 0)
+            {
+                writerOverlapped = true;
+            }
+            value++;
+            primitive.leave();
+        }
+    }));
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK(!writerOverlapped);
+    BOOST_CHECK(value == numIterations / 10);
+    BOOST_CHECK(maxReadersInside.load() >= 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -67,6 +67,54 @@ BOOST_AUTO_TEST_CASE(align_bottom_amount)
 
 }
 
+BOOST_AUTO_TEST_CASE(pattern_fill)
+{
+    const u32 pattern = 0x04030201;
+    u8 buffer[160];
+    for(size_t offset = 0; offset < 20; ++offset)
+    {
+        for(size_t size = 0; size < 120; size += 7)
+        {
+            memset(buffer, 0, sizeof(buffer));
+            if(size % 2 == 0)
+            {
+                patternUtil::fill(buffer + offset, size, pattern);
+            }
+            else
+            {
+                patternUtil::fillNonTemporal(buffer + offset, size, pattern);
+            }
+
+            for(size_t i = 0; i < sizeof(buffer); ++i)
+            {
+                const u8 expected = i >= offset && i < offset + size ? (u8)(1 + (i - offset) % 4) : 0;
+                BOOST_REQUIRE(buffer[i] == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pattern_find_mismatch)
+{
+    u8 buffer[256];
+    for(size_t offset = 0; offset < 20; ++offset)
+    {
+        const size_t size = 200;
+        u8* start = buffer + offset;
+        patternUtil::fill(start, size, DEALLLOCATED_TAG_PATTERN);
+        BOOST_CHECK(patternUtil::findMismatch(start, size, DEALLLOCATED_TAG_PATTERN) == nullptr);
+        BOOST_CHECK(patternUtil::findMismatch(start, 0, DEALLLOCATED_TAG_PATTERN) == nullptr);
+
+        for(size_t i = 0; i < size; i += 13)
+        {
+            start[i] = 0;
+            BOOST_CHECK(patternUtil::findMismatch(start, size, DEALLLOCATED_TAG_PATTERN) == start + i);
+            BOOST_CHECK(patternUtil::findMismatch(start, i, DEALLLOCATED_TAG_PATTERN) == nullptr);
+            start[i] = 0xDD;
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+
+using namespace fs;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(memory)
+
+struct VirtualRingBufferFixture
+{
+    VirtualRingBufferFixture() :
+        pageSize(VirtualMemory::getPageSize())
+    {
+    }
+
+    const size_t pageSize;
+};
+
+BOOST_FIXTURE_TEST_SUITE(virtual_ring_buffer, VirtualRingBufferFixture)
+
+BOOST_AUTO_TEST_CASE(mirrored_memory)
+{
+    u8* ptr = static_cast<u8*>(VirtualMemory::allocateMirroredMemory(pageSize));
+    BOOST_REQUIRE(ptr);
+    ptr[0] = 1;
+    BOOST_CHECK(ptr[pageSize] == 1);
+    ptr[pageSize * 2 - 1] = 2;
+    BOOST_CHECK(ptr[pageSize - 1] == 2);
+    VirtualMemory::freeMirroredMemory(ptr, pageSize);
+}
+
+BOOST_AUTO_TEST_CASE(write_and_read_across_wrap)
+{
+    VirtualRingBuffer<SingleProducer> buffer(100);
+    BOOST_CHECK(buffer.getCapacity() == pageSize);
+
+    std::vector<u8> data(pageSize);
+    for(size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = (u8)i;
+    }
+
+    // Move the cursors close to the end so the next write wraps around.
+    BOOST_REQUIRE(buffer.write(data.data(), pageSize - 10));
+    BOOST_CHECK(!buffer.write(data.data(), 11));
+    std::vector<u8> out(pageSize);
+    BOOST_CHECK(buffer.read(out.data(), pageSize) == pageSize - 10);
+
+    BOOST_REQUIRE(buffer.write(data.data(), 100));
+    size_t size = 0;
+    const u8* ptr = buffer.beginRead(size);
+    BOOST_REQUIRE(size == 100);
+    BOOST_CHECK(memcmp(ptr, data.data(), 100) == 0);
+    buffer.commitRead(40);
+    BOOST_CHECK(buffer.getSize() == 60);
+
+    // A reservation is visible only once it is committed.
+    VirtualRingBuffer<SingleProducer>::Reservation reservation = buffer.beginWrite(8);
+    BOOST_REQUIRE(reservation.data);
+    memset(reservation.data, 7, 8);
+    BOOST_CHECK(buffer.getSize() == 60);
+    buffer.commitWrite(reservation);
+    BOOST_CHECK(buffer.getSize() == 68);
+
+    BOOST_CHECK(buffer.read(out.data(), 68) == 68);
+    BOOST_CHECK(memcmp(out.data(), data.data() + 40, 60) == 0);
+    BOOST_CHECK(out[60] == 7 && out[67] == 7);
+    BOOST_CHECK(buffer.getSize() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(multiple_producers)
+{
+    const u32 numProducers = 4;
+    const u32 numMessages = 5000;
+    VirtualRingBuffer<MultiProducer> buffer(pageSize);
+
+    std::vector<std::thread> producers;
+    for(u32 p = 0; p < numProducers; ++p)
+    {
+        producers.push_back(std::thread([&buffer, p]()
+        {
+            for(u32 i = 0; i < numMessages; ++i)
+            {
+                const u32 message[2] = {p, i};
+                while(!buffer.write(message, sizeof(message)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    // Messages from one producer arrive in order and are never torn.
+    u32 next[numProducers] = {};
+    u32 received = 0;
+    while(received < numProducers * numMessages)
+    {
+        u32 message[2];
+        if(buffer.read(message, sizeof(message)) == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        BOOST_REQUIRE(message[0] < numProducers);
+        BOOST_REQUIRE(message[1] == next[message[0]]);
+        ++next[message[0]];
+        ++received;
+    }
+
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+    BOOST_CHECK(buffer.getSize() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
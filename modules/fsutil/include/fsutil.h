@@ -4,7 +4,12 @@
 #include "fsutil/clock.h"
 #include "fsutil/delegate.h"
 #include "fsutil/event.h"
+#include "fsutil/event_bus.h"
+#include "fsutil/fiber.h"
 #include "fsutil/flags.h"
+#include "fsutil/job_system.h"
 #include "fsutil/math.h"
+#include "fsutil/memory_pressure.h"
+#include "fsutil/timer_wheel.h"
 
 #endif
@@ -4,18 +4,29 @@
 #ifndef FS_DELEGATE_H
 #define FS_DELEGATE_H
 
+#include <cstring>
+#include <type_traits>
+
 #include "fscore/types.h"
 #include "fscore/platforms.h"
 #include "fscore/assert.h"
 #include "fsmem/source_info.h"
 
+// Size of the buffer inside every Delegate that holds small trivially copyable lambdas
+// without allocating from the arena.
+#ifndef FS_DELEGATE_INLINE_SIZE
+#define FS_DELEGATE_INLINE_SIZE 32
+#endif
+
 namespace fs
 {
     // base template
     template <typename T, class Arena=std::nullptr_t>
     class Delegate {};
 
-    // Lambda version. Dynamic memory allocation from Arena
+    // Lambda version. Lambdas that are trivially copyable and fit in FS_DELEGATE_INLINE_SIZE
+    // bytes are stored inside the delegate and copied with it. Larger lambdas are allocated
+    // from Arena and shared between copies of the delegate.
     template <class Arena, typename R, typename ...Params>
     class Delegate<R (Params...), Arena>
     {
@@ -89,6 +100,15 @@ namespace fs
         using InternalFunction = R (*)(InstancePtr, Params&&...);
         using Stub = std::pair<InstancePtr, InternalFunction>;
         using DeleterType = void (*)(void*);
+        using InlineStorage = typename std::aligned_storage<FS_DELEGATE_INLINE_SIZE, alignof(void*)>::type;
+
+        template <typename T>
+        struct fitsInline : std::integral_constant<bool,
+            sizeof(T) <= sizeof(InlineStorage) &&
+            alignof(T) <= alignof(InlineStorage) &&
+            std::is_trivially_copyable<T>::value>
+        {
+        };
 
         template <typename T>
         static typename std::enable_if<
@@ -152,26 +172,36 @@ namespace fs
         >
         Delegate(T&& func, Arena* pArena) :
             _pArena(pArena),
-            _storeSize(sizeof(typename std::decay<T>::type))
+            _stub(InstancePtr(), nullptr),
+            _storeSize(0)
         {
             FS_ASSERT(_pArena);
 
             if(_pArena)
             {
-                using FunctorType = typename std::decay<T>::type;
-
-                _store = SharedPtr<void>(_pArena ? _pArena->allocate(sizeof(FunctorType), 8, FS_SOURCE_INFO) : nullptr,
-                        [pArena](void* const p){deleteFunctor<FunctorType>(p, pArena);});
-
-                new (_store.get()) FunctorType(std::forward<T>(func));
-                _stub.first.as_void = _store.get();
-                _stub.second = functorStub<FunctorType>;
-                _deleter = deleteFunctorStub<FunctorType>;
+                assign(std::forward<T>(func), fitsInline<typename std::decay<T>::type>());
             }
         }
 
-        Delegate(Delegate const&) = default;
-        Delegate(Delegate&&) = default;
+        Delegate(Delegate const& other) :
+            _pArena(other._pArena),
+            _stub(other._stub),
+            _deleter(other._deleter),
+            _store(other._store),
+            _storeSize(other._storeSize)
+        {
+            copyInline(other);
+        }
+
+        Delegate(Delegate&& other) :
+            _pArena(other._pArena),
+            _stub(other._stub),
+            _deleter(other._deleter),
+            _store(std::move(other._store)),
+            _storeSize(other._storeSize)
+        {
+            copyInline(other);
+        }
 
         ~Delegate()
         {
@@ -185,26 +215,13 @@ namespace fs
         >
         Delegate& operator=(T&& func)
         {
+            // Lambdas that fit inline do not need the arena but require it anyway so that
+            // whether a lambda is bound does not depend on the size of its captures.
             FS_ASSERT_MSG(_pArena, "No arena has been set. Use setArena before using operator=");
-            using FunctorType = typename std::decay<T>::type;
 
             if(_pArena)
             {
-                if(sizeof(FunctorType) > _storeSize || !_store.unique())
-                {
-                    _store.reset(_pArena->allocate(sizeof(FunctorType), 8, FS_SOURCE_INFO),
-                        [this](void* const p){deleteFunctor<FunctorType>(p, _pArena);});
-                    _storeSize = sizeof(FunctorType);
-                }
-                else
-                {
-                    _deleter(_store.get());
-                }
-
-                new (_store.get()) FunctorType(std::forward<T>(func));
-                _stub.first.as_void = _store.get();
-                _stub.second = functorStub<FunctorType>;
-                _deleter = deleteFunctorStub<FunctorType>;
+                assign(std::forward<T>(func), fitsInline<typename std::decay<T>::type>());
             }
             else
             {
@@ -218,8 +235,33 @@ namespace fs
             return *this;
         }
 
-        Delegate& operator=(Delegate const&) = default;
-        Delegate& operator=(Delegate&&) = default;
+        Delegate& operator=(Delegate const& other)
+        {
+            if(this != &other)
+            {
+                _pArena = other._pArena;
+                _stub = other._stub;
+                _deleter = other._deleter;
+                _store = other._store;
+                _storeSize = other._storeSize;
+                copyInline(other);
+            }
+            return *this;
+        }
+
+        Delegate& operator=(Delegate&& other)
+        {
+            if(this != &other)
+            {
+                _pArena = other._pArena;
+                _stub = other._stub;
+                _deleter = other._deleter;
+                _store = std::move(other._store);
+                _storeSize = other._storeSize;
+                copyInline(other);
+            }
+            return *this;
+        }
 
         void setArena(Arena* pArena)
         {
@@ -295,9 +337,9 @@ namespace fs
             // First check if both have a _store (lambdas) and their function pointers are the same
             // else if both are not lambdas then check if their instances and function pointers are the same
 
-            return (_store && other._store && _stub.second == other._stub.second) ||
+            return (isFunctor() && other.isFunctor() && _stub.second == other._stub.second) ||
                 // Lambda check above --- non lambda check below
-                (!_store && !other._store &&
+                (!isFunctor() && !other.isFunctor() &&
                     _stub.first.as_void == other._stub.first.as_void &&
                 _stub.second == other._stub.second);
         }
@@ -312,12 +354,87 @@ namespace fs
             return _stub.second != nullptr;
         }
 
+        // True when the bound lambda is stored inside the delegate.
+        bool isInline() const
+        {
+            return _stub.first.as_const_void == &_inline;
+        }
+
+        // The two halves of a bound delegate, for containers that store many delegates and
+        // call them in a tight loop as invoker(instance, params...). The instance of an
+        // inline lambda points into the delegate, so it is only valid until the delegate
+        // is moved.
+        using Instance = InstancePtr;
+        using Invoker = InternalFunction;
+
+        Instance getInstance() const
+        {
+            return _stub.first;
+        }
+
+        Invoker getInvoker() const
+        {
+            return _stub.second;
+        }
+
     private:
+        bool isFunctor() const
+        {
+            return _store || isInline();
+        }
+
+        // The inline lambda moves with the delegate so the stub must point at the new copy.
+        void copyInline(const Delegate& other)
+        {
+            if(other.isInline())
+            {
+                std::memcpy(&_inline, &other._inline, _storeSize);
+                _stub.first.as_void = &_inline;
+            }
+        }
+
+        template <typename T>
+        void assign(T&& func, std::true_type)
+        {
+            using FunctorType = typename std::decay<T>::type;
+
+            _store.reset();
+            new (&_inline) FunctorType(std::forward<T>(func));
+            _stub.first.as_void = &_inline;
+            _stub.second = functorStub<FunctorType>;
+            _deleter = nullptr;
+            _storeSize = sizeof(FunctorType);
+        }
+
+        template <typename T>
+        void assign(T&& func, std::false_type)
+        {
+            using FunctorType = typename std::decay<T>::type;
+
+            if(sizeof(FunctorType) > _storeSize || !_store.unique())
+            {
+                Arena* pArena = _pArena;
+                _store.reset(_pArena->allocate(sizeof(FunctorType), 8, FS_SOURCE_INFO),
+                    [pArena](void* const p){deleteFunctor<FunctorType>(p, pArena);});
+                _storeSize = sizeof(FunctorType);
+            }
+            else
+            {
+                _deleter(_store.get());
+            }
+
+            new (_store.get()) FunctorType(std::forward<T>(func));
+            _stub.first.as_void = _store.get();
+            _stub.second = functorStub<FunctorType>;
+            _deleter = deleteFunctorStub<FunctorType>;
+        }
+
         Arena* _pArena;
         Stub _stub;
         DeleterType _deleter;
         SharedPtr<void> _store;
         size_t _storeSize;
+        InlineStorage _inline;
 
     };
 
@@ -1,6 +1,7 @@
 #ifndef FS_EVENT_H
 #define FS_EVENT_H
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -8,6 +9,7 @@
 #include "fscore/types.h"
 #include "fscore/assert.h"
 #include "fsmem/stl_types.h"
+#include "fsmem/intrusive_ptr.h"
 #include "fsutil/delegate.h"
 
 namespace fs
@@ -37,14 +39,29 @@ namespace fs
         template <class C, ConstMemberFunction<C> function>
         using ConstWrapper = typename DelegateType::template ConstWrapper<C, function>;
 
-        class Channel
+        // Listeners are owned by _listeners but signalled from two parallel arrays holding
+        // only the instance and invoker of each delegate, so dispatch walks contiguous
+        // memory and never copies a delegate. The arrays are rebuilt lazily after the
+        // listeners change.
+        //
+        // Listeners may add or remove listeners of the channel they are signalled from.
+        // While signalling, added listeners are queued and are first signalled by the next
+        // signal; removed listeners are skipped for the rest of the signal and erased once
+        // the outermost signal returns.
+        class Channel : public RefCounted
         {
         public:
             friend Event<Arena, R (Params...)>;
 
             Channel(Arena* pArena, size_t size) :
                  _listeners(StlAllocator<DelegateType, Arena>(pArena)),
+                 _instances(StlAllocator<Instance, Arena>(pArena)),
+                 _invokers(StlAllocator<Invoker, Arena>(pArena)),
+                 _pendingAdds(StlAllocator<DelegateType, Arena>(pArena)),
                  _maxSize(size),
+                 _numPendingRemoves(0),
+                 _signalDepth(0),
+                 _dirty(false),
                  _pArena(pArena)
             {
                 FS_ASSERT(size > 0);
@@ -94,9 +111,17 @@ namespace fs
                 FS_ASSERT_MSG(!has(delegate), "Attempting to add a duplicate listener to channel.");
                 FS_ASSERT_MSG(delegate.bound(), "Attempting to add an unbound delegate.");
 
-                _listeners.push_back(delegate);
-                FS_ASSERT_MSG_FORMATTED(_listeners.size() <= _maxSize,
-                        "Channel exceeded maximum number of listeners. %u out of %u",  _listeners.size(), _maxSize);
+                if(_signalDepth > 0)
+                {
+                    _pendingAdds.push_back(std::move(delegate));
+                }
+                else
+                {
+                    _listeners.push_back(std::move(delegate));
+                    _dirty = true;
+                }
+                FS_ASSERT_MSG_FORMATTED(size() <= _maxSize,
+                        "Channel exceeded maximum number of listeners. %u out of %u",  size(), _maxSize);
             }
 
             //
@@ -141,9 +166,28 @@ namespace fs
             void remove(T delegate)
             {
                 FS_ASSERT_MSG(delegate.bound(), "Attempting to remove an unbound delegate.");
-                auto iter = std::find(_listeners.begin(), _listeners.end(), delegate);
-                if(iter != _listeners.end())
-                    _listeners.erase(iter);
+
+                const size_t index = find(delegate);
+                if(index < _listeners.size())
+                {
+                    if(_signalDepth > 0)
+                    {
+                        // The listener stays in place until the signal returns but is
+                        // no longer invoked.
+                        _invokers[index] = nullptr;
+                        ++_numPendingRemoves;
+                    }
+                    else
+                    {
+                        _listeners.erase(_listeners.begin() + index);
+                        _dirty = true;
+                    }
+                    return;
+                }
+
+                auto iter = std::find(_pendingAdds.begin(), _pendingAdds.end(), delegate);
+                if(iter != _pendingAdds.end())
+                    _pendingAdds.erase(iter);
                 else
                     FS_ASSERT(!"Tried to remove listener that did not belong to the channel.");
             }
@@ -189,25 +233,131 @@ namespace fs
             >
             bool has(T delegate)
             {
-                return std::find(_listeners.begin(), _listeners.end(), delegate) != _listeners.end();
+                return find(delegate) < _listeners.size() ||
+                    std::find(_pendingAdds.begin(), _pendingAdds.end(), delegate) != _pendingAdds.end();
             }
 
             size_t size() const
             {
-                return _listeners.size();
+                return _listeners.size() - _numPendingRemoves + _pendingAdds.size();
+            }
+
+            void clear()
+            {
+                if(_signalDepth > 0)
+                {
+                    for(size_t i = 0; i < _invokers.size(); ++i)
+                    {
+                        if(_invokers[i])
+                        {
+                            _invokers[i] = nullptr;
+                            ++_numPendingRemoves;
+                        }
+                    }
+                    _pendingAdds.clear();
+                }
+                else
+                {
+                    _listeners.clear();
+                    _dirty = true;
+                }
             }
 
         private:
+            using Instance = typename DelegateType::Instance;
+            using Invoker = typename DelegateType::Invoker;
+
             using ListenerVector = Vector<DelegateType, Arena>;
             ListenerVector _listeners;
+            Vector<Instance, Arena> _instances;
+            Vector<Invoker, Arena> _invokers;
+            ListenerVector _pendingAdds;
             size_t _maxSize;
+            size_t _numPendingRemoves;
+            u32 _signalDepth;
+            bool _dirty;
             Arena* _pArena;
 
+            // Returns _listeners.size() if the delegate is not a listener or has been removed
+            // during the current signal.
+            size_t find(const DelegateType& delegate) const
+            {
+                for(size_t i = 0; i < _listeners.size(); ++i)
+                {
+                    if(_listeners[i] == delegate && (_signalDepth == 0 || _invokers[i]))
+                    {
+                        return i;
+                    }
+                }
+                return _listeners.size();
+            }
+
+            void rebuild()
+            {
+                _instances.clear();
+                _invokers.clear();
+                for(const DelegateType& delegate : _listeners)
+                {
+                    _instances.push_back(delegate.getInstance());
+                    _invokers.push_back(delegate.getInvoker());
+                }
+                _dirty = false;
+            }
+
+            void applyPending()
+            {
+                if(_numPendingRemoves > 0)
+                {
+                    size_t count = 0;
+                    for(size_t i = 0; i < _listeners.size(); ++i)
+                    {
+                        if(_invokers[i])
+                        {
+                            if(count != i)
+                            {
+                                _listeners[count] = std::move(_listeners[i]);
+                            }
+                            ++count;
+                        }
+                    }
+                    _listeners.resize(count);
+                    _numPendingRemoves = 0;
+                    _dirty = true;
+                }
+
+                if(!_pendingAdds.empty())
+                {
+                    for(DelegateType& delegate : _pendingAdds)
+                    {
+                        _listeners.push_back(std::move(delegate));
+                    }
+                    _pendingAdds.clear();
+                    _dirty = true;
+                }
+            }
+
             void signal(Params... params)
             {
-                for(DelegateType delegate : _listeners)
+                if(_dirty)
+                {
+                    rebuild();
+                }
+
+                // Nothing below may reallocate or reorder the listeners until the outermost
+                // signal returns, which keeps the instances of inline lambdas valid.
+                ++_signalDepth;
+                const size_t count = _invokers.size();
+                for(size_t i = 0; i < count; ++i)
+                {
+                    if(_invokers[i])
+                    {
+                        _invokers[i](_instances[i], std::forward<Params>(params)...);
+                    }
+                }
+
+                if(--_signalDepth == 0)
                 {
-                    delegate.invoke(std::forward<Params>(params)...);
+                    applyPending();
                 }
             }
 
@@ -217,7 +367,7 @@ namespace fs
             }
         };
 
-        using ChannelPtr = SharedPtr<Channel>;
+        using ChannelPtr = IntrusivePtr<Channel>;
 
         Event(Arena* pArena) :
             _pArena(pArena),
@@ -232,7 +382,7 @@ namespace fs
 
         ChannelPtr makeChannel(size_t size)
         {
-            auto pChannel = std::allocate_shared<Channel>(StlAllocator<Channel, Arena>(_pArena), _pArena, size);
+            auto pChannel = makeIntrusive<Channel>(_pArena, _pArena, size);
             add(pChannel);
             return pChannel;
         }
@@ -348,7 +498,7 @@ namespace fs
 
         void removeAll()
         {
-            _pDefaultChannel->_listeners.clear();
+            _pDefaultChannel->clear();
             _channels.clear();
         }
 
@@ -394,7 +544,7 @@ namespace fs
         bool has(T delegate)
         {
             // Note: Uses a linear search. :( Avoid using this on an event with many listeners.
-            for(ChannelPtr pChannel : _channels)
+            for(const ChannelPtr& pChannel : _channels)
             {
                 if(pChannel->has(delegate))
                     return true;
@@ -410,7 +560,7 @@ namespace fs
 
         void signal(Params... params)
         {
-            for(ChannelPtr pChannel : _channels)
+            for(const ChannelPtr& pChannel : _channels)
             {
                 pChannel->signal(std::forward<Params>(params)...);
             }
@@ -424,7 +574,7 @@ namespace fs
         size_t size() const
         {
             size_t count = 0;
-            for(ChannelPtr pChannel : _channels)
+            for(const ChannelPtr& pChannel : _channels)
             {
                 count += pChannel->size();
             }
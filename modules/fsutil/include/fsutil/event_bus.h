@@ -0,0 +1,354 @@
+#ifndef FS_EVENT_BUS_H
+#define FS_EVENT_BUS_H
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/new.h"
+#include "fsmem/stl_types.h"
+#include "fsmem/utils.h"
+#include "fsmem/scratch_arena.h"
+#include "fsutil/event.h"
+
+// Maximum number of threads that can post to one EventBus.
+#ifndef FS_EVENT_BUS_MAX_THREADS
+#define FS_EVENT_BUS_MAX_THREADS 32
+#endif
+
+// Size of the buffer each posting thread writes its events to.
+#ifndef FS_EVENT_BUS_BUFFER_SIZE
+#define FS_EVENT_BUS_BUFFER_SIZE 256 * 1024
+#endif
+
+namespace fs
+{
+    namespace internal
+    {
+        inline std::atomic<u32>& getEventTypeCounter()
+        {
+            static std::atomic<u32> counter(0);
+            return counter;
+        }
+
+        // Small dense id for each event type, assigned the first time the type is used.
+        template<typename T>
+        inline u32 getEventTypeId()
+        {
+            static const u32 id = getEventTypeCounter().fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+
+        inline u32 getNumEventTypes()
+        {
+            return getEventTypeCounter().load(std::memory_order_acquire);
+        }
+
+        inline u32 nextEventBusId()
+        {
+            static std::atomic<u32> nextId(1);
+            return nextId.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Queue of typed events that any thread can post to and one thread delivers. Each
+    // posting thread copies its events into its own single producer ring buffer, so
+    // posting never takes a lock. Once per frame the owning thread calls dispatch, which
+    // groups the queued events by type and signals the Event for each type with all of
+    // its events back to back:
+    //
+    //     EventBus<DebugArena> bus(&arena);
+    //     bus.getEvent<DamageEvent>().add<Health, &Health::onDamage>(&health);
+    //
+    //     bus.post(DamageEvent{target, 10});   // any thread
+    //     bus.dispatch();                      // owning thread, once per frame
+    //
+    // Events of a type are delivered in the order each thread posted them. Events are
+    // copied as bytes so they must be trivially copyable. Events posted while dispatching
+    // are delivered by the next dispatch.
+    template<class Arena>
+    class EventBus : Uncopyable
+    {
+    public:
+        template<typename T>
+        using EventType = Event<Arena, void(const T&)>;
+
+        explicit EventBus(Arena* pArena, size_t bufferSize = FS_EVENT_BUS_BUFFER_SIZE) :
+            _pArena(pArena),
+            _bufferSize(bufferSize),
+            _id(internal::nextEventBusId()),
+            _types(StlAllocator<TypeEntry, Arena>(pArena)),
+            _numBuffers(0),
+            _dispatching(false)
+        {
+            FS_ASSERT(pArena);
+            for(u32 i = 0; i < FS_EVENT_BUS_MAX_THREADS; ++i)
+            {
+                _buffers[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~EventBus()
+        {
+            for(TypeEntry& entry : _types)
+            {
+                if(entry.pEvent)
+                {
+                    entry.destroy(entry.pEvent, _pArena);
+                }
+            }
+
+            const u32 numBuffers = getNumThreads();
+            for(u32 i = 0; i < numBuffers; ++i)
+            {
+                Buffer* pBuffer = _buffers[i].load(std::memory_order_acquire);
+                if(pBuffer)
+                {
+                    pBuffer->~Buffer();
+                }
+            }
+        }
+
+        // Queue an event from any thread. Returns false, dropping the event, when the
+        // calling thread's buffer is full or too many threads have posted to the bus.
+        template<typename T>
+        bool post(const T& event)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Events are copied as bytes and must be trivially copyable.");
+            static_assert(alignof(T) <= alignof(Header), "Event alignment is larger than the event bus supports.");
+
+            Buffer* pBuffer = getThreadBuffer();
+            if(!pBuffer)
+            {
+                return false;
+            }
+
+            auto reservation = pBuffer->beginWrite(getRecordSize(sizeof(T)));
+            if(!reservation.data)
+            {
+                return false;
+            }
+
+            Header* pHeader = reinterpret_cast<Header*>(reservation.data);
+            pHeader->typeId = internal::getEventTypeId<T>();
+            pHeader->size = (u32)sizeof(T);
+            std::memcpy(reservation.data + sizeof(Header), &event, sizeof(T));
+            pBuffer->commitWrite(reservation);
+            return true;
+        }
+
+        // The Event signalled for each dispatched event of type T. Owning thread only.
+        template<typename T>
+        EventType<T>& getEvent()
+        {
+            const u32 typeId = internal::getEventTypeId<T>();
+            if(typeId >= _types.size())
+            {
+                _types.resize(typeId + 1, TypeEntry());
+            }
+
+            TypeEntry& entry = _types[typeId];
+            if(!entry.pEvent)
+            {
+                entry.pEvent = FS_NEW(EventType<T>, _pArena)(_pArena);
+                entry.deliver = &deliver<T>;
+                entry.destroy = &destroy<T>;
+            }
+            return *static_cast<EventType<T>*>(entry.pEvent);
+        }
+
+        // Deliver every event posted before the call. Owning thread only. Returns the
+        // number of events consumed, including those of types nobody listens to.
+        size_t dispatch()
+        {
+            FS_ASSERT_MSG(!_dispatching, "EventBus::dispatch cannot be called from a listener.");
+            _dispatching = true;
+
+            // Type ids of every event already in a buffer were assigned before it was
+            // posted, so they are below the count read afterwards.
+            const u32 numBuffers = getNumThreads();
+            const u8* pData[FS_EVENT_BUS_MAX_THREADS];
+            size_t sizes[FS_EVENT_BUS_MAX_THREADS];
+            for(u32 i = 0; i < numBuffers; ++i)
+            {
+                Buffer* pBuffer = _buffers[i].load(std::memory_order_acquire);
+                sizes[i] = 0;
+                pData[i] = pBuffer ? pBuffer->beginRead(sizes[i]) : nullptr;
+            }
+            const u32 numTypes = internal::getNumEventTypes();
+
+            ScratchScope scratch;
+
+            // Counting sort by type keeps the order events were posted in within a type.
+            u32* pOffsets = static_cast<u32*>(scratch.allocate(sizeof(u32) * (numTypes + 1), alignof(u32)));
+            std::memset(pOffsets, 0, sizeof(u32) * (numTypes + 1));
+            size_t numEvents = 0;
+            for(u32 i = 0; i < numBuffers; ++i)
+            {
+                for(size_t offset = 0; offset < sizes[i];)
+                {
+                    const Header* pHeader = reinterpret_cast<const Header*>(pData[i] + offset);
+                    FS_ASSERT(pHeader->typeId < numTypes);
+                    ++pOffsets[pHeader->typeId + 1];
+                    ++numEvents;
+                    offset += getRecordSize(pHeader->size);
+                }
+            }
+
+            for(u32 typeId = 0; typeId < numTypes; ++typeId)
+            {
+                pOffsets[typeId + 1] += pOffsets[typeId];
+            }
+
+            const u8** ppPayloads = static_cast<const u8**>(scratch.allocate(sizeof(u8*) * (numEvents + 1), alignof(u8*)));
+            for(u32 i = 0; i < numBuffers; ++i)
+            {
+                for(size_t offset = 0; offset < sizes[i];)
+                {
+                    const Header* pHeader = reinterpret_cast<const Header*>(pData[i] + offset);
+                    ppPayloads[pOffsets[pHeader->typeId]++] = pData[i] + offset + sizeof(Header);
+                    offset += getRecordSize(pHeader->size);
+                }
+            }
+
+            // pOffsets[typeId] is now the end of the type's range and the start of the next.
+            u32 begin = 0;
+            for(u32 typeId = 0; typeId < numTypes; ++typeId)
+            {
+                const u32 end = pOffsets[typeId];
+                if(end > begin && typeId < _types.size() && _types[typeId].pEvent)
+                {
+                    _types[typeId].deliver(_types[typeId].pEvent, ppPayloads + begin, end - begin);
+                }
+                begin = end;
+            }
+
+            for(u32 i = 0; i < numBuffers; ++i)
+            {
+                if(sizes[i] > 0)
+                {
+                    _buffers[i].load(std::memory_order_relaxed)->commitRead(sizes[i]);
+                }
+            }
+
+            _dispatching = false;
+            return numEvents;
+        }
+
+        // Number of threads that have posted to the bus.
+        inline u32 getNumThreads() const
+        {
+            const u32 numBuffers = _numBuffers.load(std::memory_order_acquire);
+            return numBuffers < FS_EVENT_BUS_MAX_THREADS ? numBuffers : FS_EVENT_BUS_MAX_THREADS;
+        }
+
+    private:
+        using Buffer = VirtualRingBuffer<SingleProducer>;
+        using BufferStorage = typename std::aligned_storage<sizeof(Buffer), alignof(Buffer)>::type;
+
+        // Precedes each event in a buffer. Its size keeps the payloads aligned.
+        struct alignas(16) Header
+        {
+            u32 typeId;
+            u32 size;
+        };
+
+        struct TypeEntry
+        {
+            TypeEntry() :
+                pEvent(nullptr),
+                deliver(nullptr),
+                destroy(nullptr)
+            {
+            }
+
+            void* pEvent;
+            void (*deliver)(void* pEvent, const u8* const* ppPayloads, size_t count);
+            void (*destroy)(void* pEvent, Arena* pArena);
+        };
+
+        // The calling thread's buffer, found through a one entry cache of the last bus the
+        // thread posted to.
+        struct ThreadCache
+        {
+            u32 busId;
+            Buffer* pBuffer;
+        };
+
+        static inline size_t getRecordSize(size_t payloadSize)
+        {
+            return sizeof(Header) + ((payloadSize + alignof(Header) - 1) & ~(alignof(Header) - 1));
+        }
+
+        template<typename T>
+        static void deliver(void* pEvent, const u8* const* ppPayloads, size_t count)
+        {
+            EventType<T>* pTypedEvent = static_cast<EventType<T>*>(pEvent);
+            for(size_t i = 0; i < count; ++i)
+            {
+                pTypedEvent->signal(*reinterpret_cast<const T*>(ppPayloads[i]));
+            }
+        }
+
+        template<typename T>
+        static void destroy(void* pEvent, Arena* pArena)
+        {
+            FS_DELETE(static_cast<EventType<T>*>(pEvent), pArena);
+        }
+
+        Buffer* getThreadBuffer()
+        {
+            static thread_local ThreadCache cache = {0, nullptr};
+            if(cache.busId == _id)
+            {
+                return cache.pBuffer;
+            }
+
+            const std::thread::id threadId = std::this_thread::get_id();
+            Buffer* pBuffer = nullptr;
+            const u32 numBuffers = getNumThreads();
+            for(u32 i = 0; i < numBuffers && !pBuffer; ++i)
+            {
+                Buffer* pOther = _buffers[i].load(std::memory_order_acquire);
+                if(pOther && _owners[i] == threadId)
+                {
+                    pBuffer = pOther;
+                }
+            }
+
+            if(!pBuffer)
+            {
+                const u32 index = _numBuffers.fetch_add(1, std::memory_order_relaxed);
+                if(index >= FS_EVENT_BUS_MAX_THREADS)
+                {
+                    FS_ASSERT(!"Too many threads have posted to the event bus.");
+                    return nullptr;
+                }
+
+                _owners[index] = threadId;
+                pBuffer = new (&_bufferStorage[index]) Buffer(_bufferSize);
+                _buffers[index].store(pBuffer, std::memory_order_release);
+            }
+
+            cache.busId = _id;
+            cache.pBuffer = pBuffer;
+            return pBuffer;
+        }
+
+        Arena* _pArena;
+        size_t _bufferSize;
+        u32 _id;
+        Vector<TypeEntry, Arena> _types;
+        std::atomic<u32> _numBuffers;
+        std::atomic<Buffer*> _buffers[FS_EVENT_BUS_MAX_THREADS];
+        std::thread::id _owners[FS_EVENT_BUS_MAX_THREADS];
+        BufferStorage _bufferStorage[FS_EVENT_BUS_MAX_THREADS];
+        bool _dispatching;
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef FS_FIBER_H
+#define FS_FIBER_H
+
+#include "fscore/types.h"
+#include "fscore/platforms.h"
+
+#if PLATFORM_ID != PLATFORM_WINDOWS
+#include <ucontext.h>
+#endif
+
+namespace fs
+{
+    // Usable memory of a fiber stack, which grows down from pBase + size.
+    struct FiberStack
+    {
+        u8* pBase;
+        size_t size;
+    };
+
+    // Stacks for fibers carved from a single reservation of virtual address space. Every
+    // stack is committed up front and has a PROT_NONE guard page below it, so a fiber
+    // that overflows its stack faults instead of silently writing into its neighbour.
+    class FiberStackPool : Uncopyable
+    {
+    public:
+        // stackSize is rounded up to the page size.
+        FiberStackPool(u32 numStacks, size_t stackSize);
+        ~FiberStackPool();
+
+        FiberStack getStack(u32 index) const;
+
+        inline u32 getNumStacks() const { return _numStacks; }
+        inline size_t getStackSize() const { return _stackSize; }
+
+    private:
+        u8* _pReservation;
+        size_t _reservationSize;
+        size_t _stackSize;
+        size_t _pageSize;
+        u32 _numStacks;
+    };
+
+    // User mode execution context. Switching fibers saves the registers of the running
+    // code in one fiber and resumes another on the same thread, without the kernel
+    // scheduling anything. A fiber can be resumed on a different thread than the one it
+    // was suspended on, so code on a fiber must not keep the address of thread_local
+    // variables across a switch.
+    class Fiber : Uncopyable
+    {
+    public:
+        using EntryFunction = void (*)(void* pUserData);
+
+        Fiber();
+
+        // Prepare the fiber to call entry(pUserData) on the stack the first time it is
+        // switched to. entry must never return; it switches to another fiber instead.
+        void init(const FiberStack& stack, EntryFunction entry, void* pUserData);
+
+        // Save the calling context in this fiber and resume target. Returns when another
+        // fiber switches back to this one. A fiber that was never initialized captures
+        // the calling thread's own context, so it can be used to get back to the thread.
+        void switchTo(Fiber& target);
+
+    private:
+#if PLATFORM_ID != PLATFORM_WINDOWS
+        ucontext_t _context;
+#endif
+    };
+}
+
+#endif
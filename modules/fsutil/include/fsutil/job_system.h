@@ -0,0 +1,261 @@
+#ifndef FS_JOB_SYSTEM_H
+#define FS_JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/adapter.h"
+#include "fsutil/fiber.h"
+
+// Number of jobs each thread can have in flight. Also the capacity of each thread's queue.
+// Must be a power of two.
+#ifndef FS_JOB_SYSTEM_JOBS_PER_THREAD
+#define FS_JOB_SYSTEM_JOBS_PER_THREAD 4096
+#endif
+
+// Stack size of each fiber when the JobSystem runs jobs on fibers.
+#ifndef FS_JOB_SYSTEM_FIBER_STACK_SIZE
+#define FS_JOB_SYSTEM_FIBER_STACK_SIZE (64 * 1024)
+#endif
+
+namespace fs
+{
+    class JobSystem;
+
+    // Number of jobs that still have to finish. Jobs run with a counter increment it when
+    // they are queued and decrement it when they finish. Waiting on a counter is how one
+    // piece of work depends on another.
+    class JobCounter : Uncopyable
+    {
+    public:
+        JobCounter() :
+            _value(0)
+        {
+        }
+
+        inline u32 get() const { return _value.load(std::memory_order_acquire); }
+        inline bool isDone() const { return get() == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<u32> _value;
+    };
+
+    // A function and up to DATA_SIZE bytes of arguments. Jobs fill one cache line.
+    struct alignas(64) Job
+    {
+        using Function = void (*)(Job& job);
+
+        static const size_t DATA_SIZE = 64 - sizeof(Function) - sizeof(JobCounter*);
+
+        template<typename T>
+        inline T& getData()
+        {
+            static_assert(sizeof(T) <= DATA_SIZE, "Job data does not fit in a job.");
+            return *reinterpret_cast<T*>(data);
+        }
+
+        Function pFunction;
+        JobCounter* pCounter;
+        alignas(8) u8 data[DATA_SIZE];
+    };
+
+    // Chase-Lev work stealing deque of a fixed capacity. The owning thread pushes and pops
+    // at the bottom; any other thread steals from the top. Capacity must be a power of two.
+    class WorkStealingQueue : Uncopyable
+    {
+    public:
+        WorkStealingQueue(IArenaAdapter* pArena, u32 capacity);
+        ~WorkStealingQueue();
+
+        // Owner only. Returns false when the queue is full.
+        bool push(Job* pJob);
+
+        // Owner only. Takes the most recently pushed job.
+        Job* pop();
+
+        // Any thread. Takes the oldest job or nullptr if the queue is empty or another
+        // thread won the race for it.
+        Job* steal();
+
+        inline u32 getCapacity() const { return _mask + 1; }
+        u32 size() const;
+
+    private:
+        static const size_t CACHE_LINE_SIZE = 64;
+
+        IArenaAdapter* _pArena;
+        std::atomic<Job*>* _pJobs;
+        u32 _mask;
+        u8 _padding0[CACHE_LINE_SIZE - sizeof(IArenaAdapter*) - sizeof(std::atomic<Job*>*) - sizeof(u32)];
+        std::atomic<i64> _top;
+        u8 _padding1[CACHE_LINE_SIZE - sizeof(std::atomic<i64>)];
+        std::atomic<i64> _bottom;
+        u8 _padding2[CACHE_LINE_SIZE - sizeof(std::atomic<i64>)];
+    };
+
+    // Runs jobs on a fixed set of threads. The thread that creates the JobSystem is one
+    // of them and runs jobs whenever it waits; the others are started by the constructor.
+    // Each thread queues new jobs in its own WorkStealingQueue and takes work from the
+    // others when its queue is empty.
+    //
+    //     JobCounter counter;
+    //     jobs.run([pWorld](Job&){ pWorld->updatePhysics(); }, &counter);
+    //     jobs.run([pWorld](Job&){ pWorld->updateAudio(); }, &counter);
+    //     jobs.wait(&counter);
+    //
+    //     jobs.parallelFor(0, numEntities, 256, [&](u32 begin, u32 end){ ... });
+    //
+    // Jobs may only be run and waited on from the threads of the system, including from
+    // inside other jobs. Job storage is a ring of jobsPerThread slots per thread allocated
+    // from the arena up front. A slot is reused once its job returned; when all slots of
+    // a thread are in flight its next job runs immediately instead of being queued.
+    //
+    // With numFibers > 0 the worker threads run jobs on a pool of fibers. A job that waits
+    // on a counter then suspends its fiber and the worker moves on to other jobs instead
+    // of running them nested on the waiting job's stack. The job resumes, possibly on
+    // another worker, once the counter reaches zero, so it must not hold locks or the
+    // address of thread_local variables across wait. Each worker keeps one fiber busy and
+    // every suspended job holds one; when none is free, wait falls back to running other
+    // jobs. The creating thread never runs on a fiber and always runs jobs while it waits.
+    class JobSystem : Uncopyable
+    {
+    public:
+        // numThreads includes the calling thread.
+        JobSystem(IArenaAdapter* pArena, u32 numThreads, u32 jobsPerThread = FS_JOB_SYSTEM_JOBS_PER_THREAD,
+                  u32 numFibers = 0, size_t fiberStackSize = FS_JOB_SYSTEM_FIBER_STACK_SIZE);
+        ~JobSystem();
+
+        // Queue a job that calls function with a copy of the trivially copyable data.
+        void run(Job::Function function, const void* pData, size_t size, JobCounter* pCounter = nullptr);
+
+        // Queue a lambda, which must be trivially copyable and fit in a job. It is passed
+        // the job it runs in.
+        template<typename F>
+        void run(F&& func, JobCounter* pCounter = nullptr)
+        {
+            using FunctorType = typename std::decay<F>::type;
+            static_assert(sizeof(FunctorType) <= Job::DATA_SIZE, "Lambda captures do not fit in a job.");
+            static_assert(std::is_trivially_copyable<FunctorType>::value, "Lambdas run as jobs must be trivially copyable.");
+
+            Job inlineJob;
+            Job* pJob = allocateJob(&inlineJob);
+            new (pJob->data) FunctorType(std::forward<F>(func));
+            pJob->pFunction = &invokeFunctor<FunctorType>;
+            pJob->pCounter = pCounter;
+            submit(pJob);
+        }
+
+        // Run other jobs until the counter reaches zero. A job running on a fiber is
+        // suspended instead until the counter reaches zero.
+        void wait(JobCounter* pCounter);
+
+        // Calls func(begin, end) for consecutive ranges of at most grainSize indices
+        // covering [first, last) in parallel and waits for all of them.
+        template<typename F>
+        void parallelFor(u32 first, u32 last, u32 grainSize, F&& func)
+        {
+            FS_ASSERT(grainSize > 0);
+
+            using FunctorType = typename std::remove_reference<F>::type;
+            FunctorType* pFunc = &func;
+            JobCounter counter;
+            for(u32 begin = first; begin < last; begin += grainSize)
+            {
+                const u32 end = last - begin > grainSize ? begin + grainSize : last;
+                run([pFunc, begin, end](Job&){ (*pFunc)(begin, end); }, &counter);
+            }
+            wait(&counter);
+        }
+
+        inline u32 getNumThreads() const { return _numThreads; }
+
+        // Index of the calling thread in [0, getNumThreads()). The creating thread is 0.
+        u32 getThreadIndex() const;
+
+        // Jobs currently suspended in wait. Always zero without fibers.
+        inline u32 getNumWaitingFibers() const { return _numWaitingFibers.load(std::memory_order_acquire); }
+
+    private:
+        struct Worker;
+        struct ThreadState;
+
+        // A fiber and the counter it is suspended on, if any.
+        struct FiberSlot
+        {
+            Fiber fiber;
+            JobCounter* pWaitCounter;
+        };
+
+        // What the fiber that was just switched to does with the one it was switched from.
+        // The previous fiber is only handed on after its context is saved so that no two
+        // threads ever run on the same stack.
+        enum class FiberAction
+        {
+            None,
+            Release,
+            Wait
+        };
+
+        template<typename FunctorType>
+        static void invokeFunctor(Job& job)
+        {
+            job.getData<FunctorType>()(job);
+        }
+
+        // Returns pInlineJob when every slot of the calling thread is in flight. Such jobs
+        // are run immediately by submit instead of being queued.
+        Job* allocateJob(Job* pInlineJob);
+        inline bool isPooledJob(const Job* pJob) const { return pJob >= _pJobs && pJob < _pJobs + _numThreads * _jobsPerThread; }
+        void submit(Job* pJob);
+        void execute(Job* pJob);
+        Job* findJob(Worker& worker);
+        void workerMain(u32 index);
+        void workerLoop();
+
+        // Reads the thread_local state without letting the compiler keep its address
+        // across a fiber switch.
+        static ThreadState& getThreadState();
+        static void fiberMain(void* pUserData);
+        bool isPoolFiber(const FiberSlot* pFiber) const;
+        FiberSlot* takeFreeFiber();
+        FiberSlot* takeReadyFiber();
+        void switchToFiber(FiberSlot* pTarget, FiberAction action, JobCounter* pWaitCounter);
+        void completeSwitch();
+
+        IArenaAdapter* _pArena;
+        Worker* _pWorkers;
+        Job* _pJobs;
+        std::atomic<bool>* _pJobsInUse;
+        u32 _numThreads;
+        u32 _jobsPerThread;
+        u32 _id;
+        std::atomic<bool> _running;
+
+        FiberStackPool* _pFiberStacks;
+        FiberSlot* _pFibers;
+        u32 _numFibers;
+
+        // Free and suspended fibers, both bounded by _numFibers.
+        std::mutex _fiberMutex;
+        FiberSlot** _ppFreeFibers;
+        u32 _numFreeFibers;
+        FiberSlot** _ppWaitingFibers;
+        std::atomic<u32> _numWaitingFibers;
+
+        // Idle workers sleep here until a job is queued.
+        std::mutex _idleMutex;
+        std::condition_variable _idleCondition;
+        std::atomic<u32> _numIdle;
+    };
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef FS_MEMORY_PRESSURE_H
+#define FS_MEMORY_PRESSURE_H
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/memory_budget.h"
+#include "fsutil/event.h"
+
+namespace fs
+{
+    // Event signalled when a MemoryBudget crosses its soft limit, or refuses an allocation
+    // over its hard limit, so that listeners such as caches can evict. Listen to the
+    // budget of a single arena or to memory::getGlobalBudget() for all budgeted arenas:
+    //
+    //     MemoryPressureEvent<DebugArena> pressure(&arena, memory::getGlobalBudget());
+    //     pressure.add(NonConstWrapper<TextureCache, &TextureCache::evict>(&cache));
+    //
+    // Listeners are invoked on the thread that allocated and may free memory, including
+    // to the arena that triggered the event. A budget has a single pressure callback so
+    // only one event can listen to it at a time.
+    template<class Arena>
+    class MemoryPressureEvent : public Event<Arena, void(const MemoryBudget&)>, Uncopyable
+    {
+    public:
+        MemoryPressureEvent(Arena* pArena, MemoryBudget& budget) :
+            Event<Arena, void(const MemoryBudget&)>(pArena),
+            _budget(budget)
+        {
+            _budget.setPressureCallback(&onPressure, this);
+        }
+
+        ~MemoryPressureEvent()
+        {
+            _budget.setPressureCallback(nullptr, nullptr);
+        }
+
+        inline MemoryBudget& getBudget() const { return _budget; }
+
+    private:
+        static void onPressure(void* pUserData, const MemoryBudget& budget)
+        {
+            static_cast<MemoryPressureEvent*>(pUserData)->signal(budget);
+        }
+
+        MemoryBudget& _budget;
+    };
+}
+
+#endif
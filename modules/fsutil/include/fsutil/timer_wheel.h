@@ -0,0 +1,346 @@
+#ifndef FS_TIMER_WHEEL_H
+#define FS_TIMER_WHEEL_H
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include "fscore/types.h"
+#include "fscore/assert.h"
+#include "fsmem/stl_types.h"
+#include "fsutil/delegate.h"
+
+// Length of one tick of a TimerWheel. Timers fire on the first tick at or after the time
+// they are due, so this is also their precision.
+#ifndef FS_TIMER_WHEEL_TICK_SECONDS
+#define FS_TIMER_WHEEL_TICK_SECONDS (1.0f / 1000.0f)
+#endif
+
+namespace fs
+{
+    // Identifies a scheduled timer. A handle becomes stale once its timer fired or was
+    // cancelled, even if the timer's storage is reused.
+    struct TimerHandle
+    {
+        static const u32 INVALID_INDEX = 0xffffffff;
+
+        TimerHandle() :
+            index(INVALID_INDEX),
+            generation(0)
+        {
+        }
+
+        u32 index;
+        u32 generation;
+    };
+
+    // Hierarchical timer wheel. Level 0 has a slot for each of the next NUM_SLOTS ticks
+    // and every level above covers NUM_SLOTS times the range of the one below. A timer is
+    // placed in the lowest level whose range reaches its due tick and moves down a level
+    // each time the wheel below it wraps around, so scheduling and cancelling are O(1)
+    // and advancing only touches the timers that are due or move down. Timers further
+    // out than the whole wheel wait in the top level until they come into range.
+    //
+    //     TimerWheel<Arena> timers(pArena);
+    //     TimerHandle handle = timers.schedule(2.0f, [pDoor](){ pDoor->close(); });
+    //     timers.advance(elapsedSeconds);
+    //
+    // Callbacks run from advance in order of their due tick and may schedule and cancel
+    // timers. Timers scheduled from a callback fire no earlier than the next tick.
+    template<class Arena>
+    class TimerWheel : Uncopyable
+    {
+    public:
+        using Callback = Delegate<void (), Arena>;
+
+        static const u32 SLOT_BITS = 6;
+        static const u32 NUM_SLOTS = 1 << SLOT_BITS;
+        static const u32 NUM_LEVELS = 5;
+
+        explicit TimerWheel(Arena* pArena, f32 tickSeconds = FS_TIMER_WHEEL_TICK_SECONDS) :
+            _pArena(pArena),
+            _entries(StlAllocator<Entry, Arena>(pArena)),
+            _tickSeconds(tickSeconds),
+            _remainderSeconds(0),
+            _currentTick(0),
+            _freeHead(INVALID_INDEX),
+            _numTimers(0)
+        {
+            FS_ASSERT(pArena);
+            FS_ASSERT(tickSeconds > 0.0f);
+
+            for(u32 i = 0; i < NUM_LEVELS * NUM_SLOTS; ++i)
+            {
+                _slots[i].head = INVALID_INDEX;
+                _slots[i].tail = INVALID_INDEX;
+            }
+        }
+
+        // Call callback once delaySeconds have been advanced.
+        TimerHandle schedule(f32 delaySeconds, const Callback& callback)
+        {
+            FS_ASSERT_MSG(callback.bound(), "Cannot schedule an unbound callback.");
+
+            // Round up from the current time within the tick so timers never fire early. The
+            // tolerance keeps delays that are a multiple of the tick in f32 from rounding up
+            // to an extra tick.
+            f64 ticks = std::ceil((_remainderSeconds + (f64)delaySeconds) / _tickSeconds - 1e-4);
+            const u64 delayTicks = ticks < 1.0 ? 1 : (u64)ticks;
+
+            const u32 index = allocateEntry();
+            Entry& entry = _entries[index];
+            entry.callback = callback;
+            entry.expiry = _currentTick + delayTicks;
+            insert(index);
+            ++_numTimers;
+
+            TimerHandle handle;
+            handle.index = index;
+            handle.generation = entry.generation;
+            return handle;
+        }
+
+        template<
+            typename F,
+            typename = typename std::enable_if<!std::is_same<Callback, typename std::decay<F>::type>::value>::type
+        >
+        TimerHandle schedule(f32 delaySeconds, F&& func)
+        {
+            return schedule(delaySeconds, Callback(std::forward<F>(func), _pArena));
+        }
+
+        // Returns false if the timer already fired or was cancelled.
+        bool cancel(TimerHandle handle)
+        {
+            if(!isScheduled(handle))
+            {
+                return false;
+            }
+
+            unlink(handle.index);
+            releaseEntry(handle.index);
+            return true;
+        }
+
+        bool isScheduled(TimerHandle handle) const
+        {
+            return handle.index < _entries.size() &&
+                   _entries[handle.index].generation == handle.generation &&
+                   _entries[handle.index].slot != INVALID_SLOT;
+        }
+
+        // Move time forward and fire every timer that became due. Returns the number of
+        // timers fired.
+        u32 advance(f32 elapsedSeconds)
+        {
+            // Same tolerance as schedule, so elapsed times that add up to a multiple of the
+            // tick in f32 reach it. The remainder may go slightly negative.
+            _remainderSeconds += elapsedSeconds;
+            const f64 elapsedTicks = _remainderSeconds / _tickSeconds + 1e-4;
+            const u64 ticks = elapsedTicks < 1.0 ? 0 : (u64)elapsedTicks;
+            _remainderSeconds -= (f64)ticks * _tickSeconds;
+
+            u32 numFired = 0;
+            const u64 targetTick = _currentTick + ticks;
+            while(_currentTick < targetTick)
+            {
+                if(_numTimers == 0)
+                {
+                    // Nothing can become due; timers scheduled later are relative to the
+                    // new current tick.
+                    _currentTick = targetTick;
+                    break;
+                }
+
+                ++_currentTick;
+                cascade();
+                numFired += expire();
+            }
+            return numFired;
+        }
+
+        inline u32 getNumTimers() const { return _numTimers; }
+        inline u64 getCurrentTick() const { return _currentTick; }
+        inline f32 getTickSeconds() const { return _tickSeconds; }
+
+    private:
+        static const u32 INVALID_INDEX = TimerHandle::INVALID_INDEX;
+        static const u16 INVALID_SLOT = 0xffff;
+        static const u32 SLOT_MASK = NUM_SLOTS - 1;
+
+        struct Entry
+        {
+            Entry(Arena* pArena) :
+                callback(pArena),
+                expiry(0),
+                next(INVALID_INDEX),
+                prev(INVALID_INDEX),
+                generation(1),
+                slot(INVALID_SLOT)
+            {
+            }
+
+            Callback callback;
+            u64 expiry;
+
+            // Links within the slot while scheduled; next links the free list otherwise.
+            u32 next;
+            u32 prev;
+            u32 generation;
+            u16 slot;
+        };
+
+        struct Slot
+        {
+            u32 head;
+            u32 tail;
+        };
+
+        u32 allocateEntry()
+        {
+            if(_freeHead != INVALID_INDEX)
+            {
+                const u32 index = _freeHead;
+                _freeHead = _entries[index].next;
+                return index;
+            }
+
+            _entries.push_back(Entry(_pArena));
+            return (u32)(_entries.size() - 1);
+        }
+
+        void releaseEntry(u32 index)
+        {
+            Entry& entry = _entries[index];
+            entry.callback = Callback(_pArena);
+            entry.slot = INVALID_SLOT;
+            ++entry.generation;
+            entry.next = _freeHead;
+            _freeHead = index;
+            --_numTimers;
+        }
+
+        void insert(u32 index)
+        {
+            Entry& entry = _entries[index];
+            u16 slot = (u16)(_currentTick & SLOT_MASK);
+
+            // Timers moving down can be due on the very tick their slot is reached; they
+            // go to the level 0 slot that expires next.
+            if(entry.expiry > _currentTick)
+            {
+                const u64 delta = entry.expiry - _currentTick;
+                u64 tick = entry.expiry;
+                u32 level = 0;
+                while(level < NUM_LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1))))
+                {
+                    ++level;
+                }
+
+                const u64 range = 1ull << (SLOT_BITS * NUM_LEVELS);
+                if(delta >= range)
+                {
+                    // Beyond the wheel. Park in the furthest slot and place it again when
+                    // that slot moves down.
+                    tick = _currentTick + range - 1;
+                }
+                slot = (u16)(level * NUM_SLOTS + ((tick >> (SLOT_BITS * level)) & SLOT_MASK));
+            }
+
+            Slot& list = _slots[slot];
+            entry.slot = slot;
+            entry.next = INVALID_INDEX;
+            entry.prev = list.tail;
+            if(list.tail != INVALID_INDEX)
+            {
+                _entries[list.tail].next = index;
+            }
+            else
+            {
+                list.head = index;
+            }
+            list.tail = index;
+        }
+
+        void unlink(u32 index)
+        {
+            Entry& entry = _entries[index];
+            Slot& list = _slots[entry.slot];
+            if(entry.prev != INVALID_INDEX)
+            {
+                _entries[entry.prev].next = entry.next;
+            }
+            else
+            {
+                list.head = entry.next;
+            }
+
+            if(entry.next != INVALID_INDEX)
+            {
+                _entries[entry.next].prev = entry.prev;
+            }
+            else
+            {
+                list.tail = entry.prev;
+            }
+            entry.slot = INVALID_SLOT;
+        }
+
+        // Move the timers of the slot each upper level reached with this tick down.
+        void cascade()
+        {
+            for(u32 level = 1; level < NUM_LEVELS; ++level)
+            {
+                const u32 shift = SLOT_BITS * level;
+                if((_currentTick & ((1ull << shift) - 1)) != 0)
+                {
+                    break;
+                }
+
+                Slot& list = _slots[level * NUM_SLOTS + ((_currentTick >> shift) & SLOT_MASK)];
+                u32 index = list.head;
+                list.head = INVALID_INDEX;
+                list.tail = INVALID_INDEX;
+                while(index != INVALID_INDEX)
+                {
+                    const u32 next = _entries[index].next;
+                    insert(index);
+                    index = next;
+                }
+            }
+        }
+
+        u32 expire()
+        {
+            const u32 slot = (u32)(_currentTick & SLOT_MASK);
+            u32 numFired = 0;
+
+            // Callbacks may schedule or cancel timers, which can reallocate the entries,
+            // so take one timer at a time and never hold a reference across a call. New
+            // timers are due on a later tick and never land in this slot.
+            u32 index;
+            while((index = _slots[slot].head) != INVALID_INDEX)
+            {
+                FS_ASSERT(_entries[index].expiry == _currentTick);
+
+                unlink(index);
+                Callback callback(std::move(_entries[index].callback));
+                releaseEntry(index);
+                callback();
+                ++numFired;
+            }
+            return numFired;
+        }
+
+        Arena* _pArena;
+        Vector<Entry, Arena> _entries;
+        Slot _slots[NUM_LEVELS * NUM_SLOTS];
+        f32 _tickSeconds;
+        f64 _remainderSeconds;
+        u64 _currentTick;
+        u32 _freeHead;
+        u32 _numTimers;
+    };
+}
+
+#endif
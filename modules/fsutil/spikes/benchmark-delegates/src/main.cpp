@@ -9,6 +9,8 @@
 #include <cstdlib>
 
 #include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
 
 using namespace std;
 using namespace chrono;
@@ -27,11 +29,83 @@ duration<double, milli> endBenchmark()
     return duration<double, milli>(steady_clock::now() - gStartTime);
 }
 
+// Construction and copy are measured by assigning into a ring of slots so that each
+// iteration also destroys whatever the slot held before.
+static const int numSlots = 1024;
+static const int numAssignments = 10000000;
+
+struct LargeCapture
+{
+    u64 values[6];
+};
+
+template<class Function>
+void benchmarkConstruct(const char* name, Function* slots, DebugArena* pArena)
+{
+    int x = 1;
+    LargeCapture large = {{1, 2, 3, 4, 5, 6}};
+
+    startBenchmark();
+    for(int i = 0; i < numAssignments; ++i)
+    {
+        slots[i % numSlots] = Function([&x, i](int j){ return i + j + x; }, pArena);
+    }
+    FS_PRINT(name << " construct small: " << endBenchmark().count());
+
+    startBenchmark();
+    for(int i = 0; i < numAssignments; ++i)
+    {
+        slots[i % numSlots] = Function([large, i](int j){ return i + j + (int)large.values[0]; }, pArena);
+    }
+    FS_PRINT(name << " construct large: " << endBenchmark().count());
+}
+
+template<class Function>
+void benchmarkCopy(const char* name, Function* slots, const Function& small, const Function& large)
+{
+    startBenchmark();
+    for(int i = 0; i < numAssignments; ++i)
+    {
+        slots[i % numSlots] = small;
+    }
+    FS_PRINT(name << " copy small:      " << endBenchmark().count());
+
+    startBenchmark();
+    for(int i = 0; i < numAssignments; ++i)
+    {
+        slots[i % numSlots] = large;
+    }
+    FS_PRINT(name << " copy large:      " << endBenchmark().count());
+}
+
+// Lets std::function be constructed the same way as a Delegate.
+struct StdFunction : std::function<int(int)>
+{
+    StdFunction() {}
+
+    template<typename T>
+    StdFunction(T&& func, DebugArena*) :
+        std::function<int(int)>(std::forward<T>(func))
+    {
+    }
+};
+
 int main( int, char **)
 {
     //Logger::init("content/logger.xml");
 
+    using DelegateFunction = Delegate<int(int), DebugArena>;
+    DebugArena* pArena = memory::getDebugArena();
+
+    StdFunction* stdSlots = new StdFunction[numSlots];
+    DelegateFunction* delegateSlots = new DelegateFunction[numSlots];
+    for(int i = 0; i < numSlots; ++i)
+    {
+        delegateSlots[i].setArena(pArena);
+    }
+
     int x = 0;
+    LargeCapture large = {{1, 2, 3, 4, 5, 6}};
     for(int xx = 0; xx < 5; ++xx)
     {
         startBenchmark();
@@ -44,15 +118,27 @@ int main( int, char **)
 
         startBenchmark();
         {
-            Delegate<int(int), DebugArena> t2([&x](int i){ return i + x; }, memory::getDebugArena());
-            Delegate<void(int), DebugArena> t1([&x, &t2](int i){ x = t2(i); }, memory::getDebugArena());
+            Delegate<int(int), DebugArena> t2([&x](int i){ return i + x; }, pArena);
+            Delegate<void(int), DebugArena> t1([&x, &t2](int i){ x = t2(i); }, pArena);
             for(int i = 0; i < 1000000000; ++i) t1(i);
         }
         FS_PRINT("delegate:  " << endBenchmark().count());
+
+        benchmarkConstruct("std::func:", stdSlots, pArena);
+        benchmarkConstruct("delegate: ", delegateSlots, pArena);
+
+        benchmarkCopy("std::func:", stdSlots,
+                      StdFunction([&x](int i){ return i + x; }, pArena),
+                      StdFunction([large](int i){ return i + (int)large.values[0]; }, pArena));
+        benchmarkCopy("delegate: ", delegateSlots,
+                      DelegateFunction([&x](int i){ return i + x; }, pArena),
+                      DelegateFunction([large](int i){ return i + (int)large.values[0]; }, pArena));
     }
 
+    delete[] stdSlots;
+    delete[] delegateSlots;
+
     //Logger::destroy();
 
     return 0;
 }
-
@@ -0,0 +1,145 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+// Signals a channel of 1 to 10k listeners and reports the cost per listener. The copy
+// and reference loops over a vector of delegates are what Channel::signal did before it
+// dispatched from its instance and invoker arrays.
+
+using Arena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                          SingleThread, NoBoundsChecking, NoMemoryTracking, NoMemoryTagging>;
+
+using ListenerEvent = Event<Arena, void(u32)>;
+using DelegateType = ListenerEvent::DelegateType;
+
+static const u32 listenerCounts[] = {1, 10, 100, 1000, 10000};
+static const u32 maxListeners = 10000;
+static const u32 signalsPerListener = 20000000;
+
+struct Listener
+{
+    void onSignal(u32 value)
+    {
+        total += value;
+    }
+
+    u64 total;
+};
+
+static Listener listeners[maxListeners];
+
+void printTime(steady_clock::time_point start, u32 numSignals, u32 numListeners)
+{
+    auto elapsed = duration<double, nano>(steady_clock::now() - start).count();
+    cout << setw(12) << right << fixed << setprecision(2) << elapsed / ((double)numSignals * numListeners);
+}
+
+Vector<DelegateType, Arena> makeDelegates(Arena* pArena, u32 numListeners)
+{
+    Vector<DelegateType, Arena> delegates{StlAllocator<DelegateType, Arena>(pArena)};
+    for(u32 i = 0; i < numListeners; ++i)
+    {
+        delegates.push_back(DelegateType::from<Listener, &Listener::onSignal>(&listeners[i]));
+    }
+    return delegates;
+}
+
+void benchmarkCopy(Arena* pArena)
+{
+    cout << setw(24) << left << "vector, copy";
+    for(u32 numListeners : listenerCounts)
+    {
+        auto delegates = makeDelegates(pArena, numListeners);
+
+        const u32 numSignals = signalsPerListener / numListeners;
+        auto start = steady_clock::now();
+        for(u32 i = 0; i < numSignals; ++i)
+        {
+            for(DelegateType delegate : delegates)
+            {
+                delegate.invoke(i);
+            }
+        }
+        printTime(start, numSignals, numListeners);
+    }
+    cout << endl;
+}
+
+void benchmarkReference(Arena* pArena)
+{
+    cout << setw(24) << left << "vector, reference";
+    for(u32 numListeners : listenerCounts)
+    {
+        auto delegates = makeDelegates(pArena, numListeners);
+
+        const u32 numSignals = signalsPerListener / numListeners;
+        auto start = steady_clock::now();
+        for(u32 i = 0; i < numSignals; ++i)
+        {
+            for(const DelegateType& delegate : delegates)
+            {
+                delegate.invoke(i);
+            }
+        }
+        printTime(start, numSignals, numListeners);
+    }
+    cout << endl;
+}
+
+void benchmarkChannel(Arena* pArena)
+{
+    cout << setw(24) << left << "Event::Channel";
+    for(u32 numListeners : listenerCounts)
+    {
+        ListenerEvent event(pArena);
+        auto pChannel = event.makeChannel(maxListeners);
+        for(u32 i = 0; i < numListeners; ++i)
+        {
+            pChannel->add<Listener, &Listener::onSignal>(&listeners[i]);
+        }
+
+        const u32 numSignals = signalsPerListener / numListeners;
+        auto start = steady_clock::now();
+        for(u32 i = 0; i < numSignals; ++i)
+        {
+            event.signal(i);
+        }
+        printTime(start, numSignals, numListeners);
+    }
+    cout << endl;
+}
+
+int main( int, char **)
+{
+    HeapArea area(64 * 1024 * 1024);
+    Arena arena(area, "EventArena");
+
+    cout << "signal (ns per listener)" << endl;
+    cout << setw(24) << left << "dispatch";
+    for(u32 numListeners : listenerCounts)
+    {
+        cout << setw(12) << right << numListeners;
+    }
+    cout << endl;
+
+    benchmarkCopy(&arena);
+    benchmarkReference(&arena);
+    benchmarkChannel(&arena);
+
+    u64 total = 0;
+    for(const Listener& listener : listeners)
+    {
+        total += listener.total;
+    }
+    cout << endl << "checksum " << total << endl;
+
+    return 0;
+}
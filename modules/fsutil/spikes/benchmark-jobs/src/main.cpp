@@ -0,0 +1,126 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+using namespace std;
+using namespace chrono;
+
+// Measures how the JobSystem scales from 1 to 64 threads. "parallelFor" updates an array
+// of particles in ranges of a fixed grain size; "tiny jobs" queues many jobs that do
+// almost no work to show the overhead of queueing and stealing a single job. Speedup is
+// relative to the 1 thread run and is capped by the number of hardware threads.
+
+using Arena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                          SingleThread, NoBoundsChecking, NoMemoryTracking, NoMemoryTagging>;
+
+static const u32 threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+static const u32 numParticles = 1 << 20;
+static const u32 grainSize = 1024;
+static const u32 numFrames = 20;
+static const u32 numTinyJobs = 1 << 16;
+
+struct Particle
+{
+    f32 position[3];
+    f32 velocity[3];
+};
+
+static Particle particles[numParticles];
+
+void updateParticles(u32 begin, u32 end)
+{
+    const f32 dt = 1.0f / 60.0f;
+    for(u32 i = begin; i < end; ++i)
+    {
+        Particle& particle = particles[i];
+        for(u32 axis = 0; axis < 3; ++axis)
+        {
+            particle.velocity[axis] += std::sin(particle.position[axis]) * dt;
+            particle.position[axis] += particle.velocity[axis] * dt;
+        }
+    }
+}
+
+double benchmarkParallelFor(JobSystem& jobs)
+{
+    auto start = steady_clock::now();
+    for(u32 frame = 0; frame < numFrames; ++frame)
+    {
+        jobs.parallelFor(0, numParticles, grainSize, [](u32 begin, u32 end){ updateParticles(begin, end); });
+    }
+    return duration<double, milli>(steady_clock::now() - start).count() / numFrames;
+}
+
+double benchmarkTinyJobs(JobSystem& jobs)
+{
+    std::atomic<u32> sum(0);
+    std::atomic<u32>* pSum = &sum;
+    JobCounter counter;
+
+    auto start = steady_clock::now();
+    for(u32 i = 0; i < numTinyJobs; ++i)
+    {
+        jobs.run([pSum](Job&){ pSum->fetch_add(1, std::memory_order_relaxed); }, &counter);
+        if(((i + 1) & (FS_JOB_SYSTEM_JOBS_PER_THREAD / 2 - 1)) == 0)
+        {
+            // Keep fewer jobs in flight than the job ring holds.
+            jobs.wait(&counter);
+        }
+    }
+    jobs.wait(&counter);
+    return duration<double, nano>(steady_clock::now() - start).count() / numTinyJobs;
+}
+
+int main( int, char **)
+{
+    HeapArea area(64 * 1024 * 1024);
+    Arena arena(area, "JobArena");
+    ArenaAdapter<Arena> adapter(&arena);
+
+    for(u32 i = 0; i < numParticles; ++i)
+    {
+        for(u32 axis = 0; axis < 3; ++axis)
+        {
+            particles[i].position[axis] = (f32)(i % 1000) * 0.01f + axis;
+            particles[i].velocity[axis] = 0.0f;
+        }
+    }
+
+    cout << "hardware threads " << std::thread::hardware_concurrency() << endl;
+    cout << setw(10) << left << "threads"
+         << setw(20) << right << "parallelFor (ms)" << setw(10) << "speedup"
+         << setw(20) << "tiny jobs (ns)" << endl;
+
+    double baseline = 0.0;
+    for(u32 numThreads : threadCounts)
+    {
+        JobSystem jobs(&adapter, numThreads);
+        const double frameTime = benchmarkParallelFor(jobs);
+        const double jobTime = benchmarkTinyJobs(jobs);
+        if(numThreads == 1)
+        {
+            baseline = frameTime;
+        }
+
+        cout << setw(10) << left << numThreads
+             << setw(20) << right << fixed << setprecision(2) << frameTime
+             << setw(10) << right << fixed << setprecision(2) << baseline / frameTime
+             << setw(20) << right << fixed << setprecision(1) << jobTime << endl;
+    }
+
+    f32 checksum = 0.0f;
+    for(const Particle& particle : particles)
+    {
+        checksum += particle.position[0];
+    }
+    cout << endl << "checksum " << checksum << endl;
+
+    return 0;
+}
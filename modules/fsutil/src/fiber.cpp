@@ -0,0 +1,42 @@
+#include "fscore/assert.h"
+#include "fsmem/utils.h"
+#include "fsutil/fiber.h"
+
+using namespace fs;
+
+FiberStackPool::FiberStackPool(u32 numStacks, size_t stackSize) :
+    _pReservation(nullptr),
+    _reservationSize(0),
+    _stackSize(0),
+    _pageSize(VirtualMemory::getPageSize()),
+    _numStacks(numStacks)
+{
+    FS_ASSERT(numStacks > 0);
+    FS_ASSERT(stackSize > 0);
+
+    _stackSize = (stackSize + _pageSize - 1) & ~(_pageSize - 1);
+    _reservationSize = (_stackSize + _pageSize) * numStacks;
+    _pReservation = static_cast<u8*>(VirtualMemory::reserveAddressSpace(_reservationSize));
+    FS_ASSERT_MSG(_pReservation, "FiberStackPool failed to reserve address space.");
+
+    // The guard page at the start of each slot stays reserved but never committed.
+    for(u32 i = 0; i < numStacks; ++i)
+    {
+        VirtualMemory::allocatePhysicalMemory(getStack(i).pBase, _stackSize);
+    }
+}
+
+FiberStackPool::~FiberStackPool()
+{
+    VirtualMemory::releaseAddressSpace(_pReservation, _reservationSize);
+}
+
+FiberStack FiberStackPool::getStack(u32 index) const
+{
+    FS_ASSERT(index < _numStacks);
+
+    FiberStack stack;
+    stack.pBase = _pReservation + (_stackSize + _pageSize) * index + _pageSize;
+    stack.size = _stackSize;
+    return stack;
+}
@@ -0,0 +1,52 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "fscore/assert.h"
+#include "fsutil/fiber.h"
+
+using namespace fs;
+
+namespace
+{
+    // makecontext only passes int arguments, so the entry point and user data are split
+    // into 32 bit halves.
+    void fiberTrampoline(int entryLow, int entryHigh, int dataLow, int dataHigh)
+    {
+        const uintptr_t entry = ((uintptr_t)(u32)entryHigh << 32) | (u32)entryLow;
+        const uintptr_t data = ((uintptr_t)(u32)dataHigh << 32) | (u32)dataLow;
+        reinterpret_cast<Fiber::EntryFunction>(entry)(reinterpret_cast<void*>(data));
+        FS_ASSERT_MSG(false, "A fiber entry function returned.");
+    }
+}
+
+Fiber::Fiber()
+{
+    memset(&_context, 0, sizeof(_context));
+}
+
+void Fiber::init(const FiberStack& stack, EntryFunction entry, void* pUserData)
+{
+    FS_ASSERT(stack.pBase && stack.size > 0);
+    FS_ASSERT(entry);
+
+    getcontext(&_context);
+    _context.uc_stack.ss_sp = stack.pBase;
+    _context.uc_stack.ss_size = stack.size;
+    _context.uc_link = nullptr;
+
+    const uintptr_t entryBits = reinterpret_cast<uintptr_t>(entry);
+    const uintptr_t dataBits = reinterpret_cast<uintptr_t>(pUserData);
+    makecontext(&_context, reinterpret_cast<void (*)()>(&fiberTrampoline), 4,
+                (int)(u32)entryBits, (int)(u32)((u64)entryBits >> 32),
+                (int)(u32)dataBits, (int)(u32)((u64)dataBits >> 32));
+}
+
+void Fiber::switchTo(Fiber& target)
+{
+    FS_ASSERT(&target != this);
+
+    const int result = swapcontext(&_context, &target._context);
+    FS_ASSERT_MSG_FORMATTED(result == 0, "Failed to switch fibers. errno: %i", errno);
+    (void)result;
+}
@@ -0,0 +1,552 @@
+#include <chrono>
+#include <cstring>
+
+#include "fscore/macros.h"
+#include "fsmem/source_info.h"
+#include "fsutil/job_system.h"
+
+using namespace fs;
+
+namespace
+{
+    // Failed searches for work before an idle worker goes to sleep.
+    const u32 SPIN_COUNT = 64;
+
+    u32 nextSystemId()
+    {
+        static std::atomic<u32> nextId(1);
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline u32 xorshift(u32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+WorkStealingQueue::WorkStealingQueue(IArenaAdapter* pArena, u32 capacity) :
+    _pArena(pArena),
+    _mask(capacity - 1),
+    _top(0),
+    _bottom(0)
+{
+    FS_ASSERT(pArena);
+    FS_ASSERT_MSG(capacity > 0 && (capacity & (capacity - 1)) == 0, "WorkStealingQueue capacity must be a power of two.");
+
+    _pJobs = static_cast<std::atomic<Job*>*>(_pArena->allocate(sizeof(std::atomic<Job*>) * capacity,
+                                                               alignof(std::atomic<Job*>), FS_SOURCE_INFO));
+    FS_ASSERT_MSG(_pJobs, "WorkStealingQueue failed to allocate memory.");
+    for(u32 i = 0; i < capacity; ++i)
+    {
+        new (_pJobs + i) std::atomic<Job*>(nullptr);
+    }
+}
+
+WorkStealingQueue::~WorkStealingQueue()
+{
+    _pArena->free(_pJobs);
+}
+
+bool WorkStealingQueue::push(Job* pJob)
+{
+    const i64 bottom = _bottom.load(std::memory_order_relaxed);
+    const i64 top = _top.load(std::memory_order_acquire);
+    if(bottom - top > (i64)_mask)
+    {
+        return false;
+    }
+
+    _pJobs[bottom & _mask].store(pJob, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* WorkStealingQueue::pop()
+{
+    const i64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 top = _top.load(std::memory_order_relaxed);
+
+    if(top > bottom)
+    {
+        // Empty.
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* pJob = _pJobs[bottom & _mask].load(std::memory_order_relaxed);
+    if(top == bottom)
+    {
+        // Last job. Race thieves for it.
+        if(!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            pJob = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return pJob;
+}
+
+Job* WorkStealingQueue::steal()
+{
+    i64 top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const i64 bottom = _bottom.load(std::memory_order_acquire);
+
+    if(top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Job* pJob = _pJobs[top & _mask].load(std::memory_order_relaxed);
+    if(!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return pJob;
+}
+
+u32 WorkStealingQueue::size() const
+{
+    const i64 bottom = _bottom.load(std::memory_order_relaxed);
+    const i64 top = _top.load(std::memory_order_relaxed);
+    return bottom > top ? (u32)(bottom - top) : 0;
+}
+
+struct JobSystem::ThreadState
+{
+    u32 systemId;
+    u32 index;
+
+    // Fiber the thread is running. nullptr on threads that do not use fibers.
+    FiberSlot* pFiber;
+
+    // Fiber the thread switched away from and what to do with it. See completeSwitch.
+    FiberSlot* pPrevious;
+    FiberAction action;
+};
+
+struct alignas(64) JobSystem::Worker
+{
+    Worker(IArenaAdapter* pArena, u32 capacity, u32 index) :
+        queue(pArena, capacity),
+        nextJob(0),
+        random(index * 2654435761u + 1)
+    {
+        threadFiber.pWaitCounter = nullptr;
+    }
+
+    WorkStealingQueue queue;
+    std::thread thread;
+    u32 nextJob;
+    u32 random;
+
+    // Context of the thread itself while it runs pool fibers.
+    FiberSlot threadFiber;
+};
+
+JobSystem::JobSystem(IArenaAdapter* pArena, u32 numThreads, u32 jobsPerThread, u32 numFibers, size_t fiberStackSize) :
+    _pArena(pArena),
+    _pWorkers(nullptr),
+    _pJobs(nullptr),
+    _pJobsInUse(nullptr),
+    _numThreads(numThreads),
+    _jobsPerThread(jobsPerThread),
+    _id(nextSystemId()),
+    _running(true),
+    _pFiberStacks(nullptr),
+    _pFibers(nullptr),
+    _numFibers(numFibers),
+    _ppFreeFibers(nullptr),
+    _numFreeFibers(0),
+    _ppWaitingFibers(nullptr),
+    _numWaitingFibers(0),
+    _numIdle(0)
+{
+    FS_ASSERT(pArena);
+    FS_ASSERT(numThreads > 0);
+    FS_ASSERT_MSG(numFibers == 0 || numFibers >= numThreads,
+                  "A JobSystem needs a fiber for each worker and at least one to suspend.");
+
+    ThreadState& state = getThreadState();
+    FS_ASSERT_MSG(state.systemId == 0, "The calling thread already belongs to a JobSystem.");
+
+    const u32 numJobs = numThreads * jobsPerThread;
+    _pJobs = static_cast<Job*>(_pArena->allocate(sizeof(Job) * numJobs, alignof(Job), FS_SOURCE_INFO));
+    _pJobsInUse = static_cast<std::atomic<bool>*>(_pArena->allocate(sizeof(std::atomic<bool>) * numJobs,
+                                                                     alignof(std::atomic<bool>), FS_SOURCE_INFO));
+    _pWorkers = static_cast<Worker*>(_pArena->allocate(sizeof(Worker) * numThreads, alignof(Worker), FS_SOURCE_INFO));
+    FS_ASSERT_MSG(_pJobs && _pJobsInUse && _pWorkers, "JobSystem failed to allocate memory.");
+
+    for(u32 i = 0; i < numJobs; ++i)
+    {
+        new (_pJobsInUse + i) std::atomic<bool>(false);
+    }
+
+    for(u32 i = 0; i < numThreads; ++i)
+    {
+        new (_pWorkers + i) Worker(pArena, jobsPerThread, i);
+    }
+
+    if(numFibers > 0)
+    {
+        _pFiberStacks = static_cast<FiberStackPool*>(_pArena->allocate(sizeof(FiberStackPool), alignof(FiberStackPool), FS_SOURCE_INFO));
+        _pFibers = static_cast<FiberSlot*>(_pArena->allocate(sizeof(FiberSlot) * numFibers, alignof(FiberSlot), FS_SOURCE_INFO));
+        _ppFreeFibers = static_cast<FiberSlot**>(_pArena->allocate(sizeof(FiberSlot*) * numFibers, alignof(FiberSlot*), FS_SOURCE_INFO));
+        _ppWaitingFibers = static_cast<FiberSlot**>(_pArena->allocate(sizeof(FiberSlot*) * numFibers, alignof(FiberSlot*), FS_SOURCE_INFO));
+        FS_ASSERT_MSG(_pFiberStacks && _pFibers && _ppFreeFibers && _ppWaitingFibers, "JobSystem failed to allocate memory.");
+
+        new (_pFiberStacks) FiberStackPool(numFibers, fiberStackSize);
+        for(u32 i = 0; i < numFibers; ++i)
+        {
+            new (_pFibers + i) FiberSlot();
+            _pFibers[i].pWaitCounter = nullptr;
+            _pFibers[i].fiber.init(_pFiberStacks->getStack(i), &JobSystem::fiberMain, this);
+            _ppFreeFibers[_numFreeFibers++] = _pFibers + i;
+        }
+    }
+
+    state.systemId = _id;
+    state.index = 0;
+
+    for(u32 i = 1; i < numThreads; ++i)
+    {
+        _pWorkers[i].thread = std::thread(&JobSystem::workerMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    FS_ASSERT_MSG(getThreadIndex() == 0, "A JobSystem must be destroyed by the thread that created it.");
+    FS_ASSERT_MSG(getNumWaitingFibers() == 0, "JobSystem destroyed with jobs still waiting.");
+
+    {
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _running.store(false, std::memory_order_release);
+    }
+    _idleCondition.notify_all();
+
+    for(u32 i = 1; i < _numThreads; ++i)
+    {
+        _pWorkers[i].thread.join();
+    }
+
+    for(u32 i = 0; i < _numThreads; ++i)
+    {
+        FS_ASSERT_MSG(_pWorkers[i].queue.size() == 0, "JobSystem destroyed with jobs still queued.");
+        _pWorkers[i].~Worker();
+    }
+
+    if(_numFibers > 0)
+    {
+        for(u32 i = 0; i < _numFibers; ++i)
+        {
+            _pFibers[i].~FiberSlot();
+        }
+        _pFiberStacks->~FiberStackPool();
+
+        _pArena->free(_ppWaitingFibers);
+        _pArena->free(_ppFreeFibers);
+        _pArena->free(_pFibers);
+        _pArena->free(_pFiberStacks);
+    }
+
+    _pArena->free(_pWorkers);
+    _pArena->free(_pJobsInUse);
+    _pArena->free(_pJobs);
+
+    getThreadState().systemId = 0;
+}
+
+void JobSystem::run(Job::Function function, const void* pData, size_t size, JobCounter* pCounter)
+{
+    FS_ASSERT(function);
+    FS_ASSERT_MSG(size <= Job::DATA_SIZE, "Job data does not fit in a job.");
+
+    Job inlineJob;
+    Job* pJob = allocateJob(&inlineJob);
+    if(size > 0)
+    {
+        memcpy(pJob->data, pData, size);
+    }
+    pJob->pFunction = function;
+    pJob->pCounter = pCounter;
+    submit(pJob);
+}
+
+void JobSystem::wait(JobCounter* pCounter)
+{
+    FS_ASSERT(pCounter);
+
+    while(!pCounter->isDone())
+    {
+        // The thread index is read again every iteration because a suspended fiber can
+        // resume on another thread.
+        if(isPoolFiber(getThreadState().pFiber))
+        {
+            if(FiberSlot* pNext = takeFreeFiber())
+            {
+                switchToFiber(pNext, FiberAction::Wait, pCounter);
+                continue;
+            }
+        }
+
+        Job* pJob = findJob(_pWorkers[getThreadIndex()]);
+        if(pJob)
+        {
+            execute(pJob);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+u32 JobSystem::getThreadIndex() const
+{
+    const ThreadState& state = getThreadState();
+    FS_ASSERT_MSG(state.systemId == _id, "Jobs can only be used from the threads of their JobSystem.");
+    return state.index;
+}
+
+Job* JobSystem::allocateJob(Job* pInlineJob)
+{
+    const u32 index = getThreadIndex();
+    Worker& worker = _pWorkers[index];
+    const u32 first = index * _jobsPerThread;
+
+    // Jobs finish in any order and the owner pops the newest first, so an old job can
+    // still be queued when the ring wraps around to it. Skip slots until one is free.
+    // Only the owner claims slots of its ring; execute frees them on any thread.
+    for(u32 i = 0; i < _jobsPerThread; ++i)
+    {
+        const u32 slot = first + (worker.nextJob++ & (_jobsPerThread - 1));
+        if(!_pJobsInUse[slot].load(std::memory_order_acquire))
+        {
+            _pJobsInUse[slot].store(true, std::memory_order_relaxed);
+            return _pJobs + slot;
+        }
+    }
+    return pInlineJob;
+}
+
+void JobSystem::submit(Job* pJob)
+{
+    if(pJob->pCounter)
+    {
+        pJob->pCounter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if(!isPooledJob(pJob) || !_pWorkers[getThreadIndex()].queue.push(pJob))
+    {
+        // Queue is full; do the work now rather than fail.
+        execute(pJob);
+        return;
+    }
+
+    if(_numIdle.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _idleCondition.notify_one();
+    }
+}
+
+void JobSystem::execute(Job* pJob)
+{
+    JobCounter* pCounter = pJob->pCounter;
+    pJob->pFunction(*pJob);
+    if(isPooledJob(pJob))
+    {
+        _pJobsInUse[pJob - _pJobs].store(false, std::memory_order_release);
+    }
+
+    if(pCounter && pCounter->_value.fetch_sub(1, std::memory_order_release) == 1 &&
+       _numWaitingFibers.load(std::memory_order_acquire) > 0 && _numIdle.load(std::memory_order_acquire) > 0)
+    {
+        // A suspended job may be ready to resume.
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _idleCondition.notify_one();
+    }
+}
+
+Job* JobSystem::findJob(Worker& worker)
+{
+    Job* pJob = worker.queue.pop();
+    if(pJob || _numThreads == 1)
+    {
+        return pJob;
+    }
+
+    const u32 self = (u32)(&worker - _pWorkers);
+    const u32 start = xorshift(worker.random) % _numThreads;
+    for(u32 i = 0; i < _numThreads && !pJob; ++i)
+    {
+        const u32 victim = (start + i) % _numThreads;
+        if(victim != self)
+        {
+            pJob = _pWorkers[victim].queue.steal();
+        }
+    }
+    return pJob;
+}
+
+void JobSystem::workerMain(u32 index)
+{
+    ThreadState& state = getThreadState();
+    state.systemId = _id;
+    state.index = index;
+
+    if(_numFibers > 0)
+    {
+        // The loop runs on pool fibers and switches back to this one when it stops.
+        state.pFiber = &_pWorkers[index].threadFiber;
+        FiberSlot* pFiber = takeFreeFiber();
+        FS_ASSERT_MSG(pFiber, "No free fiber to start a worker on.");
+        switchToFiber(pFiber, FiberAction::None, nullptr);
+    }
+    else
+    {
+        workerLoop();
+    }
+
+    ThreadState& exitState = getThreadState();
+    exitState.systemId = 0;
+    exitState.pFiber = nullptr;
+}
+
+void JobSystem::workerLoop()
+{
+    u32 numFailed = 0;
+    while(_running.load(std::memory_order_acquire))
+    {
+        // Resuming a job that finished waiting takes priority over starting new ones.
+        if(_numWaitingFibers.load(std::memory_order_acquire) > 0)
+        {
+            if(FiberSlot* pReady = takeReadyFiber())
+            {
+                switchToFiber(pReady, FiberAction::Release, nullptr);
+                numFailed = 0;
+                continue;
+            }
+        }
+
+        Job* pJob = findJob(_pWorkers[getThreadIndex()]);
+        if(pJob)
+        {
+            execute(pJob);
+            numFailed = 0;
+        }
+        else if(++numFailed < SPIN_COUNT)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // A job queued between the search and the wait is picked up by the timeout.
+            std::unique_lock<std::mutex> lock(_idleMutex);
+            if(_running.load(std::memory_order_relaxed))
+            {
+                _numIdle.fetch_add(1, std::memory_order_acq_rel);
+                _idleCondition.wait_for(lock, std::chrono::milliseconds(1));
+                _numIdle.fetch_sub(1, std::memory_order_relaxed);
+            }
+            numFailed = SPIN_COUNT - 1;
+        }
+    }
+}
+
+FS_NO_INLINE JobSystem::ThreadState& JobSystem::getThreadState()
+{
+    static thread_local ThreadState state = {0, 0, nullptr, nullptr, FiberAction::None};
+
+    // Going through a volatile keeps callers from reusing the address of another thread's
+    // state after their fiber moved.
+    ThreadState* volatile pState = &state;
+    return *pState;
+}
+
+void JobSystem::fiberMain(void* pUserData)
+{
+    JobSystem* pSystem = static_cast<JobSystem*>(pUserData);
+    pSystem->completeSwitch();
+    pSystem->workerLoop();
+
+    // Shutting down. Hand the thread back to the worker. The fiber is not released since
+    // a worker still finishing a wait could otherwise pick it up and resume it.
+    ThreadState& state = getThreadState();
+    pSystem->switchToFiber(&pSystem->_pWorkers[state.index].threadFiber, FiberAction::None, nullptr);
+    FS_ASSERT_MSG(false, "A released fiber was resumed.");
+}
+
+bool JobSystem::isPoolFiber(const FiberSlot* pFiber) const
+{
+    return pFiber >= _pFibers && pFiber < _pFibers + _numFibers;
+}
+
+JobSystem::FiberSlot* JobSystem::takeFreeFiber()
+{
+    std::lock_guard<std::mutex> lock(_fiberMutex);
+    return _numFreeFibers > 0 ? _ppFreeFibers[--_numFreeFibers] : nullptr;
+}
+
+JobSystem::FiberSlot* JobSystem::takeReadyFiber()
+{
+    std::lock_guard<std::mutex> lock(_fiberMutex);
+    const u32 numWaiting = _numWaitingFibers.load(std::memory_order_relaxed);
+    for(u32 i = 0; i < numWaiting; ++i)
+    {
+        FiberSlot* pFiber = _ppWaitingFibers[i];
+        if(pFiber->pWaitCounter->isDone())
+        {
+            _ppWaitingFibers[i] = _ppWaitingFibers[numWaiting - 1];
+            _numWaitingFibers.store(numWaiting - 1, std::memory_order_release);
+            pFiber->pWaitCounter = nullptr;
+            return pFiber;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::switchToFiber(FiberSlot* pTarget, FiberAction action, JobCounter* pWaitCounter)
+{
+    ThreadState& state = getThreadState();
+    FiberSlot* pCurrent = state.pFiber;
+    FS_ASSERT(pCurrent && pTarget && pCurrent != pTarget);
+
+    pCurrent->pWaitCounter = pWaitCounter;
+    state.pPrevious = pCurrent;
+    state.action = action;
+    state.pFiber = pTarget;
+    pCurrent->fiber.switchTo(pTarget->fiber);
+
+    // Resumed, possibly on another thread.
+    completeSwitch();
+}
+
+void JobSystem::completeSwitch()
+{
+    ThreadState& state = getThreadState();
+    FiberSlot* pPrevious = state.pPrevious;
+    const FiberAction action = state.action;
+    state.pPrevious = nullptr;
+    state.action = FiberAction::None;
+
+    if(action == FiberAction::Release)
+    {
+        std::lock_guard<std::mutex> lock(_fiberMutex);
+        _ppFreeFibers[_numFreeFibers++] = pPrevious;
+    }
+    else if(action == FiberAction::Wait)
+    {
+        std::lock_guard<std::mutex> lock(_fiberMutex);
+        const u32 numWaiting = _numWaitingFibers.load(std::memory_order_relaxed);
+        _ppWaitingFibers[numWaiting] = pPrevious;
+        _numWaitingFibers.store(numWaiting + 1, std::memory_order_release);
+    }
+}
@@ -325,6 +325,41 @@ BOOST_AUTO_TEST_CASE(check_bound)
     BOOST_CHECK(d5.bound());
 }
 
+BOOST_AUTO_TEST_CASE(small_lambdas_stored_inline)
+{
+    const size_t numAllocations = arena.getNumAllocations();
+
+    u32 offset = 3;
+    DelegateIntInt d1([offset](u32 i){ return i + offset; }, &arena);
+    BOOST_CHECK(d1.isInline());
+    BOOST_CHECK(arena.getNumAllocations() == numAllocations);
+
+    // Copies carry their own functor and keep working after the original is gone.
+    DelegateIntInt* pTemp = new DelegateIntInt(d1);
+    DelegateIntInt d2(std::move(*pTemp));
+    delete pTemp;
+    BOOST_CHECK(d2.isInline());
+    BOOST_CHECK(d2(1) == 4);
+    BOOST_CHECK(d2 == d1);
+
+    DelegateIntInt d3;
+    d3 = d2;
+    BOOST_CHECK(d3.isInline() && d3(2) == 5);
+    BOOST_CHECK(arena.getNumAllocations() == numAllocations);
+
+    // Captures that are too large or not trivially copyable go to the arena.
+    u64 large[FS_DELEGATE_INLINE_SIZE / sizeof(u64) + 1] = {7};
+    DelegateIntInt d4([large](u32 i){ return i + (u32)large[0]; }, &arena);
+    BOOST_CHECK(!d4.isInline());
+    BOOST_CHECK(d4(1) == 8);
+    BOOST_CHECK(arena.getNumAllocations() == numAllocations + 1);
+
+    // Assigning a small lambda replaces the arena storage.
+    d4 = [offset](u32 i){ return i * offset; };
+    BOOST_CHECK(d4.isInline() && d4(2) == 6);
+    BOOST_CHECK(arena.getNumAllocations() == numAllocations);
+}
+
 BOOST_AUTO_TEST_CASE(assert_null_arena_for_lambda)
 {
     auto lambda = [](){};
@@ -216,5 +216,93 @@ BOOST_AUTO_TEST_CASE(add_to_event_and_remove_all)
     BOOST_CHECK_MESSAGE(eventSize == 0, "size is " << eventSize);
 }
 
+BOOST_AUTO_TEST_CASE(remove_during_signal)
+{
+    auto channel = event.makeChannel(10);
+    u32 calls1 = 0;
+    u32 calls2 = 0;
+    auto listener2 = [&calls2](){ ++calls2; };
+    auto listener1 = [&calls1, &channel, &listener2]()
+    {
+        ++calls1;
+        channel->remove(listener2);
+    };
+
+    channel->add(listener1);
+    channel->add(listener2);
+
+    // listener2 is removed before it is reached so it is not invoked.
+    event();
+    BOOST_CHECK(calls1 == 1);
+    BOOST_CHECK(calls2 == 0);
+    BOOST_CHECK(channel->size() == 1);
+    BOOST_CHECK(!channel->has(listener2));
+}
+
+BOOST_AUTO_TEST_CASE(clear_during_signal)
+{
+    auto channel = event.makeChannel(10);
+    u32 calls = 0;
+    auto listener = [&calls, &channel]()
+    {
+        ++calls;
+        channel->clear();
+    };
+
+    channel->add(listener);
+    event();
+    event();
+    BOOST_CHECK(calls == 1);
+    BOOST_CHECK(channel->size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(add_during_signal_is_deferred)
+{
+    auto channel = event.makeChannel(10);
+    u32 calls1 = 0;
+    u32 calls2 = 0;
+    auto listener2 = [&calls2](){ ++calls2; };
+    auto listener1 = [&calls1, &channel, &listener2]()
+    {
+        if(++calls1 == 1)
+        {
+            channel->add(listener2);
+        }
+    };
+
+    channel->add(listener1);
+
+    // listener2 is queued by the first signal and only invoked by the second.
+    event();
+    BOOST_CHECK(calls1 == 1);
+    BOOST_CHECK(calls2 == 0);
+    BOOST_CHECK(channel->size() == 2);
+    BOOST_CHECK(channel->has(listener2));
+
+    event();
+    BOOST_CHECK(calls1 == 2);
+    BOOST_CHECK(calls2 == 1);
+}
+
+BOOST_AUTO_TEST_CASE(signal_does_not_allocate)
+{
+    auto channel = event.makeChannel(10);
+    u32 calls = 0;
+    u64 large[FS_DELEGATE_INLINE_SIZE / 8 + 1] = {};
+    channel->add([&calls, large](){ calls += 1 + (u32)large[0]; });
+    channel->add([&calls](){ ++calls; });
+
+    // Builds the dispatch arrays.
+    event();
+
+    auto numAllocations = arena.getNumAllocations();
+    for(u32 i = 0; i < 10; ++i)
+    {
+        event();
+    }
+    BOOST_CHECK(calls == 22);
+    BOOST_CHECK(arena.getNumAllocations() == numAllocations);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
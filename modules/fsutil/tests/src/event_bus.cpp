@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+
+using BusArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                             SingleThread,
+                             SimpleBoundsChecking,
+                             SimpleMemoryTracking,
+                             NoMemoryTagging>;
+
+using TestEventBus = EventBus<BusArena>;
+
+struct ScoreEvent
+{
+    u32 player;
+    u32 points;
+};
+
+struct SpawnEvent
+{
+    u32 entity;
+};
+
+struct ThreadEvent
+{
+    u32 thread;
+    u32 sequence;
+};
+
+struct EventBusFixture
+{
+    EventBusFixture() :
+        area(FS_SIZE_OF_MB),
+        arena(area, "EventBusArena")
+    {
+    }
+
+    // Order below matters for allocation deallocation order
+    HeapArea area;
+    BusArena arena;
+};
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_FIXTURE_TEST_SUITE(event_bus, EventBusFixture)
+
+BOOST_AUTO_TEST_CASE(dispatch_groups_events_by_type)
+{
+    TestEventBus bus(&arena);
+    std::vector<u32> delivered;
+    bus.getEvent<ScoreEvent>().add([&delivered](const ScoreEvent& event){ delivered.push_back(event.points); });
+    bus.getEvent<SpawnEvent>().add([&delivered](const SpawnEvent& event){ delivered.push_back(100 + event.entity); });
+
+    BOOST_CHECK(bus.post(ScoreEvent{0, 1}));
+    BOOST_CHECK(bus.post(SpawnEvent{1}));
+    BOOST_CHECK(bus.post(ScoreEvent{0, 2}));
+    BOOST_CHECK(bus.post(SpawnEvent{2}));
+    BOOST_CHECK(delivered.empty());
+
+    BOOST_CHECK(bus.dispatch() == 4);
+    BOOST_REQUIRE(delivered.size() == 4);
+    BOOST_CHECK(delivered[0] == 1);
+    BOOST_CHECK(delivered[1] == 2);
+    BOOST_CHECK(delivered[2] == 101);
+    BOOST_CHECK(delivered[3] == 102);
+
+    BOOST_CHECK(bus.dispatch() == 0);
+    BOOST_CHECK(delivered.size() == 4);
+    BOOST_CHECK(bus.getNumThreads() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(events_without_listeners_are_consumed)
+{
+    TestEventBus bus(&arena);
+    u32 calls = 0;
+    bus.getEvent<ScoreEvent>().add([&calls](const ScoreEvent&){ ++calls; });
+
+    bus.post(SpawnEvent{1});
+    bus.post(ScoreEvent{0, 1});
+    BOOST_CHECK(bus.dispatch() == 2);
+    BOOST_CHECK(calls == 1);
+    BOOST_CHECK(bus.dispatch() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(post_during_dispatch_is_deferred)
+{
+    TestEventBus bus(&arena);
+    u32 spawns = 0;
+    bus.getEvent<ScoreEvent>().add([&bus](const ScoreEvent& event){ bus.post(SpawnEvent{event.player}); });
+    bus.getEvent<SpawnEvent>().add([&spawns](const SpawnEvent&){ ++spawns; });
+
+    bus.post(ScoreEvent{7, 1});
+    BOOST_CHECK(bus.dispatch() == 1);
+    BOOST_CHECK(spawns == 0);
+    BOOST_CHECK(bus.dispatch() == 1);
+    BOOST_CHECK(spawns == 1);
+}
+
+BOOST_AUTO_TEST_CASE(post_fails_when_buffer_is_full)
+{
+    TestEventBus bus(&arena, 1);
+    u32 posted = 0;
+    while(bus.post(ScoreEvent{0, posted}))
+    {
+        ++posted;
+    }
+    BOOST_CHECK(posted > 0);
+
+    u32 calls = 0;
+    bus.getEvent<ScoreEvent>().add([&calls](const ScoreEvent& event){ BOOST_CHECK(event.points == calls++); });
+    BOOST_CHECK(bus.dispatch() == posted);
+    BOOST_CHECK(calls == posted);
+    BOOST_CHECK(bus.post(ScoreEvent{0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(post_from_threads)
+{
+    const u32 numThreads = 4;
+    const u32 numEvents = 1000;
+
+    TestEventBus bus(&arena);
+    u32 next[numThreads] = {};
+    bool inOrder = true;
+    bus.getEvent<ThreadEvent>().add([&](const ThreadEvent& event)
+    {
+        inOrder = inOrder && event.thread < numThreads && event.sequence == next[event.thread];
+        ++next[event.thread];
+    });
+
+    std::vector<std::thread> threads;
+    for(u32 t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&bus, t, numEvents]()
+        {
+            for(u32 i = 0; i < numEvents; ++i)
+            {
+                bus.post(ThreadEvent{t, i});
+            }
+        }));
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK(bus.getNumThreads() == numThreads);
+    BOOST_CHECK(bus.dispatch() == numThreads * numEvents);
+    BOOST_CHECK(inOrder);
+    for(u32 t = 0; t < numThreads; ++t)
+    {
+        BOOST_CHECK(next[t] == numEvents);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
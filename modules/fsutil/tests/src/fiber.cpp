@@ -0,0 +1,92 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+
+struct FiberFixture
+{
+    FiberFixture() :
+        stacks(2, 16 * 1024)
+    {
+    }
+
+    FiberStackPool stacks;
+};
+
+struct PingPong
+{
+    Fiber* pThreadFiber;
+    Fiber* pFiber;
+    u32 count;
+    const u8* pLocal;
+};
+
+void pingPongMain(void* pUserData)
+{
+    PingPong* pData = static_cast<PingPong*>(pUserData);
+    u32 local = 0;
+    pData->pLocal = reinterpret_cast<const u8*>(&local);
+
+    for(u32 i = 0; i < 3; ++i)
+    {
+        // Locals survive switching away and back.
+        local += 10;
+        pData->count = local;
+        pData->pFiber->switchTo(*pData->pThreadFiber);
+    }
+
+    pData->count = 0;
+    pData->pFiber->switchTo(*pData->pThreadFiber);
+}
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_FIXTURE_TEST_SUITE(fiber, FiberFixture)
+
+BOOST_AUTO_TEST_CASE(stack_pool_layout)
+{
+    const size_t pageSize = VirtualMemory::getPageSize();
+    BOOST_CHECK(stacks.getNumStacks() == 2);
+    BOOST_CHECK(stacks.getStackSize() >= 16 * 1024);
+    BOOST_CHECK(stacks.getStackSize() % pageSize == 0);
+
+    FiberStack first = stacks.getStack(0);
+    FiberStack second = stacks.getStack(1);
+    BOOST_CHECK(first.size == stacks.getStackSize());
+
+    // A guard page separates the top of one stack from the bottom of the next.
+    BOOST_CHECK(second.pBase == first.pBase + first.size + pageSize);
+
+    // Stacks are committed.
+    memset(first.pBase, 0xfe, first.size);
+    memset(second.pBase, 0xfe, second.size);
+    BOOST_CHECK(first.pBase[first.size - 1] == 0xfe);
+}
+
+BOOST_AUTO_TEST_CASE(switch_between_fibers)
+{
+    Fiber threadFiber;
+    Fiber fiber;
+    PingPong data = {&threadFiber, &fiber, 0, nullptr};
+    fiber.init(stacks.getStack(1), &pingPongMain, &data);
+
+    threadFiber.switchTo(fiber);
+    BOOST_CHECK(data.count == 10);
+
+    // The fiber runs on its own stack.
+    const FiberStack stack = stacks.getStack(1);
+    BOOST_CHECK(data.pLocal >= stack.pBase && data.pLocal < stack.pBase + stack.size);
+
+    threadFiber.switchTo(fiber);
+    BOOST_CHECK(data.count == 20);
+    threadFiber.switchTo(fiber);
+    BOOST_CHECK(data.count == 30);
+    threadFiber.switchTo(fiber);
+    BOOST_CHECK(data.count == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
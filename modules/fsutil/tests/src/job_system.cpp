@@ -0,0 +1,344 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+
+using JobArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                             SingleThread,
+                             SimpleBoundsChecking,
+                             SimpleMemoryTracking,
+                             NoMemoryTagging>;
+
+struct JobSystemFixture
+{
+    JobSystemFixture() :
+        area(FS_SIZE_OF_MB * 4),
+        arena(area, "JobArena"),
+        adapter(&arena)
+    {
+    }
+
+    // Order below matters for allocation deallocation order
+    HeapArea area;
+    JobArena arena;
+    ArenaAdapter<JobArena> adapter;
+};
+
+void addJobData(Job& job)
+{
+    struct Data
+    {
+        std::atomic<u32>* pSum;
+        u32 value;
+    };
+
+    Data& data = job.getData<Data>();
+    data.pSum->fetch_add(data.value);
+}
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_FIXTURE_TEST_SUITE(job_system, JobSystemFixture)
+
+BOOST_AUTO_TEST_CASE(work_stealing_queue)
+{
+    WorkStealingQueue queue(&adapter, 4);
+    Job jobs[5];
+
+    BOOST_CHECK(queue.pop() == nullptr);
+    BOOST_CHECK(queue.steal() == nullptr);
+
+    for(u32 i = 0; i < 4; ++i)
+    {
+        BOOST_CHECK(queue.push(&jobs[i]));
+    }
+    BOOST_CHECK(!queue.push(&jobs[4]));
+    BOOST_CHECK(queue.size() == 4);
+
+    // The owner takes the newest job and thieves the oldest.
+    BOOST_CHECK(queue.pop() == &jobs[3]);
+    BOOST_CHECK(queue.steal() == &jobs[0]);
+    BOOST_CHECK(queue.steal() == &jobs[1]);
+    BOOST_CHECK(queue.pop() == &jobs[2]);
+    BOOST_CHECK(queue.pop() == nullptr);
+    BOOST_CHECK(queue.size() == 0);
+
+    // Wraps around.
+    BOOST_CHECK(queue.push(&jobs[4]));
+    BOOST_CHECK(queue.steal() == &jobs[4]);
+}
+
+BOOST_AUTO_TEST_CASE(steal_from_threads)
+{
+    const u32 numJobs = 1 << 14;
+    WorkStealingQueue queue(&adapter, numJobs);
+    std::vector<Job> jobs(numJobs);
+    std::vector<std::atomic<u32>> taken(numJobs);
+    for(std::atomic<u32>& count : taken)
+    {
+        count = 0;
+    }
+
+    auto take = [&](Job* pJob){ taken[pJob - jobs.data()].fetch_add(1); };
+
+    for(u32 i = 0; i < numJobs; ++i)
+    {
+        queue.push(&jobs[i]);
+    }
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for(u32 t = 0; t < 3; ++t)
+    {
+        thieves.push_back(std::thread([&]()
+        {
+            while(!done.load())
+            {
+                if(Job* pJob = queue.steal())
+                {
+                    take(pJob);
+                }
+            }
+        }));
+    }
+
+    while(Job* pJob = queue.pop())
+    {
+        take(pJob);
+    }
+    while(queue.size() > 0)
+    {
+        std::this_thread::yield();
+    }
+    done = true;
+    for(std::thread& thief : thieves)
+    {
+        thief.join();
+    }
+
+    bool exactlyOnce = true;
+    for(std::atomic<u32>& count : taken)
+    {
+        exactlyOnce = exactlyOnce && count.load() == 1;
+    }
+    BOOST_CHECK(exactlyOnce);
+}
+
+BOOST_AUTO_TEST_CASE(run_and_wait)
+{
+    JobSystem jobs(&adapter, 4, 256);
+    BOOST_CHECK(jobs.getNumThreads() == 4);
+    BOOST_CHECK(jobs.getThreadIndex() == 0);
+
+    std::atomic<u32> sum(0);
+    JobCounter counter;
+    for(u32 i = 1; i <= 100; ++i)
+    {
+        std::atomic<u32>* pSum = &sum;
+        jobs.run([pSum, i](Job&){ pSum->fetch_add(i); }, &counter);
+    }
+
+    struct
+    {
+        std::atomic<u32>* pSum;
+        u32 value;
+    } data = {&sum, 1000};
+    jobs.run(&addJobData, &data, sizeof(data), &counter);
+
+    jobs.wait(&counter);
+    BOOST_CHECK(counter.isDone());
+    BOOST_CHECK(sum == 5050 + 1000);
+}
+
+BOOST_AUTO_TEST_CASE(wait_inside_job)
+{
+    JobSystem jobs(&adapter, 3, 256);
+    std::atomic<u32> sum(0);
+    JobCounter counter;
+
+    // Each parent depends on children it queues from its own thread.
+    for(u32 i = 0; i < 8; ++i)
+    {
+        JobSystem* pJobs = &jobs;
+        std::atomic<u32>* pSum = &sum;
+        jobs.run([pJobs, pSum](Job&)
+        {
+            JobCounter children;
+            for(u32 j = 0; j < 8; ++j)
+            {
+                pJobs->run([pSum](Job&){ pSum->fetch_add(1); }, &children);
+            }
+            pJobs->wait(&children);
+            BOOST_CHECK(pSum->load() > 0);
+        }, &counter);
+    }
+
+    jobs.wait(&counter);
+    BOOST_CHECK(sum == 64);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_covers_range)
+{
+    JobSystem jobs(&adapter, 4, 256);
+    std::vector<u32> values(10000, 0);
+
+    jobs.parallelFor(0, (u32)values.size(), 64, [&values](u32 begin, u32 end)
+    {
+        for(u32 i = begin; i < end; ++i)
+        {
+            values[i] += i;
+        }
+    });
+
+    bool correct = true;
+    for(u32 i = 0; i < values.size(); ++i)
+    {
+        correct = correct && values[i] == i;
+    }
+    BOOST_CHECK(correct);
+}
+
+BOOST_AUTO_TEST_CASE(full_queue_runs_inline)
+{
+    JobSystem jobs(&adapter, 1, 4);
+    u32 sum = 0;
+    JobCounter counter;
+    for(u32 i = 0; i < 4; ++i)
+    {
+        u32* pSum = &sum;
+        jobs.run([pSum](Job&){ ++*pSum; }, &counter);
+    }
+    BOOST_CHECK(sum == 0);
+
+    // The queue holds 4 jobs so this one runs immediately.
+    u32* pSum = &sum;
+    jobs.run([pSum](Job&){ *pSum += 10; }, &counter);
+    BOOST_CHECK(sum == 10);
+
+    jobs.wait(&counter);
+    BOOST_CHECK(sum == 14);
+}
+
+BOOST_AUTO_TEST_CASE(queued_job_slot_is_not_reused)
+{
+    JobSystem jobs(&adapter, 1, 4);
+    u32 numA = 0;
+    u32 numE = 0;
+    JobCounter counterA;
+    JobCounter counterB;
+    JobCounter counterE;
+
+    u32* pNumA = &numA;
+    u32* pNumE = &numE;
+    jobs.run([pNumA](Job&){ ++*pNumA; }, &counterA);
+    jobs.run([](Job&){}, &counterB);
+    jobs.run([](Job&){}, &counterB);
+
+    // Newest first, so A is still queued in the first slot of the ring.
+    jobs.wait(&counterB);
+    BOOST_CHECK(numA == 0);
+
+    // The second job wraps around the ring and must not overwrite A.
+    jobs.run([pNumE](Job&){ ++*pNumE; }, &counterE);
+    jobs.run([pNumE](Job&){ ++*pNumE; }, &counterE);
+    jobs.wait(&counterE);
+    jobs.wait(&counterA);
+
+    BOOST_CHECK(numA == 1);
+    BOOST_CHECK(numE == 2);
+}
+
+BOOST_AUTO_TEST_CASE(wait_suspends_fiber)
+{
+    JobSystem jobs(&adapter, 3, 256, 8, 32 * 1024);
+    std::atomic<bool> open(false);
+    std::atomic<u32> sum(0);
+    JobCounter gate;
+    JobCounter counter;
+
+    // Thieves take the oldest job first, so one worker is held by the gate job while the
+    // other picks up the jobs that wait on it.
+    std::atomic<bool>* pOpen = &open;
+    jobs.run([pOpen](Job&)
+    {
+        while(!pOpen->load())
+        {
+            std::this_thread::yield();
+        }
+    }, &gate);
+
+    for(u32 i = 0; i < 4; ++i)
+    {
+        JobSystem* pJobs = &jobs;
+        JobCounter* pGate = &gate;
+        std::atomic<u32>* pSum = &sum;
+        jobs.run([pJobs, pGate, pSum](Job&)
+        {
+            pJobs->wait(pGate);
+            pSum->fetch_add(1);
+        }, &counter);
+    }
+
+    // Without fibers the second worker would run the waiting jobs nested inside each
+    // other and none of them would be suspended.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while(jobs.getNumWaitingFibers() < 4 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    BOOST_CHECK(jobs.getNumWaitingFibers() == 4);
+    BOOST_CHECK(sum == 0);
+
+    open = true;
+    jobs.wait(&counter);
+    BOOST_CHECK(sum == 4);
+    BOOST_CHECK(jobs.getNumWaitingFibers() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(wait_inside_job_on_fibers)
+{
+    JobSystem jobs(&adapter, 3, 256, 16, 32 * 1024);
+    std::atomic<u32> sum(0);
+    JobCounter counter;
+
+    for(u32 i = 0; i < 8; ++i)
+    {
+        JobSystem* pJobs = &jobs;
+        std::atomic<u32>* pSum = &sum;
+        jobs.run([pJobs, pSum](Job&)
+        {
+            JobCounter children;
+            for(u32 j = 0; j < 8; ++j)
+            {
+                pJobs->run([pSum](Job&){ pSum->fetch_add(1); }, &children);
+            }
+            pJobs->wait(&children);
+            pSum->fetch_add(100);
+        }, &counter);
+    }
+
+    jobs.wait(&counter);
+    BOOST_CHECK(sum == 8 * 8 + 8 * 100);
+}
+
+BOOST_AUTO_TEST_CASE(assert_run_from_foreign_thread)
+{
+    JobSystem jobs(&adapter, 2, 16);
+    std::thread thread([&jobs]()
+    {
+        auto lambda = [&jobs](){ jobs.getThreadIndex(); };
+        FS_REQUIRE_ASSERT(lambda);
+    });
+    thread.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+
+using PressureArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                                  SingleThread,
+                                  NoBoundsChecking,
+                                  SimpleMemoryTracking,
+                                  NoMemoryTagging,
+                                  SimpleMemoryBudget>;
+
+struct PressureFixture
+{
+    PressureFixture() :
+        eventArea(64 * 1024),
+        eventArena(eventArea, "PressureEventArena"),
+        cacheArea(64 * 1024),
+        cacheArena(cacheArea, "CacheArena")
+    {
+    }
+
+    // Order below matters for allocation deallocation order
+    HeapArea eventArea;
+    PressureArena eventArena;
+    HeapArea cacheArea;
+    PressureArena cacheArena;
+};
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_FIXTURE_TEST_SUITE(memory_pressure, PressureFixture)
+
+BOOST_AUTO_TEST_CASE(signal_listeners_on_soft_limit)
+{
+    SourceInfo info(__FILE__, __LINE__);
+    cacheArena.getBudget().setLimits(256, 0);
+
+    const MemoryBudget* pSignalled = nullptr;
+    u32 numSignals = 0;
+
+    {
+        MemoryPressureEvent<PressureArena> pressure(&eventArena, cacheArena.getBudget());
+        pressure.add([&](const MemoryBudget& budget)
+        {
+            pSignalled = &budget;
+            ++numSignals;
+        });
+
+        void* a = cacheArena.allocate(200, 16, info);
+        BOOST_CHECK(numSignals == 0);
+
+        void* b = cacheArena.allocate(200, 16, info);
+        BOOST_CHECK(numSignals == 1);
+        BOOST_CHECK(pSignalled == &cacheArena.getBudget());
+
+        cacheArena.free(b);
+        cacheArena.free(a);
+    }
+
+    // The event no longer listens once destroyed.
+    void* a = cacheArena.allocate(200, 16, info);
+    void* b = cacheArena.allocate(200, 16, info);
+    BOOST_CHECK(numSignals == 1);
+
+    cacheArena.free(b);
+    cacheArena.free(a);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "fstest.h"
+#include "fscore.h"
+#include "fsmem.h"
+#include "fsutil.h"
+
+using namespace fs;
+
+using TimerArena = MemoryArena<Allocator<HeapAllocator, AllocationHeaderU32>,
+                               SingleThread,
+                               SimpleBoundsChecking,
+                               SimpleMemoryTracking,
+                               NoMemoryTagging>;
+
+using Timers = TimerWheel<TimerArena>;
+
+struct TimerWheelFixture
+{
+    TimerWheelFixture() :
+        area(FS_SIZE_OF_MB * 4),
+        arena(area, "TimerArena")
+    {
+    }
+
+    // Order below matters for allocation deallocation order
+    HeapArea area;
+    TimerArena arena;
+};
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_FIXTURE_TEST_SUITE(timer_wheel, TimerWheelFixture)
+
+BOOST_AUTO_TEST_CASE(fire_when_due)
+{
+    Timers timers(&arena, 0.01f);
+    u32 fired = 0;
+    u32* pFired = &fired;
+    timers.schedule(0.05f, [pFired](){ ++*pFired; });
+    BOOST_CHECK(timers.getNumTimers() == 1);
+
+    BOOST_CHECK(timers.advance(0.04f) == 0);
+    BOOST_CHECK(fired == 0);
+
+    // Partial ticks carry over to the next advance.
+    BOOST_CHECK(timers.advance(0.006f) == 0);
+    BOOST_CHECK(timers.advance(0.006f) == 1);
+    BOOST_CHECK(fired == 1);
+    BOOST_CHECK(timers.getNumTimers() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(fire_on_frame_that_reaches_delay)
+{
+    // Neither the frame time nor the tick is exact in f32.
+    Timers timers(&arena);
+    u32 fired = 0;
+    u32* pFired = &fired;
+    timers.schedule(1.0f, [pFired](){ ++*pFired; });
+
+    for(u32 frame = 0; frame < 9; ++frame)
+    {
+        timers.advance(0.1f);
+    }
+    BOOST_CHECK(fired == 0);
+
+    timers.advance(0.1f);
+    BOOST_CHECK(fired == 1);
+}
+
+BOOST_AUTO_TEST_CASE(fire_in_due_order)
+{
+    Timers timers(&arena, 0.001f);
+    std::vector<u32> order;
+    std::vector<u32>* pOrder = &order;
+
+    // Spread over several levels of the wheel and scheduled out of order.
+    const f32 delays[] = {5.0f, 0.002f, 70.0f, 0.1f, 0.002f, 300.0f};
+    for(u32 i = 0; i < 6; ++i)
+    {
+        timers.schedule(delays[i], [pOrder, i](){ pOrder->push_back(i); });
+    }
+
+    for(u32 frame = 0; frame < 301 * 60; ++frame)
+    {
+        timers.advance(1.0f / 60.0f);
+    }
+
+    const u32 expected[] = {1, 4, 3, 0, 2, 5};
+    BOOST_REQUIRE(order.size() == 6);
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected, expected + 6);
+}
+
+BOOST_AUTO_TEST_CASE(fire_on_exact_tick)
+{
+    Timers timers(&arena, 1.0f);
+    std::vector<u64> firedAt;
+    std::vector<u64>* pFiredAt = &firedAt;
+    Timers* pTimers = &timers;
+
+    // Due exactly when the upper levels wrap around.
+    const u64 delays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262144, 262145};
+    for(u64 delay : delays)
+    {
+        timers.schedule((f32)delay, [pFiredAt, pTimers](){ pFiredAt->push_back(pTimers->getCurrentTick()); });
+    }
+
+    for(u32 step = 0; step < 300000; ++step)
+    {
+        timers.advance(1.0f);
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(firedAt.begin(), firedAt.end(), delays, delays + 9);
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+    Timers timers(&arena, 0.01f);
+    u32 fired = 0;
+    u32* pFired = &fired;
+    TimerHandle first = timers.schedule(0.1f, [pFired](){ *pFired += 1; });
+    TimerHandle second = timers.schedule(0.1f, [pFired](){ *pFired += 10; });
+
+    BOOST_CHECK(timers.isScheduled(first));
+    BOOST_CHECK(timers.cancel(first));
+    BOOST_CHECK(!timers.isScheduled(first));
+    BOOST_CHECK(!timers.cancel(first));
+    BOOST_CHECK(!timers.cancel(TimerHandle()));
+
+    // The cancelled timer's storage is reused without reviving its handle.
+    TimerHandle third = timers.schedule(0.1f, [pFired](){ *pFired += 100; });
+    BOOST_CHECK(third.index == first.index);
+    BOOST_CHECK(!timers.isScheduled(first));
+
+    timers.advance(0.2f);
+    BOOST_CHECK(fired == 110);
+    BOOST_CHECK(!timers.isScheduled(second));
+    BOOST_CHECK(!timers.cancel(third));
+}
+
+struct Rescheduler
+{
+    Timers* pTimers;
+    u32 count;
+    TimerHandle victim;
+
+    void onTimer()
+    {
+        ++count;
+        pTimers->cancel(victim);
+        if(count < 3)
+        {
+            // Zero delay still waits for the next tick.
+            pTimers->schedule(0.0f, Timers::Callback::from(Timers::Callback::NonConstWrapper<Rescheduler, &Rescheduler::onTimer>(this)));
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(schedule_and_cancel_from_callback)
+{
+    Timers timers(&arena, 0.01f);
+    u32 victimFired = 0;
+    u32* pVictimFired = &victimFired;
+    Rescheduler rescheduler = {&timers, 0, TimerHandle()};
+
+    timers.schedule(0.01f, Timers::Callback::from(Timers::Callback::NonConstWrapper<Rescheduler, &Rescheduler::onTimer>(&rescheduler)));
+    rescheduler.victim = timers.schedule(0.01f, [pVictimFired](){ ++*pVictimFired; });
+
+    BOOST_CHECK(timers.advance(0.01f) == 1);
+    BOOST_CHECK(rescheduler.count == 1);
+    BOOST_CHECK(victimFired == 0);
+
+    timers.advance(0.1f);
+    BOOST_CHECK(rescheduler.count == 3);
+    BOOST_CHECK(timers.getNumTimers() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(many_timers)
+{
+    Timers timers(&arena);
+    u32 fired = 0;
+    u32* pFired = &fired;
+    for(u32 i = 0; i < 20000; ++i)
+    {
+        timers.schedule((f32)(i % 1000) * 0.01f, [pFired](){ ++*pFired; });
+    }
+
+    u32 numFired = 0;
+    for(u32 frame = 0; frame < 11 * 60; ++frame)
+    {
+        numFired += timers.advance(1.0f / 60.0f);
+    }
+    BOOST_CHECK(fired == 20000);
+    BOOST_CHECK(numFired == 20000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()